@@ -0,0 +1,258 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "window_styles.hpp"
+#include "text_search.hpp"
+
+namespace Inspector
+{
+    // One bitset per style bit, extended style bit and state flag (kWindowStateFlags) over the windows of a
+    // snapshot, numbered flat process by process like WindowGrouping::windowBase. The columns are filled
+    // in one pass when the snapshot changes; a StyleFilter is then evaluated a column at a time (AND for
+    // required flags, OR across '/' alternatives, AND NOT for forbidden flags) with popcount for the
+    // count. Toggling a filter therefore costs a few word operations per 64 windows for each flag it
+    // names and never reads a WindowInfo.
+    class AttributeIndex
+    {
+    public:
+        static constexpr uint32_t kStateColumn = 64;
+        static constexpr uint32_t kColumnCount = kStateColumn + static_cast<uint32_t>(std::size(kWindowStateFlags));
+
+        struct Stats
+        {
+            size_t windows = 0;
+            size_t matches = 0;
+            double buildMilliseconds = 0.0;
+            double evaluateMicroseconds = 0.0;
+        };
+
+        void Sync(const InspectorSnapshot& snapshot)
+        {
+            if (snapshot.generation == mGeneration && mGeneration != 0)
+            {
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            mGeneration = snapshot.generation;
+            mWindowBase.clear();
+            mWindowBase.reserve(snapshot.processes.size() + 1);
+            uint32_t windows = 0;
+            for (const auto& entry : snapshot.processes)
+            {
+                mWindowBase.push_back(windows);
+                windows += static_cast<uint32_t>(entry.windows.size());
+            }
+            mWindowBase.push_back(windows);
+            mWindowCount = windows;
+            mWords = (static_cast<size_t>(windows) + 63) / 64;
+            mColumns.resize(mWords * kColumnCount);
+
+            // Runs of 64 windows are gathered as one style word per window and stored as one word per column
+            // by transposing that 64x64 bit block, so no bit is set on its own.
+            uint64_t block[kColumnCount] = {};
+            uint32_t flat = 0;
+            for (const auto& entry : snapshot.processes)
+            {
+                for (const WindowInfo& window : entry.windows)
+                {
+                    block[flat % 64] = static_cast<uint64_t>(static_cast<uint32_t>(window.style)) |
+                                       (static_cast<uint64_t>(static_cast<uint32_t>(window.exStyle)) << 32);
+                    const uint32_t state = WindowStateBits(window.visible, window.bounds, window.rootOwner);
+                    for (uint32_t column = 0; column < kColumnCount - kStateColumn; ++column)
+                    {
+                        block[kStateColumn + column] |= static_cast<uint64_t>(state >> column & 1) << (flat % 64);
+                    }
+                    if (++flat % 64 == 0)
+                    {
+                        StoreBlock(block, flat / 64 - 1);
+                    }
+                }
+            }
+            if (flat % 64 != 0)
+            {
+                std::fill(block + flat % 64, block + 64, uint64_t{0});
+                StoreBlock(block, flat / 64);
+            }
+            mFilterGeneration = 0;
+            mStats.windows = windows;
+            mStats.buildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Windows matching `filter` as a bitset over flat window numbers, cached until the snapshot or the
+        // filter changes.
+        const std::vector<uint64_t>& Evaluate(const StyleFilter& filter)
+        {
+            if (mFilterGeneration == mGeneration && mFilter == filter)
+            {
+                return mResult;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            mFilter = filter;
+            mFilterGeneration = mGeneration;
+
+            const size_t words = mWords;
+            mResult.assign(words, ~uint64_t{0});
+            uint64_t* result = mResult.data();
+            ForEachColumn(filter.Required(), [result, words](const uint64_t* column) {
+                for (size_t word = 0; word < words; ++word)
+                {
+                    result[word] &= column[word];
+                }
+            });
+            ForEachColumn(filter.Forbidden(), [result, words](const uint64_t* column) {
+                for (size_t word = 0; word < words; ++word)
+                {
+                    result[word] &= ~column[word];
+                }
+            });
+            for (const auto& alternatives : filter.AnyOf())
+            {
+                mAny.assign(words, 0);
+                uint64_t* any = mAny.data();
+                for (const StyleMasks& masks : alternatives)
+                {
+                    mAll.assign(words, ~uint64_t{0});
+                    uint64_t* all = mAll.data();
+                    ForEachColumn(masks, [all, words](const uint64_t* column) {
+                        for (size_t word = 0; word < words; ++word)
+                        {
+                            all[word] &= column[word];
+                        }
+                    });
+                    for (size_t word = 0; word < words; ++word)
+                    {
+                        any[word] |= all[word];
+                    }
+                }
+                for (size_t word = 0; word < words; ++word)
+                {
+                    result[word] &= any[word];
+                }
+            }
+            if (mWords != 0 && mWindowCount % 64 != 0)
+            {
+                mResult.back() &= (uint64_t{1} << (mWindowCount % 64)) - 1;
+            }
+
+            size_t matches = 0;
+            for (const uint64_t word : mResult)
+            {
+                matches += static_cast<size_t>(TextSearch::PopCount64(word));
+            }
+            mStats.matches = matches;
+            mStats.evaluateMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            return mResult;
+        }
+
+        // Windows with the given column's bit (style bits 0-31, extended style bits 32-63, then the state flags).
+        size_t CountOf(uint32_t column) const
+        {
+            size_t count = 0;
+            for (size_t word = 0; word < mWords; ++word)
+            {
+                count += static_cast<size_t>(TextSearch::PopCount64(mColumns[column * mWords + word]));
+            }
+            return count;
+        }
+
+        // Flat number of the first window of `process`; windowBase[processes.size()] is the window count.
+        const std::vector<uint32_t>& WindowBase() const
+        {
+            return mWindowBase;
+        }
+
+        uint32_t FlatIndexOf(const WindowRef& ref) const
+        {
+            return mWindowBase[ref.process] + ref.window;
+        }
+
+        bool Synced(const InspectorSnapshot& snapshot) const
+        {
+            return mGeneration == snapshot.generation && mGeneration != 0;
+        }
+
+        const Stats& CurrentStats() const
+        {
+            return mStats;
+        }
+
+        static bool Test(const std::vector<uint64_t>& bits, uint32_t flat)
+        {
+            return (bits[flat / 64] >> (flat % 64) & 1) != 0;
+        }
+
+        // Calls visit(flat) for every set bit, in ascending order.
+        template <typename Visit>
+        static void ForEachSet(const std::vector<uint64_t>& bits, Visit&& visit)
+        {
+            for (size_t word = 0; word < bits.size(); ++word)
+            {
+                for (uint64_t rest = bits[word]; rest != 0; rest &= rest - 1)
+                {
+                    visit(static_cast<uint32_t>(word * 64 + static_cast<size_t>(TextSearch::CountTrailingZeros64(rest))));
+                }
+            }
+        }
+
+    private:
+        // In-place transpose of a 64x64 bit matrix: bit j of rows[i] trades places with bit i of rows[j].
+        static void Transpose64(uint64_t* rows)
+        {
+            uint64_t mask = 0x00000000FFFFFFFFull;
+            for (unsigned width = 32; width != 0; width >>= 1, mask ^= mask << width)
+            {
+                for (unsigned row = 0; row < 64; row = (row + width + 1) & ~width)
+                {
+                    const uint64_t swap = ((rows[row] >> width) ^ rows[row + width]) & mask;
+                    rows[row] ^= swap << width;
+                    rows[row + width] ^= swap;
+                }
+            }
+        }
+
+        // Stores column word `word` from a block holding one style word per window followed by the state
+        // columns, and clears the block.
+        void StoreBlock(uint64_t (&block)[kColumnCount], size_t word)
+        {
+            Transpose64(block);
+            for (uint32_t column = 0; column < kColumnCount; ++column)
+            {
+                mColumns[column * mWords + word] = block[column];
+                block[column] = 0;
+            }
+        }
+
+        template <typename Visit>
+        void ForEachColumn(const StyleMasks& masks, Visit&& visit) const
+        {
+            const uint32_t parts[3] = {masks.style, masks.exStyle, masks.state};
+            const uint32_t firstColumns[3] = {0, 32, kStateColumn};
+            for (size_t part = 0; part < 3; ++part)
+            {
+                for (uint32_t bits = parts[part]; bits != 0; bits &= bits - 1)
+                {
+                    visit(mColumns.data() + (firstColumns[part] + static_cast<uint32_t>(TextSearch::CountTrailingZeros64(bits))) * mWords);
+                }
+            }
+        }
+
+        uint64_t mGeneration = 0;
+        uint32_t mWindowCount = 0;
+        size_t mWords = 0;
+        std::vector<uint32_t> mWindowBase;
+        // kColumnCount columns of mWords words each.
+        std::vector<uint64_t> mColumns;
+
+        StyleFilter mFilter;
+        uint64_t mFilterGeneration = 0;
+        std::vector<uint64_t> mResult;
+        std::vector<uint64_t> mAny;
+        std::vector<uint64_t> mAll;
+        Stats mStats;
+    };
+}
@@ -0,0 +1,2224 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "occlusion.hpp"
+#include "render_pacing.hpp"
+#include "soft_renderer.hpp"
+#include "ui.hpp"
+
+using Inspector::InspectorSnapshot;
+using Inspector::ProcessWindows;
+using Inspector::WindowInfo;
+
+#if defined(INSPECTOR_BENCH_MAIN)
+// Standalone builds also count operator new; inside the app binary only imgui's allocator is hooked.
+namespace
+{
+    std::atomic<uint64_t> gOperatorNewCount{0};
+}
+
+// Replacing operator new/delete with malloc/free is the point here; GCC 11+ would otherwise warn about
+// every inlined delete that frees with std::free.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(size_t size)
+{
+    gOperatorNewCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size != 0 ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t OperatorNewCount()
+    {
+#if defined(INSPECTOR_BENCH_MAIN)
+        return gOperatorNewCount.load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    // Self-checks that failed during this run; a nonzero count makes RunHeadlessBenchmark fail.
+    size_t gMismatchCount = 0;
+
+    // Suffix for a table row whose self-check compared `mismatch`, counting the failures.
+    const char* MismatchLabel(bool mismatch)
+    {
+        gMismatchCount += mismatch ? 1 : 0;
+        return mismatch ? "  MISMATCH" : "";
+    }
+
+    double ElapsedMs(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    struct ProcessTemplate
+    {
+        const wchar_t* name;
+        const wchar_t* className;
+        const wchar_t* titles[4];
+    };
+
+    // Roughly what a developer desktop looks like: a few heavy multi-window apps plus a long tail
+    // of helper windows (IME, tooltips, GDI+ hooks) with empty or generic titles.
+    const ProcessTemplate kProcessTemplates[] = {
+        {L"chrome.exe", L"Chrome_WidgetWin_1", {L"(3) Inbox - Gmail - Google Chrome", L"window-inspector/ui.hpp at main - Google Chrome", L"Pull requests \u00b7 suspex0/window-inspector", L""}},
+        {L"Code.exe", L"Chrome_WidgetWin_1", {L"main.cpp - window-inspector - Visual Studio Code", L"ui.hpp - window-inspector - Visual Studio Code", L"Settings - Visual Studio Code", L""}},
+        {L"explorer.exe", L"CabinetWClass", {L"Downloads", L"C:\\Users\\dev\\source\\repos", L"\u041f\u0440\u043e\u0432\u043e\u0434\u043d\u0438\u043a", L"Program Manager"}},
+        {L"devenv.exe", L"HwndWrapper[DefaultDomain;;]", {L"WindowInspector - Microsoft Visual Studio", L"Output", L"Solution Explorer", L""}},
+        {L"OUTLOOK.EXE", L"rctrl_renwnd32", {L"Inbox - dev@example.com - Outlook", L"Calendar - Outlook", L"Re: Stand-up notes - Message (HTML)", L""}},
+        {L"Teams.exe", L"TeamsWebView", {L"Chat | Microsoft Teams", L"Meeting with Jos\u00e9 | Microsoft Teams", L"Calendar | Microsoft Teams", L""}},
+        {L"WindowsTerminal.exe", L"CASCADIA_HOSTING_WINDOW_CLASS", {L"PowerShell", L"Administrator: Command Prompt", L"dev@build-01: ~/src", L""}},
+        {L"notepad++.exe", L"Notepad++", {L"*new 1 - Notepad++", L"C:\\temp\\log.txt - Notepad++", L"\u00c9tat du syst\u00e8me.txt - Notepad++", L""}},
+        {L"svchost.exe", L"CicMarshalWndClass", {L"", L"", L"", L""}},
+        {L"RuntimeBroker.exe", L"Windows.UI.Core.CoreWindow", {L"", L"", L"", L""}},
+    };
+
+    const wchar_t* const kHelperClasses[] = {L"IME", L"MSCTFIME UI", L"tooltips_class32", L"GDI+ Hook Window Class", L"CicMarshalWndClass"};
+    const wchar_t* const kHelperTitles[] = {L"Default IME", L"MSCTFIME UI", L"", L"GDI+ Window", L""};
+
+    InspectorSnapshot MakeSyntheticSnapshot(size_t windowCount, uint32_t seed)
+    {
+        static uint64_t nextGeneration = 1000000;
+        std::mt19937 rng(seed);
+        InspectorSnapshot snapshot;
+        snapshot.generation = ++nextGeneration;
+        snapshot.timestamp.wYear = 2026;
+        snapshot.timestamp.wMonth = 1;
+        snapshot.timestamp.wDay = 1;
+
+        const size_t templateCount = sizeof(kProcessTemplates) / sizeof(kProcessTemplates[0]);
+        const size_t processCount = std::max<size_t>(1, windowCount / 40);
+        snapshot.processes.resize(processCount);
+        for (size_t p = 0; p < processCount; ++p)
+        {
+            const ProcessTemplate& source = kProcessTemplates[p % templateCount];
+            snapshot.processes[p].process.pid = static_cast<DWORD>(4 + p * 4);
+            snapshot.processes[p].process.name = source.name;
+        }
+
+        // Skewed distribution: low pids (the big apps) own most windows.
+        std::geometric_distribution<size_t> owner(4.0 / static_cast<double>(processCount));
+        for (size_t i = 0; i < windowCount; ++i)
+        {
+            const size_t p = std::min(owner(rng), processCount - 1);
+            ProcessWindows& entry = snapshot.processes[p];
+            const ProcessTemplate& source = kProcessTemplates[p % templateCount];
+
+            WindowInfo window;
+            window.handle = reinterpret_cast<HWND>(static_cast<uintptr_t>(0x10000 + i * 2));
+            window.pid = entry.process.pid;
+            window.zOrder = static_cast<uint32_t>(i);
+            window.threadId = static_cast<DWORD>(entry.process.pid + 1 + (rng() % 4));
+            if (rng() % 3 == 0)
+            {
+                const size_t helper = rng() % (sizeof(kHelperClasses) / sizeof(kHelperClasses[0]));
+                window.className = kHelperClasses[helper];
+                window.title = kHelperTitles[helper];
+            }
+            else
+            {
+                window.className = source.className;
+                window.title = source.titles[rng() % 4];
+                if (!window.title.empty() && rng() % 2 == 0)
+                {
+                    window.title += L" (" + std::to_wstring(rng() % 100) + L")";
+                }
+            }
+            if (window.title.empty())
+            {
+                window.title = L"<No Title>";
+            }
+
+            const bool helper = window.className == kHelperClasses[0] || window.className == kHelperClasses[1] || window.className == kHelperClasses[4];
+            window.visible = !helper && rng() % 4 == 0;
+            window.style = static_cast<LONG_PTR>(window.visible ? 0x16CF0000 : 0x86000000);
+            window.exStyle = static_cast<LONG_PTR>(rng() % 2 == 0 ? 0x00000100 : 0x08000088);
+            // Helper windows are zero-sized, hidden ones tooltip-sized, visible ones anything up to 1600x1000.
+            const LONG left = static_cast<LONG>(rng() % 3840) - 200;
+            const LONG top = static_cast<LONG>(rng() % 2160) - 100;
+            const LONG maxWidth = window.visible ? 1600 : 300;
+            const LONG maxHeight = window.visible ? 1000 : 200;
+            window.bounds = helper ? RECT{0, 0, 0, 0}
+                                   : RECT{left, top, left + 40 + static_cast<LONG>(rng() % maxWidth), top + 20 + static_cast<LONG>(rng() % maxHeight)};
+            // Every seventh window is owned by an earlier window of its process.
+            if (i % 7 == 3 && !entry.windows.empty())
+            {
+                window.rootOwner = entry.windows[i % entry.windows.size()].handle;
+            }
+            entry.windows.push_back(std::move(window));
+        }
+
+        snapshot.monitors = {RECT{0, 0, 3840, 2160}, RECT{-1920, 540, 0, 1620}};
+        snapshot.totalProcessCount = processCount;
+        snapshot.totalWindowCount = windowCount;
+        Inspector::PrepareSnapshotStrings(snapshot);
+        return snapshot;
+    }
+
+    struct FrameRecord
+    {
+        double newFrameMs = 0.0;
+        double uiMs = 0.0;
+        double renderMs = 0.0;
+        double rasterMs = 0.0;
+        int vertices = 0;
+        int indices = 0;
+        uint64_t imguiAllocations = 0;
+        uint64_t operatorNews = 0;
+    };
+
+    double Percentile(std::vector<double> values, double fraction)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        const size_t rank = std::min(values.size() - 1, static_cast<size_t>(fraction * static_cast<double>(values.size())));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+        return values[rank];
+    }
+
+    void ReportPhase(const char* phase, size_t windowCount, const std::vector<FrameRecord>& frames)
+    {
+        if (frames.empty())
+        {
+            return;
+        }
+
+        std::vector<double> totals;
+        totals.reserve(frames.size());
+        double ui = 0.0;
+        double raster = 0.0;
+        double vertices = 0.0;
+        double indices = 0.0;
+        double imguiAllocations = 0.0;
+        double operatorNews = 0.0;
+        for (const FrameRecord& frame : frames)
+        {
+            totals.push_back(frame.newFrameMs + frame.uiMs + frame.renderMs);
+            ui += frame.uiMs;
+            raster += frame.rasterMs;
+            vertices += frame.vertices;
+            indices += frame.indices;
+            imguiAllocations += static_cast<double>(frame.imguiAllocations);
+            operatorNews += static_cast<double>(frame.operatorNews);
+        }
+
+        const double count = static_cast<double>(frames.size());
+        std::printf("%8zu  %-7s %6zu  %8.3f %8.3f %8.3f %8.3f %9.3f  %9.0f %9.0f  %8.1f %8.1f\n",
+                    windowCount, phase, frames.size(),
+                    Percentile(totals, 0.5), Percentile(totals, 0.99), *std::max_element(totals.begin(), totals.end()), ui / count, raster / count,
+                    vertices / count, indices / count, imguiAllocations / count, operatorNews / count);
+    }
+
+    // Types `text` into `buffer` one character every `framesPerChar` frames.
+    void ScriptTyping(std::array<char, 128>& buffer, const char* text, int frame, int framesPerChar)
+    {
+        const size_t typed = std::min(std::strlen(text), static_cast<size_t>(frame / framesPerChar + 1));
+        buffer.fill('\0');
+        std::memcpy(buffer.data(), text, typed);
+    }
+
+    // Optional software rasterization of every benchmark frame; `renderer` is null when --raster is off.
+    struct RasterTarget
+    {
+        Inspector::SoftRenderer* renderer = nullptr;
+        Inspector::SoftFramebuffer framebuffer;
+    };
+
+    double RasterizeFrame(RasterTarget& raster)
+    {
+        ImDrawData* drawData = ImGui::GetDrawData();
+        Inspector::SoftRenderer::UpdateTextures(drawData);
+        if (raster.renderer == nullptr)
+        {
+            return 0.0;
+        }
+
+        const auto start = Clock::now();
+        raster.framebuffer.Resize(static_cast<int>(drawData->DisplaySize.x * drawData->FramebufferScale.x),
+                                  static_cast<int>(drawData->DisplaySize.y * drawData->FramebufferScale.y));
+        raster.framebuffer.Clear(IM_COL32(115, 140, 153, 255));
+        raster.renderer->Render(drawData, raster.framebuffer);
+        return ElapsedMs(start, Clock::now());
+    }
+
+    // One inspector frame over `snapshot` with whatever input the caller queued on ImGuiIO: NewFrame, the
+    // UI, Render and the optional rasterization, each timed, plus the allocations the frame made.
+    FrameRecord RecordFrame(const InspectorSnapshot& snapshot, RasterTarget& raster)
+    {
+        FrameRecord record;
+        const uint64_t imguiBefore = Inspector::gImGuiAllocationCount.load(std::memory_order_relaxed);
+        const uint64_t newsBefore = OperatorNewCount();
+        const auto start = Clock::now();
+        ImGui::NewFrame();
+        const auto afterNewFrame = Clock::now();
+        Inspector::RenderInspectorUi(ImGui::GetIO().DeltaTime, snapshot);
+        const auto afterUi = Clock::now();
+        ImGui::Render();
+        const auto afterRender = Clock::now();
+        record.newFrameMs = ElapsedMs(start, afterNewFrame);
+        record.uiMs = ElapsedMs(afterNewFrame, afterUi);
+        record.renderMs = ElapsedMs(afterUi, afterRender);
+        record.rasterMs = RasterizeFrame(raster);
+        record.vertices = ImGui::GetDrawData()->TotalVtxCount;
+        record.indices = ImGui::GetDrawData()->TotalIdxCount;
+        record.imguiAllocations = Inspector::gImGuiAllocationCount.load(std::memory_order_relaxed) - imguiBefore;
+        record.operatorNews = OperatorNewCount() - newsBefore;
+        return record;
+    }
+
+    void RunUiBenchmark(size_t windowCount, int frames, RasterTarget& raster)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, static_cast<uint32_t>(windowCount));
+        ImGuiIO& io = ImGui::GetIO();
+        Inspector::gUiState.processFilter.fill('\0');
+        Inspector::gUiState.fuzzyQuery.fill('\0');
+
+        static const char* const phases[] = {"scroll", "fuzzy", "filter", "style", "group"};
+        const int framesPerPhase = std::max(1, frames / 5);
+        for (int phase = 0; phase < 5; ++phase)
+        {
+            std::vector<FrameRecord> records;
+            records.reserve(static_cast<size_t>(framesPerPhase));
+            for (int frame = 0; frame < framesPerPhase; ++frame)
+            {
+                io.DeltaTime = 1.0f / 60.0f;
+                io.AddMousePosEvent(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.6f);
+                if (phase == 0)
+                {
+                    io.AddMouseWheelEvent(0.0f, -3.0f);
+                }
+                else if (phase == 1)
+                {
+                    ScriptTyping(Inspector::gUiState.fuzzyQuery, "code main", frame, 4);
+                }
+                else if (phase == 2)
+                {
+                    Inspector::gUiState.fuzzyQuery.fill('\0');
+                    ScriptTyping(Inspector::gUiState.processFilter, "chrome", frame, 4);
+                }
+                else if (phase == 3)
+                {
+                    Inspector::gUiState.processFilter.fill('\0');
+                    ScriptTyping(Inspector::gUiState.styleFilterText, "WS_VISIBLE !TOOLWINDOW", frame, 1);
+                    Inspector::gUiState.styleFilter.Compile(Inspector::gUiState.styleFilterText.data());
+                }
+                else
+                {
+                    // A different grouping every frame, scrolling as it goes.
+                    Inspector::gUiState.styleFilterText.fill('\0');
+                    Inspector::gUiState.styleFilter.Compile("");
+                    Inspector::gUiState.groupingMode = static_cast<Inspector::GroupingMode>(frame % Inspector::kGroupingModeCount);
+                    io.AddMouseWheelEvent(0.0f, -3.0f);
+                }
+
+                records.push_back(RecordFrame(snapshot, raster));
+            }
+            ReportPhase(phases[phase], windowCount, records);
+        }
+
+        Inspector::gUiState.processFilter.fill('\0');
+        Inspector::gUiState.fuzzyQuery.fill('\0');
+        Inspector::gUiState.styleFilterText.fill('\0');
+        Inspector::gUiState.styleFilter.Compile("");
+        Inspector::gUiState.groupingMode = Inspector::GroupingMode::Process;
+    }
+
+    // The idle frame the app redraws for a blinking caret or a worker wake-up: an unchanged snapshot, no
+    // input, cursor over the list. After warm-up frames have built every per-snapshot cache, such a
+    // frame must not allocate at all, from ImGui's allocator or from operator new.
+    void RunSteadyStateCheck(size_t windowCount, int frames, RasterTarget& raster)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, static_cast<uint32_t>(windowCount) + 3);
+        ImGuiIO& io = ImGui::GetIO();
+        const auto runFrame = [&]() {
+            io.DeltaTime = 1.0f / 60.0f;
+            io.AddMousePosEvent(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.6f);
+            return RecordFrame(snapshot, raster);
+        };
+
+        // The detail pane stays open on one window, answered by a synthetic provider.
+        Inspector::gUiState.windowDetails.SetProvider([](HWND, Inspector::WindowDetails& details) {
+            details.alive = true;
+            details.dpi = 96;
+            details.monitorName = "\\\\.\\DISPLAY1";
+            details.classStyle = 0x0000000Bu;
+            details.properties.push_back(Inspector::WindowProperty{"SyntheticProp", 1});
+        });
+        for (const auto& entry : snapshot.processes)
+        {
+            if (!entry.windows.empty())
+            {
+                Inspector::gUiState.selectedWindow = entry.windows.front().handle;
+                break;
+            }
+        }
+
+        // Warm-up also waits out the grouping and details workers, whose allocations would otherwise land in the count.
+        constexpr int kWarmupFrames = 10;
+        for (int frame = 0; frame < kWarmupFrames || Inspector::gUiState.groupings.Pending() || Inspector::gUiState.windowDetails.Pending(); ++frame)
+        {
+            runFrame();
+            if (frame >= kWarmupFrames)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        runFrame();
+
+        std::vector<FrameRecord> records;
+        records.reserve(static_cast<size_t>(frames));
+        uint64_t imguiAllocations = 0;
+        uint64_t operatorNews = 0;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            records.push_back(runFrame());
+            imguiAllocations += records.back().imguiAllocations;
+            operatorNews += records.back().operatorNews;
+        }
+        ReportPhase("steady", windowCount, records);
+        Inspector::gUiState.selectedWindow = nullptr;
+        Inspector::gUiState.windowDetails.SetProvider({});
+#if defined(INSPECTOR_BENCH_MAIN)
+        const bool allocated = imguiAllocations != 0 || operatorNews != 0;
+#else
+        // Inside the app binary operator new is not hooked.
+        const bool allocated = imguiAllocations != 0;
+#endif
+        if (allocated)
+        {
+            std::printf("          steady state allocated: %llu ImGui, %llu operator new over %zu frames%s\n",
+                        static_cast<unsigned long long>(imguiAllocations), static_cast<unsigned long long>(operatorNews), records.size(),
+                        MismatchLabel(true));
+        }
+    }
+
+    // Desktop map over every window (hidden ones included) in pick mode: zooms in around a point, then
+    // back out, with the cursor over the canvas so each frame hit-tests and scrolls the list to the pick.
+    void RunMinimapBenchmark(size_t windowCount, int frames, RasterTarget& raster)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, static_cast<uint32_t>(windowCount) + 7);
+        Inspector::DesktopMinimap& minimap = Inspector::gUiState.minimap;
+        Inspector::gUiState.processFilter.fill('\0');
+        Inspector::gUiState.fuzzyQuery.fill('\0');
+        Inspector::gUiState.pickMode = true;
+        minimap.visible = true;
+        minimap.includeHidden = true;
+
+        ImGuiIO& io = ImGui::GetIO();
+        std::vector<FrameRecord> records;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            io.DeltaTime = 1.0f / 60.0f;
+            io.AddMousePosEvent(420.0f, 300.0f);
+            io.AddMouseWheelEvent(0.0f, frame < frames / 2 ? 1.0f : -1.0f);
+
+            records.push_back(RecordFrame(snapshot, raster));
+        }
+        ReportPhase("map", windowCount, records);
+
+        minimap.visible = false;
+        minimap.includeHidden = false;
+        Inspector::gUiState.pickMode = false;
+    }
+
+    // An hour of 1 Hz captures over `windowCount` windows with steady churn (windows replaced, retitled,
+    // moved, shown and hidden), then the timeline panel fitted to the hour, zoomed in around a point and
+    // dragged.
+    void RunTimelineBenchmark(size_t windowCount, int frames, RasterTarget& raster)
+    {
+        constexpr int kSeconds = 3600;
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 17);
+        Inspector::WindowHistory& history = Inspector::gUiState.history;
+        history.Clear();
+        Inspector::IdentityRegistry identities;
+
+        std::mt19937 rng(23);
+        uintptr_t nextHandle = 0x50000000;
+        std::vector<double> recordMs;
+        recordMs.reserve(kSeconds);
+        for (int second = 0; second < kSeconds; ++second)
+        {
+            for (auto& entry : snapshot.processes)
+            {
+                for (auto& window : entry.windows)
+                {
+                    const uint32_t roll = rng() % 1000;
+                    if (roll >= 18)
+                    {
+                        continue;
+                    }
+                    if (roll < 3)
+                    {
+                        window.handle = reinterpret_cast<HWND>(nextHandle += 2);
+                    }
+                    else if (roll < 8)
+                    {
+                        window.title = L"Document " + std::to_wstring(rng() % 100);
+                    }
+                    else if (roll < 15)
+                    {
+                        window.bounds.left += 8;
+                        window.bounds.right += 8;
+                    }
+                    else
+                    {
+                        window.visible = !window.visible;
+                    }
+                    Inspector::PrepareWindowStrings(window);
+                    window.hashes = Inspector::HashWindowFields(window);
+                }
+            }
+            ++snapshot.generation;
+            identities.Assign(snapshot);
+            const auto start = Clock::now();
+            history.Record(snapshot, static_cast<double>(second));
+            recordMs.push_back(ElapsedMs(start, Clock::now()));
+        }
+
+        std::vector<uint32_t> hits;
+        const auto fullStart = Clock::now();
+        history.QueryRange(0.0, kSeconds, hits);
+        const double fullMs = ElapsedMs(fullStart, Clock::now());
+        const size_t fullHits = hits.size();
+        const auto zoomStart = Clock::now();
+        history.QueryRange(1800.0, 1830.0, hits);
+        const double zoomMs = ElapsedMs(zoomStart, Clock::now());
+
+        Inspector::LifetimeTimeline& timeline = Inspector::gUiState.timeline;
+        timeline.visible = true;
+        ImGuiIO& io = ImGui::GetIO();
+        std::vector<FrameRecord> records;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            io.DeltaTime = 1.0f / 60.0f;
+            const int third = frame * 3 / std::max(1, frames);
+            if (third == 0)
+            {
+                io.AddMousePosEvent(700.0f, 300.0f);
+                io.AddMouseWheelEvent(0.0f, 1.0f);
+            }
+            else if (third == 1)
+            {
+                io.AddMousePosEvent(700.0f - static_cast<float>(frame % 20) * 12.0f, 300.0f);
+                io.AddMouseButtonEvent(0, true);
+            }
+            else
+            {
+                io.AddMouseButtonEvent(0, false);
+                io.AddMousePosEvent(700.0f, 300.0f);
+                io.AddMouseWheelEvent(0.0f, -1.0f);
+            }
+
+            records.push_back(RecordFrame(snapshot, raster));
+        }
+        io.AddMouseButtonEvent(0, false);
+        ReportPhase("timeline", windowCount, records);
+        std::printf("          %d records, %zu lifetimes | record p50 %.3f max %.3f ms | query 1h %.3f ms (%zu) 30s %.3f ms (%zu)\n",
+                    kSeconds, history.LifetimeCount(), Percentile(recordMs, 0.5), Percentile(recordMs, 1.0), fullMs, fullHits, zoomMs, hits.size());
+
+        timeline.visible = false;
+        history.Clear();
+    }
+
+    // Synthetic child hierarchy: a child's handle encodes its depth (bits 56-59) plus a hash of its
+    // parent, so re-enumerating the same parent always yields the same handles.
+    constexpr uintptr_t kSyntheticChildMarker = uintptr_t{1} << 62;
+
+    uint32_t SyntheticDepth(HWND handle)
+    {
+        const auto value = reinterpret_cast<uintptr_t>(handle);
+        return (value & kSyntheticChildMarker) != 0 ? static_cast<uint32_t>((value >> 56) & 0xF) : 0;
+    }
+
+    Inspector::ChildWindowSource MakeSyntheticChildSource(uint32_t fanout, uint32_t maxDepth)
+    {
+        Inspector::ChildWindowSource source;
+        source.hasChildren = [maxDepth](HWND handle) { return SyntheticDepth(handle) < maxDepth; };
+        source.enumerateChildren = [fanout, maxDepth](HWND parent, std::vector<WindowInfo>& children) {
+            const uint32_t depth = SyntheticDepth(parent) + 1;
+            if (depth > maxDepth)
+            {
+                return;
+            }
+            static const wchar_t* const classes[] = {L"Button", L"Edit", L"Static", L"SysListView32", L"Chrome_RenderWidgetHostHWND"};
+            for (uint32_t i = 0; i < fanout; ++i)
+            {
+                uint64_t hash = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(parent)) * 0x9E3779B97F4A7C15ull) ^ (i + 1);
+                hash ^= hash >> 29;
+                WindowInfo child;
+                child.handle = reinterpret_cast<HWND>(kSyntheticChildMarker | (static_cast<uintptr_t>(depth) << 56) | (hash & 0x00FFFFFFFFFFFFFFull));
+                child.className = classes[(hash >> 8) % 5];
+                child.title = L"Control " + std::to_wstring(i);
+                child.visible = (hash & 3) != 0;
+                child.zOrder = i;
+                child.bounds = RECT{static_cast<LONG>(i * 20), static_cast<LONG>(depth * 20), static_cast<LONG>(i * 20 + 80), static_cast<LONG>(depth * 20 + 24)};
+                Inspector::PrepareWindowStrings(child);
+                children.push_back(std::move(child));
+            }
+        };
+        return source;
+    }
+
+    // Expands one top-level window into a 10-ary, 5-deep subtree (111k descendants) and scrolls
+    // through it, measuring the lazy load, the flatten and the clipped tree frames.
+    void RunTreeBenchmark(int frames, RasterTarget& raster)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(1000, 1000);
+        Inspector::WindowTree& tree = Inspector::gUiState.windowTree;
+        tree.SetSource(MakeSyntheticChildSource(10, 5));
+        tree.Sync(snapshot, "");
+        Inspector::gUiState.processFilter.fill('\0');
+        Inspector::gUiState.fuzzyQuery.fill('\0');
+        Inspector::gUiState.showWindowTree = true;
+
+        const auto expandStart = Clock::now();
+        tree.SetExpanded(0, true, true);
+        const auto expandEnd = Clock::now();
+        const size_t rowCount = tree.VisibleRows().size();
+        const auto flattenEnd = Clock::now();
+        tree.SetExpanded(0, false);
+        tree.VisibleRows();
+        tree.SetExpanded(0, true);
+        const auto toggleStart = Clock::now();
+        tree.VisibleRows();
+        const auto toggleEnd = Clock::now();
+
+        // Narrowing the process filter to the expanded window's process and clearing it again must keep the
+        // loaded subtree instead of enumerating it a second time.
+        size_t rootCount = 0;
+        std::string filter;
+        for (const auto& entry : snapshot.processes)
+        {
+            rootCount += entry.windows.size();
+            if (filter.empty() && !entry.windows.empty())
+            {
+                filter = entry.process.nameUtf8;
+            }
+        }
+        size_t filteredRoots = 0;
+        for (const auto& entry : snapshot.processes)
+        {
+            if (Inspector::TextSearch::FindCaseInsensitive(entry.process.nameUtf8.data(), entry.process.nameUtf8.size(), filter.data(), filter.size()) != nullptr)
+            {
+                filteredRoots += entry.windows.size();
+            }
+        }
+        size_t subtree = 0;
+        for (size_t level = 1, width = 10; level <= 5; ++level, width *= 10)
+        {
+            subtree += width;
+        }
+        const size_t loadedNodes = tree.NodeCount();
+        tree.Sync(snapshot, filter.c_str());
+        const size_t filteredRows = tree.VisibleRows().size();
+        tree.Sync(snapshot, "");
+        const size_t restoredRows = tree.VisibleRows().size();
+        const bool treeMismatch = rowCount != rootCount + subtree || loadedNodes != rootCount + subtree || filteredRows != filteredRoots + subtree ||
+                                  restoredRows != rowCount || tree.NodeCount() != loadedNodes;
+
+        ImGuiIO& io = ImGui::GetIO();
+        std::vector<FrameRecord> records;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            io.DeltaTime = 1.0f / 60.0f;
+            io.AddMousePosEvent(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.6f);
+            io.AddMouseWheelEvent(0.0f, -50.0f);
+
+            records.push_back(RecordFrame(snapshot, raster));
+        }
+
+        std::printf("\nChild window tree: %zu visible rows, %zu loaded nodes\n", rowCount, tree.NodeCount());
+        std::printf("expand subtree %.3f ms | flatten %.3f ms | re-flatten after toggle %.3f ms\n",
+                    ElapsedMs(expandStart, expandEnd), ElapsedMs(expandEnd, flattenEnd), ElapsedMs(toggleStart, toggleEnd));
+        std::printf("rows %zu / %zu expected | filtered %zu / %zu | after clearing the filter %zu rows, %zu nodes%s\n", rowCount,
+                    rootCount + subtree, filteredRows, filteredRoots + subtree, restoredRows, tree.NodeCount(), MismatchLabel(treeMismatch));
+        ReportPhase("tree", rowCount, records);
+
+        // A refresh that still lists the expanded window keeps every expansion under it; one without it
+        // forgets them.
+        InspectorSnapshot next = snapshot;
+        ++next.generation;
+        tree.Sync(next, "");
+        const size_t keptExpanded = tree.ExpandedCount();
+        for (auto& entry : next.processes)
+        {
+            if (!entry.windows.empty())
+            {
+                entry.windows.erase(entry.windows.begin());
+                break;
+            }
+        }
+        ++next.generation;
+        tree.Sync(next, "");
+        std::printf("expanded windows after a refresh %zu / %zu expected | after its root closed %zu%s\n", keptExpanded, subtree + 1,
+                    tree.ExpandedCount(), MismatchLabel(keptExpanded != subtree + 1 || tree.ExpandedCount() != 0));
+
+        Inspector::gUiState.showWindowTree = false;
+        tree.SetSource({});
+    }
+
+    // Renders every frame the pacer asks for, one per 16 ms, until `until`, jumping to the pacer's next
+    // deadline while it idles. `frame` runs the per-frame work of the main loop; returns frames rendered.
+    template <typename FrameFn>
+    size_t SimulatePacedLoop(Inspector::RenderPacer& pacer, Clock::time_point& now, Clock::time_point until, FrameFn frame)
+    {
+        size_t rendered = 0;
+        while (now < until)
+        {
+            if (pacer.ShouldRender(now))
+            {
+                frame(now);
+                pacer.OnFrameRendered(now);
+                ++rendered;
+                now += std::chrono::milliseconds(16);
+                continue;
+            }
+            const uint32_t timeout = pacer.WaitTimeoutMs(now);
+            if (timeout == Inspector::RenderPacer::kWaitForever)
+            {
+                break;
+            }
+            now += std::chrono::milliseconds(timeout);
+        }
+        now = std::max(now, until);
+        return rendered;
+    }
+
+    // The main loop's pacing on a simulated clock: trailing frames after input, a continuous window
+    // expiring, the earliest scheduled wake winning, going idle with nothing pending, and a timeline
+    // recording session whose unchanged once-a-second refreshes must not keep the loop drawing.
+    void RunPacerCheck()
+    {
+        using std::chrono::milliseconds;
+        using std::chrono::seconds;
+        const auto idle = [](const Inspector::RenderPacer& pacer, Clock::time_point now) {
+            return !pacer.ShouldRender(now) && pacer.WaitTimeoutMs(now) == Inspector::RenderPacer::kWaitForever;
+        };
+        const auto noop = [](Clock::time_point) {};
+        Inspector::RenderPacer pacer;
+        Clock::time_point now = Clock::time_point{} + std::chrono::hours(1);
+
+        // Startup and input each draw exactly the trailing frames, then the loop blocks.
+        const size_t startup = SimulatePacedLoop(pacer, now, now + seconds(1), noop);
+        const bool idleAfterStartup = idle(pacer, now);
+        pacer.NotifyInput();
+        const size_t afterInput = SimulatePacedLoop(pacer, now, now + seconds(1), noop);
+        const bool idleAfterInput = idle(pacer, now);
+
+        // A continuous request draws until its deadline and no further.
+        const Clock::time_point continuousEnd = now + milliseconds(160);
+        pacer.RequestContinuousUntil(continuousEnd);
+        const bool continuousDraws = pacer.ShouldRender(now) && pacer.WaitTimeoutMs(now) == 0;
+        const size_t continuous = SimulatePacedLoop(pacer, now, now + seconds(1), noop);
+        const bool continuousExpired = !pacer.ShouldRender(continuousEnd) && idle(pacer, now);
+
+        // The earliest wake wins and the timeout rounds up to it; a frame at the wake consumes it.
+        const Clock::time_point wakeStart = now;
+        pacer.ScheduleWake(wakeStart + milliseconds(500));
+        pacer.ScheduleWake(wakeStart + milliseconds(200));
+        pacer.ScheduleWake(wakeStart + milliseconds(300));
+        const bool wakeOrder = pacer.WaitTimeoutMs(wakeStart) == 200 && pacer.WaitTimeoutMs(wakeStart + std::chrono::microseconds(199500)) == 1 &&
+                               !pacer.ShouldRender(wakeStart + milliseconds(199)) && pacer.ShouldRender(wakeStart + milliseconds(200));
+        const size_t wakeFrames = SimulatePacedLoop(pacer, now, wakeStart + seconds(1), noop);
+        const bool idleAfterWake = idle(pacer, now);
+
+        // Ten seconds of timeline recording as main.cpp runs it: a refresh once a second, the diff on the
+        // frame after it, a wake for the next capture. Unchanged refreshes only cost their trailing frames;
+        // one that changed something keeps drawing for the fade.
+        constexpr int kRecordSeconds = 10;
+        const auto record = [&](bool changes) {
+            uint64_t generation = 1;
+            Clock::time_point lastCapture = now;
+            return SimulatePacedLoop(pacer, now, now + seconds(kRecordSeconds), [&](Clock::time_point frameTime) {
+                pacer.NotifyChanges(generation, changes, frameTime + milliseconds(static_cast<int>(Inspector::SnapshotDiff::kFadeSeconds * 1000.0)));
+                if (frameTime - lastCapture >= seconds(1))
+                {
+                    ++generation;
+                    lastCapture = frameTime;
+                    pacer.NotifySnapshot();
+                }
+                pacer.ScheduleWake(frameTime + milliseconds(static_cast<int>(Inspector::LifetimeTimeline::kCaptureInterval * 1000.0)));
+            });
+        };
+        pacer.NotifyInput();
+        const size_t recordingUnchanged = record(false);
+        pacer.NotifyInput();
+        const size_t recordingChanged = record(true);
+
+        // Continuous mode renders every frame regardless.
+        pacer.SetEventDriven(false);
+        const bool continuousMode = pacer.ShouldRender(now) && pacer.WaitTimeoutMs(now) == 0;
+        pacer.SetEventDriven(true);
+
+        const size_t trailing = static_cast<size_t>(Inspector::RenderPacer::kTrailingFrames);
+        const bool mismatch = startup != trailing || !idleAfterStartup || afterInput != trailing || !idleAfterInput || !continuousDraws ||
+                              continuous != 10 || !continuousExpired || !wakeOrder || wakeFrames != 1 || !idleAfterWake ||
+                              recordingUnchanged > (trailing + 2) * kRecordSeconds || recordingChanged < 50 * kRecordSeconds || !continuousMode;
+        std::printf("\nRender pacing (simulated clock, frames rendered)\n");
+        std::printf("startup %zu | input %zu | continuous 160 ms %zu | wakes %zu (timeout %s) | recording 10 s: unchanged %zu, changing %zu%s\n",
+                    startup, afterInput, continuous, wakeFrames, wakeOrder ? "ok" : "wrong", recordingUnchanged, recordingChanged, MismatchLabel(mismatch));
+    }
+
+    // Full build, a refresh where 1% of windows moved and 1% were replaced, then random point and
+    // region queries against a linear scan over the same rectangles.
+    void RunSpatialBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 99);
+        Inspector::SpatialIndex index;
+        const auto buildStart = Clock::now();
+        index.Update(snapshot);
+        const auto buildEnd = Clock::now();
+
+        std::mt19937 rng(5);
+        uintptr_t nextHandle = 0x40000000;
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                const uint32_t roll = rng() % 100;
+                if (roll == 0)
+                {
+                    const LONG dx = static_cast<LONG>(rng() % 200) - 100;
+                    window.bounds = RECT{window.bounds.left + dx, window.bounds.top, window.bounds.right + dx, window.bounds.bottom};
+                }
+                else if (roll == 1)
+                {
+                    window.handle = reinterpret_cast<HWND>(nextHandle += 2);
+                }
+            }
+        }
+        ++snapshot.generation;
+        const auto updateStart = Clock::now();
+        index.Update(snapshot);
+        const auto updateEnd = Clock::now();
+
+        constexpr int kQueries = 10000;
+        std::vector<uint32_t> hits;
+        std::vector<POINT> points(kQueries);
+        for (auto& point : points)
+        {
+            point = POINT{static_cast<LONG>(rng() % 3840), static_cast<LONG>(rng() % 2160)};
+        }
+        size_t pointHits = 0;
+        const auto pointStart = Clock::now();
+        for (const POINT& point : points)
+        {
+            index.QueryPoint(point.x, point.y, hits);
+            pointHits += hits.size();
+        }
+        const auto pointEnd = Clock::now();
+        size_t topmostHits = 0;
+        for (const POINT& point : points)
+        {
+            topmostHits += index.TopmostAt(point.x, point.y) != Inspector::SpatialIndex::kNoEntry;
+        }
+        const auto topmostEnd = Clock::now();
+        size_t rectHits = 0;
+        for (const POINT& point : points)
+        {
+            index.QueryRect(RECT{point.x, point.y, point.x + 400, point.y + 300}, hits);
+            rectHits += hits.size();
+        }
+        const auto rectEnd = Clock::now();
+
+        size_t linearHits = 0;
+        size_t indexedHits = 0;
+        const int linearQueries = kQueries / 10;
+        for (int i = 0; i < linearQueries; ++i)
+        {
+            index.QueryPoint(points[static_cast<size_t>(i)].x, points[static_cast<size_t>(i)].y, hits);
+            indexedHits += hits.size();
+        }
+        const auto linearStart = Clock::now();
+        for (int i = 0; i < linearQueries; ++i)
+        {
+            const POINT& point = points[static_cast<size_t>(i)];
+            for (const auto& entry : snapshot.processes)
+            {
+                for (const auto& window : entry.windows)
+                {
+                    linearHits += point.x >= window.bounds.left && point.x < window.bounds.right && point.y >= window.bounds.top && point.y < window.bounds.bottom;
+                }
+            }
+        }
+        const auto linearEnd = Clock::now();
+
+        const Inspector::SpatialIndex::UpdateStats& update = index.LastUpdate();
+        std::printf("%8zu  %8.3f %8.3f%-9s  %8.2f %8.2f %8.2f %10.2f  %8.1f %8.1f%s\n", windowCount,
+                    ElapsedMs(buildStart, buildEnd), ElapsedMs(updateStart, updateEnd), update.rebuilt ? " rebuilt" : "",
+                    ElapsedMs(pointStart, pointEnd) * 1000.0 / kQueries, ElapsedMs(pointEnd, topmostEnd) * 1000.0 / kQueries,
+                    ElapsedMs(topmostEnd, rectEnd) * 1000.0 / kQueries, ElapsedMs(linearStart, linearEnd) * 1000.0 / linearQueries,
+                    static_cast<double>(pointHits) / kQueries, static_cast<double>(rectHits) / kQueries,
+                    MismatchLabel(linearHits != indexedHits));
+        std::printf("          topmost resolved %zu of %d points\n", topmostHits, kQueries);
+    }
+
+    // Counts windows whose incremental result differs from a from-scratch computation.
+    size_t CountOcclusionMismatches(const InspectorSnapshot& snapshot, const Inspector::SpatialIndex& index, const Inspector::OcclusionMap& incremental)
+    {
+        Inspector::SpatialIndex freshIndex;
+        Inspector::OcclusionMap fresh;
+        freshIndex.Update(snapshot);
+        fresh.Update(snapshot, freshIndex);
+        size_t mismatches = 0;
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const auto& window : entry.windows)
+            {
+                const Inspector::OcclusionResult* a = incremental.ResultFor(index.SlotOf(window.handle));
+                const Inspector::OcclusionResult* b = fresh.ResultFor(freshIndex.SlotOf(window.handle));
+                mismatches += a == nullptr || b == nullptr || a->visibleArea != b->visibleArea;
+            }
+        }
+        return mismatches;
+    }
+
+    // Full computation, a refresh where a few windows moved, then one where a window was activated.
+    void RunOcclusionBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 77);
+        Inspector::SpatialIndex index;
+        Inspector::OcclusionMap occlusion;
+        const auto fullStart = Clock::now();
+        index.Update(snapshot);
+        occlusion.Update(snapshot, index);
+        const auto fullEnd = Clock::now();
+        const size_t fullRecomputed = occlusion.LastUpdate().recomputed;
+
+        std::mt19937 rng(3);
+        std::vector<WindowInfo*> visible;
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                if (window.visible)
+                {
+                    visible.push_back(&window);
+                }
+            }
+        }
+        for (int i = 0; i < 8 && !visible.empty(); ++i)
+        {
+            WindowInfo& window = *visible[rng() % visible.size()];
+            const LONG dx = static_cast<LONG>(rng() % 101) - 50;
+            window.bounds = RECT{window.bounds.left + dx, window.bounds.top + dx, window.bounds.right + dx, window.bounds.bottom + dx};
+        }
+        ++snapshot.generation;
+        const auto moveStart = Clock::now();
+        index.Update(snapshot);
+        occlusion.Update(snapshot, index);
+        const auto moveEnd = Clock::now();
+        const size_t moveRecomputed = occlusion.LastUpdate().recomputed;
+        const size_t moveMismatches = CountOcclusionMismatches(snapshot, index, occlusion);
+
+        // Bring the bottom-most visible window to the front.
+        if (!visible.empty())
+        {
+            WindowInfo* bottom = *std::max_element(visible.begin(), visible.end(), [](const WindowInfo* a, const WindowInfo* b) { return a->zOrder < b->zOrder; });
+            for (auto& entry : snapshot.processes)
+            {
+                for (auto& window : entry.windows)
+                {
+                    window.zOrder += window.zOrder < bottom->zOrder ? 1 : 0;
+                }
+            }
+            bottom->zOrder = 0;
+        }
+        ++snapshot.generation;
+        const auto activateStart = Clock::now();
+        index.Update(snapshot);
+        occlusion.Update(snapshot, index);
+        const auto activateEnd = Clock::now();
+        const size_t activateMismatches = CountOcclusionMismatches(snapshot, index, occlusion);
+        const size_t activateRecomputed = occlusion.LastUpdate().recomputed;
+        const size_t covered = occlusion.FullyHiddenCount();
+
+        // The random layout above overlaps so densely that eight moves already trip the full pass. Tiled,
+        // non-overlapping windows nudged by a few pixels only disturb their neighbours, so the same update
+        // must stay incremental and still agree with a full pass.
+        const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(windowCount))));
+        size_t tile = 0;
+        std::vector<WindowInfo*> tiled;
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                const LONG left = static_cast<LONG>(tile % columns) * 42;
+                const LONG top = static_cast<LONG>(tile / columns) * 32;
+                window.bounds = RECT{left, top, left + 40, top + 30};
+                window.visible = true;
+                tiled.push_back(&window);
+                ++tile;
+            }
+        }
+        ++snapshot.generation;
+        index.Update(snapshot);
+        occlusion.Update(snapshot, index);
+        for (int i = 0; i < 8; ++i)
+        {
+            WindowInfo& window = *tiled[rng() % tiled.size()];
+            const LONG dx = static_cast<LONG>(rng() % 21) - 10;
+            const LONG dy = static_cast<LONG>(rng() % 21) - 10;
+            window.bounds = RECT{window.bounds.left + dx, window.bounds.top + dy, window.bounds.right + dx, window.bounds.bottom + dy};
+        }
+        ++snapshot.generation;
+        const auto tiledStart = Clock::now();
+        index.Update(snapshot);
+        occlusion.Update(snapshot, index);
+        const auto tiledEnd = Clock::now();
+        const Inspector::OcclusionMap::UpdateStats tiledUpdate = occlusion.LastUpdate();
+        const size_t tiledMismatches = CountOcclusionMismatches(snapshot, index, occlusion);
+        // Each moved tile can overlap at most its eight neighbours.
+        const bool tiledIncremental = !tiledUpdate.full && tiledUpdate.recomputed <= 8 * 9;
+
+        std::printf("%8zu  %8zu  %9.3f %6zu  %9.3f %6zu  %9.3f %6zu  %9.3f %6zu %8zu%s\n", windowCount, visible.size(),
+                    ElapsedMs(fullStart, fullEnd), fullRecomputed, ElapsedMs(moveStart, moveEnd), moveRecomputed,
+                    ElapsedMs(activateStart, activateEnd), activateRecomputed, ElapsedMs(tiledStart, tiledEnd), tiledUpdate.recomputed, covered,
+                    MismatchLabel(moveMismatches + activateMismatches + tiledMismatches != 0 || !tiledIncremental));
+    }
+
+    // Baseline, an unchanged refresh and a refresh where ~1% of windows each got a new title, moved or
+    // were replaced by a new handle.
+    void RunDiffBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 91);
+        Inspector::IdentityRegistry identities;
+        Inspector::SpatialIndex index;
+        Inspector::SnapshotDiff diff;
+        identities.Assign(snapshot);
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 0.0);
+        const double baselineMs = diff.LastUpdate().milliseconds;
+
+        ++snapshot.generation;
+        identities.Assign(snapshot);
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 1.0);
+        const double unchangedMs = diff.LastUpdate().milliseconds;
+        const size_t unchangedReported = diff.LastUpdate().added + diff.LastUpdate().removed + diff.LastUpdate().changed;
+
+        std::mt19937 rng(5);
+        uintptr_t nextHandle = 0x70000000;
+        size_t retitled = 0;
+        size_t moved = 0;
+        size_t replaced = 0;
+        // One pid comes back as another process that owns the very same handles, so every hash matches and
+        // only the window ids tell the old windows from the new ones.
+        bool recycled = false;
+        for (auto& entry : snapshot.processes)
+        {
+            if (!recycled && !entry.windows.empty())
+            {
+                recycled = true;
+                ++entry.process.createTime;
+                replaced += entry.windows.size();
+                continue;
+            }
+            for (auto& window : entry.windows)
+            {
+                switch (rng() % 100)
+                {
+                case 0:
+                    window.title += L" *";
+                    ++retitled;
+                    break;
+                case 1:
+                    window.bounds.right += 10;
+                    ++moved;
+                    break;
+                case 2:
+                    window.handle = reinterpret_cast<HWND>(nextHandle += 2);
+                    ++replaced;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+        Inspector::PrepareSnapshotStrings(snapshot);
+        ++snapshot.generation;
+        identities.Assign(snapshot);
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 2.0);
+        const Inspector::SnapshotDiff::UpdateStats& churn = diff.LastUpdate();
+        const bool mismatch = unchangedReported != 0 || churn.added != replaced || churn.removed != replaced || churn.changed != retitled + moved;
+
+        std::printf("%8zu  %9.3f %9.3f %9.3f  %6zu %6zu %6zu%s\n", windowCount, baselineMs, unchangedMs, churn.milliseconds,
+                    churn.added, churn.removed, churn.changed, MismatchLabel(mismatch));
+    }
+
+    // Index, diff and stats for `snapshot` from scratch, as a reference for the incremental counts.
+    bool SameStats(const InspectorSnapshot& snapshot, const Inspector::WindowStats& stats)
+    {
+        Inspector::SpatialIndex index;
+        Inspector::SnapshotDiff diff;
+        Inspector::WindowStats fresh;
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 0.0);
+        fresh.Update(snapshot, index, diff);
+
+        bool same = stats.WindowCount() == fresh.WindowCount() && stats.VisibleCount() == fresh.VisibleCount() &&
+                    stats.Widths() == fresh.Widths() && stats.Heights() == fresh.Heights() && stats.MonitorCounts() == fresh.MonitorCounts() &&
+                    stats.Processes().Size() == fresh.Processes().Size() && stats.Classes().Size() == fresh.Classes().Size();
+        for (size_t rank = 0; same && rank < stats.Processes().Size(); ++rank)
+        {
+            const auto& entry = stats.Processes().At(rank);
+            same = fresh.Processes().CountOf(entry.key) == entry.count && (rank == 0 || stats.Processes().At(rank - 1).count >= entry.count) &&
+                   stats.ProcessName(entry.key) == fresh.ProcessName(entry.key);
+        }
+        for (size_t rank = 0; same && rank < stats.Classes().Size(); ++rank)
+        {
+            const auto& entry = stats.Classes().At(rank);
+            same = fresh.Classes().CountOf(entry.key) == entry.count && (rank == 0 || stats.Classes().At(rank - 1).count >= entry.count) &&
+                   stats.ClassName(entry.key) == fresh.ClassName(entry.key);
+        }
+        return same;
+    }
+
+    // Incremental stats after the diff of a baseline, an unchanged refresh, ~3% churn and a refresh in
+    // which every window was replaced, each checked against a full recount.
+    void RunStatsBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 57);
+        Inspector::IdentityRegistry identities;
+        Inspector::SpatialIndex index;
+        Inspector::SnapshotDiff diff;
+        Inspector::WindowStats stats;
+        bool same = true;
+        double ms[4] = {};
+        std::mt19937 rng(17);
+        uintptr_t nextHandle = 0x60000000;
+        for (int pass = 0; pass < 4; ++pass)
+        {
+            if (pass >= 2)
+            {
+                // The first process's pid is recycled by a process of another name that inherits its windows'
+                // handles: the counts stay, the name must not.
+                if (pass == 2 && !snapshot.processes.empty())
+                {
+                    ++snapshot.processes[0].process.createTime;
+                    snapshot.processes[0].process.name = L"recycled.exe";
+                }
+                for (auto& entry : snapshot.processes)
+                {
+                    for (auto& window : entry.windows)
+                    {
+                        const uint32_t roll = pass == 3 ? 0 : rng() % 100;
+                        if (roll == 0)
+                        {
+                            window.handle = reinterpret_cast<HWND>(nextHandle += 2);
+                            window.bounds.right += static_cast<LONG>(rng() % 2000);
+                            window.visible = !window.visible;
+                        }
+                        else if (roll == 1)
+                        {
+                            window.className = window.className == L"Button" ? L"Static" : L"Button";
+                        }
+                        else if (roll == 2)
+                        {
+                            window.bounds.bottom += 700;
+                        }
+                    }
+                }
+                Inspector::PrepareSnapshotStrings(snapshot);
+            }
+            ++snapshot.generation;
+            identities.Assign(snapshot);
+            index.Update(snapshot);
+            diff.Update(snapshot, index, static_cast<double>(pass));
+            stats.Update(snapshot, index, diff);
+            ms[pass] = stats.LastUpdate().milliseconds;
+            if (pass >= 2)
+            {
+                same = same && SameStats(snapshot, stats);
+            }
+        }
+        std::printf("%8zu  %9.3f %9.3f %9.3f %9.3f  %6zu %6zu%s\n", windowCount, ms[0], ms[1], ms[2], ms[3],
+                    stats.Processes().Size(), stats.Classes().Size(), MismatchLabel(!same));
+    }
+
+    // Watch polls over a synthetic desktop: the provider looks each handle up in the snapshot, the way
+    // the Win32 one asks user32 about exactly that window. Every tenth poll one watched window moves.
+    void RunWatchBenchmark(size_t windowCount, size_t watchCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 61);
+        std::unordered_map<HWND, WindowInfo*> byHandle;
+        std::vector<WindowInfo*> all;
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                byHandle.emplace(window.handle, &window);
+                all.push_back(&window);
+            }
+        }
+
+        Inspector::WatchList list;
+        list.SetProvider([&](HWND handle, Inspector::WatchSample& sample) {
+            const auto it = byHandle.find(handle);
+            if (it == byHandle.end())
+            {
+                return false;
+            }
+            sample.title.assign(it->second->title);
+            sample.bounds = it->second->bounds;
+            sample.style = it->second->style;
+            sample.exStyle = it->second->exStyle;
+            return true;
+        });
+        const size_t stride = std::max<size_t>(1, all.size() / watchCount);
+        for (size_t i = 0; i < watchCount && i * stride < all.size(); ++i)
+        {
+            list.Pin(all[i * stride]->handle);
+        }
+
+        constexpr int kPolls = 400;
+        std::vector<double> times;
+        times.reserve(kPolls);
+        uint64_t unchangedNews = 0;
+        auto now = Inspector::WatchList::Clock::time_point{} + std::chrono::hours(1);
+        for (int poll = 0; poll < kPolls; ++poll)
+        {
+            const bool move = poll % 10 == 5;
+            if (move)
+            {
+                all[(static_cast<size_t>(poll) % watchCount) * stride]->bounds.left += 4;
+            }
+            const uint64_t newsBefore = OperatorNewCount();
+            list.Poll(now);
+            unchangedNews += move ? 0 : OperatorNewCount() - newsBefore;
+            times.push_back(list.LastPoll().microseconds);
+            now += Inspector::WatchList::kPollInterval;
+        }
+
+        size_t changes = 0;
+        for (const Inspector::WatchedWindow& window : list.Windows())
+        {
+            changes += window.changes.size();
+        }
+        std::printf("%8zu  %7zu  %8.2f %8.2f  %7zu %8llu\n", windowCount, list.Windows().size(), Percentile(times, 0.5), Percentile(times, 0.99), changes,
+                    static_cast<unsigned long long>(unchangedNews));
+    }
+
+    // Splicing a re-enumerated process into the snapshot against rebuilding the strings and hashes of the
+    // whole snapshot (the part of a full refresh that can run here; the Win32 queries scale the same way),
+    // plus the index and diff updates that follow either.
+    void RunProcessRefreshBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 29);
+        Inspector::SpatialIndex index;
+        Inspector::SnapshotDiff diff;
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 0.0);
+
+        // The process with the most windows; a tenth of them get new titles and one closes.
+        size_t largest = 0;
+        for (size_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            if (snapshot.processes[process].windows.size() > snapshot.processes[largest].windows.size())
+            {
+                largest = process;
+            }
+        }
+        std::vector<WindowInfo> fresh = snapshot.processes[largest].windows;
+        size_t retitled = 0;
+        for (size_t i = 0; i < fresh.size(); i += 10)
+        {
+            fresh[i].title += L" (updated)";
+            ++retitled;
+        }
+        fresh.pop_back();
+        const size_t processWindows = fresh.size();
+
+        // The process was activated, so its windows now sit on top of everyone else's.
+        std::vector<HWND> zOrder;
+        std::vector<const WindowInfo*> others;
+        for (size_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            for (const WindowInfo& window : snapshot.processes[process].windows)
+            {
+                if (process != largest)
+                {
+                    others.push_back(&window);
+                }
+            }
+        }
+        std::sort(others.begin(), others.end(), [](const WindowInfo* a, const WindowInfo* b) { return a->zOrder < b->zOrder; });
+        for (size_t i = 0; i < fresh.size(); ++i)
+        {
+            fresh[i].zOrder = static_cast<uint32_t>(i);
+            zOrder.push_back(fresh[i].handle);
+        }
+        for (const WindowInfo* window : others)
+        {
+            zOrder.push_back(window->handle);
+        }
+
+        // A pid listed with another creation time has been recycled and must not be spliced.
+        const Inspector::ProcessInfo& owner = snapshot.processes[largest].process;
+        const bool recycled = Inspector::SpliceProcessWindows(snapshot, owner.pid, owner.createTime + 1, fresh, zOrder, snapshot.generation + 1);
+
+        auto start = Clock::now();
+        const bool spliced = Inspector::SpliceProcessWindows(snapshot, owner.pid, owner.createTime, std::move(fresh), zOrder, snapshot.generation + 1);
+        const double spliceMs = ElapsedMs(start, Clock::now());
+
+        // Every window must be numbered by its position in the list the splice was given.
+        std::unordered_map<HWND, uint32_t> positions;
+        for (size_t i = 0; i < zOrder.size(); ++i)
+        {
+            positions.emplace(zOrder[i], static_cast<uint32_t>(i));
+        }
+        bool zOrderMismatch = false;
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const WindowInfo& window : entry.windows)
+            {
+                const auto it = positions.find(window.handle);
+                zOrderMismatch = zOrderMismatch || it == positions.end() || it->second != window.zOrder;
+            }
+        }
+        start = Clock::now();
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 1.0);
+        const double followMs = ElapsedMs(start, Clock::now());
+
+        InspectorSnapshot full = snapshot;
+        start = Clock::now();
+        Inspector::PrepareSnapshotStrings(full);
+        const double fullMs = ElapsedMs(start, Clock::now());
+
+        const Inspector::SnapshotDiff::UpdateStats& changes = diff.LastUpdate();
+        const bool mismatch = !spliced || recycled || zOrderMismatch || changes.changed != retitled || changes.removed != 1 || changes.added != 0 ||
+                              snapshot.totalWindowCount != windowCount - 1;
+        std::printf("%8zu  %8zu  %9.3f %9.3f  %9.3f  %6zu %6zu%s\n", windowCount, processWindows, spliceMs, fullMs, followMs, changes.changed,
+                    changes.removed, MismatchLabel(mismatch));
+    }
+
+    // Time to build each grouping from scratch, as the worker does after every refresh.
+    void RunGroupingBenchmark(size_t windowCount)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 23);
+        std::printf("%8zu", windowCount);
+
+        Inspector::WindowGrouping grouping;
+        auto start = Clock::now();
+        Inspector::BuildProcessGrouping(snapshot, grouping);
+        std::printf("  %8.3f", ElapsedMs(start, Clock::now()));
+
+        Inspector::GroupingInput input;
+        start = Clock::now();
+        Inspector::ExtractGroupingInput(snapshot, input);
+        std::printf(" %8.3f", ElapsedMs(start, Clock::now()));
+
+        bool mismatch = false;
+        for (size_t mode = 1; mode < Inspector::kGroupingModeCount; ++mode)
+        {
+            start = Clock::now();
+            Inspector::BuildKeyedGrouping(static_cast<Inspector::GroupingMode>(mode), input, grouping);
+            std::printf(" %8.3f", ElapsedMs(start, Clock::now()));
+            mismatch = mismatch || grouping.order.size() != windowCount || grouping.groupOffsets.back() != windowCount;
+        }
+        std::printf("%s\n", MismatchLabel(mismatch));
+    }
+
+    // Style filters answered from the attribute bitsets against the grouped list's WindowInfo scan, in the
+    // class grouping so rows are not in snapshot order. Rows must come out identical either way.
+    void RunAttributeBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 29);
+        snapshot.generation = 1;
+        Inspector::AttributeIndex attributes;
+        auto start = Clock::now();
+        attributes.Sync(snapshot);
+        std::printf("%8zu  %8.3f\n", windowCount, ElapsedMs(start, Clock::now()));
+
+        Inspector::GroupingInput input;
+        Inspector::ExtractGroupingInput(snapshot, input);
+        Inspector::WindowGrouping grouping;
+        Inspector::BuildKeyedGrouping(Inspector::GroupingMode::Class, input, grouping);
+
+        static const char* const filters[] = {"visible topmost toolwindow", "shown !toolwindow", "zerosize/owned !popup", "child", "maximize/disabled"};
+        for (const char* text : filters)
+        {
+            Inspector::StyleFilter filter;
+            filter.Compile(text);
+            // A different filter first, so the timed Evaluate is not a cache hit.
+            Inspector::StyleFilter other;
+            other.Compile("caption");
+            attributes.Evaluate(other);
+            start = Clock::now();
+            attributes.Evaluate(filter);
+            const double evaluateUs = ElapsedMs(start, Clock::now()) * 1000.0;
+
+            Inspector::GroupedWindowList indexed;
+            Inspector::GroupedWindowList scanned;
+            indexed.Sync(snapshot, grouping, "", filter, 0, &attributes);
+            scanned.Sync(snapshot, grouping, "", filter);
+            start = Clock::now();
+            const size_t rows = indexed.Rows().size();
+            const double indexedMs = ElapsedMs(start, Clock::now());
+            start = Clock::now();
+            scanned.Rows();
+            const double scanMs = ElapsedMs(start, Clock::now());
+            const bool same = indexed.Rows().size() == scanned.Rows().size() &&
+                              std::equal(indexed.Rows().begin(), indexed.Rows().end(), scanned.Rows().begin(),
+                                         [](const auto& a, const auto& b) { return a.group == b.group && a.item == b.item; });
+            std::printf("          %-28s %9.1f %8zu  %9.3f %9.3f %8zu%s\n", text, evaluateUs, attributes.CurrentStats().matches, indexedMs, scanMs,
+                        rows, MismatchLabel(!same));
+        }
+    }
+
+    // Process metadata over 20 refreshes, one simulated second apart, each replacing 2% of the processes with
+    // a new one under the same pid and asking for the first 64 (a screenful of headers). Queries should
+    // come to the replaced processes plus a memory re-sample every other refresh, not 64 per refresh, and
+    // no request may be answered with the data of a pid's previous process.
+    void RunProcessMetadataBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 43);
+        for (auto& entry : snapshot.processes)
+        {
+            entry.process.createTime = 1000 + entry.process.pid;
+        }
+
+        Inspector::ProcessMetadataCache cache;
+        cache.SetProvider([](const Inspector::ProcessKey& key, uint32_t fields, Inspector::ProcessMetadata& metadata) {
+            metadata.alive = true;
+            metadata.accessible = true;
+            if ((fields & Inspector::kProcessImagePath) != 0)
+            {
+                metadata.imagePath = "C:\\Program Files\\App\\" + std::to_string(key.pid) + ".exe";
+            }
+            if ((fields & Inspector::kProcessCommandLine) != 0)
+            {
+                metadata.commandLine = "app.exe --started " + std::to_string(key.createTime);
+            }
+            metadata.workingSetBytes = key.pid * 4096;
+        });
+
+        constexpr int kRefreshes = 20;
+        constexpr uint32_t kFields = Inspector::kProcessImagePath | Inspector::kProcessCommandLine | Inspector::kProcessMemory;
+        const size_t requested = std::min<size_t>(64, snapshot.processes.size());
+        std::mt19937 rng(47);
+        auto now = Inspector::ProcessMetadataCache::Clock::time_point{} + std::chrono::hours(1);
+        double syncMs = 0.0;
+        double requestUs = 0.0;
+        uint64_t firstQueries = 0;
+        size_t replaced = 0;
+        size_t stale = 0;
+        for (int refresh = 0; refresh <= kRefreshes; ++refresh)
+        {
+            if (refresh != 0)
+            {
+                for (auto& entry : snapshot.processes)
+                {
+                    if (rng() % 50 == 0)
+                    {
+                        entry.process.createTime += 1000000;
+                        replaced += &entry - snapshot.processes.data() < static_cast<ptrdiff_t>(requested) ? 1 : 0;
+                    }
+                }
+                ++snapshot.generation;
+                now += std::chrono::seconds(1);
+            }
+            auto start = Clock::now();
+            cache.Sync(snapshot);
+            syncMs += ElapsedMs(start, Clock::now());
+
+            start = Clock::now();
+            for (size_t process = 0; process < requested; ++process)
+            {
+                cache.Request(snapshot.processes[process].process, kFields, now);
+            }
+            requestUs += ElapsedMs(start, Clock::now()) * 1000.0 / static_cast<double>(requested);
+            while (cache.Pending())
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                cache.Sync(snapshot);
+            }
+            for (size_t process = 0; process < requested; ++process)
+            {
+                const Inspector::ProcessInfo& info = snapshot.processes[process].process;
+                const Inspector::ProcessMetadata* metadata = cache.Request(info, kFields, now);
+                stale += metadata == nullptr || metadata->commandLine != "app.exe --started " + std::to_string(info.createTime) ? 1 : 0;
+            }
+            if (refresh == 0)
+            {
+                firstQueries = cache.CurrentStats().queries;
+            }
+        }
+
+        const Inspector::ProcessMetadataCache::Stats stats = cache.CurrentStats();
+        std::printf("%8zu  %7zu  %7.3f %8.2f  %7llu %7llu %8zu  %7zu %7zu%s\n", windowCount, snapshot.processes.size(), syncMs / (kRefreshes + 1), requestUs / (kRefreshes + 1),
+                    static_cast<unsigned long long>(firstQueries), static_cast<unsigned long long>(stats.queries - firstQueries), replaced, stats.entries, stats.bytes,
+                    MismatchLabel(stale != 0));
+    }
+
+    // Identity assignment for a full refresh (every window arrives without an id and is looked up by handle)
+    // and for a splice (ids carried over), then 3% churn that must change exactly the right ids: a process
+    // replaced under the same pid, handles moved to another process, windows missing for one snapshot.
+    // The last columns read one per-window value for every window by id and by handle.
+    void RunIdentityBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 53);
+        for (auto& entry : snapshot.processes)
+        {
+            entry.process.createTime = 1000 + entry.process.pid;
+        }
+        Inspector::IdentityRegistry identities;
+        auto start = Clock::now();
+        identities.Assign(snapshot);
+        const double firstMs = ElapsedMs(start, Clock::now());
+
+        const auto clearIds = [](InspectorSnapshot& target) {
+            for (auto& entry : target.processes)
+            {
+                entry.process.id = Inspector::kNoIdentity;
+                for (WindowInfo& window : entry.windows)
+                {
+                    window.id = Inspector::kNoIdentity;
+                }
+            }
+        };
+        const InspectorSnapshot assigned = snapshot;
+        clearIds(snapshot);
+        ++snapshot.generation;
+        start = Clock::now();
+        identities.Assign(snapshot);
+        const double refreshMs = ElapsedMs(start, Clock::now());
+        ++snapshot.generation;
+        start = Clock::now();
+        identities.Assign(snapshot);
+        const double carriedMs = ElapsedMs(start, Clock::now());
+
+        size_t mismatches = 0;
+        for (size_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            const auto& before = assigned.processes[process];
+            const auto& after = snapshot.processes[process];
+            mismatches += before.process.id != after.process.id ? 1 : 0;
+            for (size_t window = 0; window < after.windows.size(); ++window)
+            {
+                mismatches += before.windows[window].id != after.windows[window].id ? 1 : 0;
+            }
+        }
+
+        // Churn: every 33rd process restarts under its pid, every 33rd window hands its handle to a window of
+        // the next process, every 33rd window (offset) goes missing for one snapshot.
+        std::vector<std::pair<size_t, WindowInfo>> hidden;
+        size_t counter = 0;
+        for (size_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            auto& entry = snapshot.processes[process];
+            const bool restarted = process % 33 == 5;
+            if (restarted)
+            {
+                entry.process.createTime += 1000000;
+            }
+            for (size_t window = 0; window < entry.windows.size();)
+            {
+                WindowInfo& info = entry.windows[window];
+                ++counter;
+                if (!restarted && counter % 33 == 7)
+                {
+                    hidden.emplace_back(process, info);
+                    entry.windows.erase(entry.windows.begin() + static_cast<ptrdiff_t>(window));
+                    continue;
+                }
+                if (!restarted && counter % 33 == 3 && process + 1 < snapshot.processes.size())
+                {
+                    WindowInfo moved = info;
+                    moved.pid = snapshot.processes[process + 1].process.pid;
+                    moved.id = Inspector::kNoIdentity;
+                    entry.windows.erase(entry.windows.begin() + static_cast<ptrdiff_t>(window));
+                    snapshot.processes[process + 1].windows.push_back(moved);
+                    continue;
+                }
+                ++window;
+            }
+        }
+        clearIds(snapshot);
+        ++snapshot.generation;
+        start = Clock::now();
+        identities.Assign(snapshot);
+        const double churnMs = ElapsedMs(start, Clock::now());
+        const size_t churnNew = identities.CurrentStats().newWindows;
+        for (auto& [process, window] : hidden)
+        {
+            window.id = Inspector::kNoIdentity;
+            snapshot.processes[process].windows.push_back(window);
+        }
+        const uint32_t idsBefore = identities.WindowIdCount();
+        ++snapshot.generation;
+        identities.Assign(snapshot);
+        mismatches += identities.WindowIdCount() - idsBefore != hidden.size() ? 1 : 0;
+        for (size_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            const bool restarted = process % 33 == 5;
+            const bool sameId = snapshot.processes[process].process.id == assigned.processes[process].process.id;
+            mismatches += restarted == sameId ? 1 : 0;
+        }
+
+        // Per-window state read for every window, the way a downstream index would: by id into a flat array,
+        // or by handle through a hash map.
+        std::vector<uint32_t> flat(identities.WindowIdCount(), 1);
+        std::unordered_map<HWND, uint32_t> hashed;
+        hashed.reserve(windowCount);
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const WindowInfo& window : entry.windows)
+            {
+                hashed.emplace(window.handle, 1);
+            }
+        }
+        uint64_t sum = 0;
+        start = Clock::now();
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const WindowInfo& window : entry.windows)
+            {
+                sum += flat[window.id];
+            }
+        }
+        const double flatMs = ElapsedMs(start, Clock::now());
+        start = Clock::now();
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const WindowInfo& window : entry.windows)
+            {
+                sum += hashed.find(window.handle)->second;
+            }
+        }
+        const double hashMs = ElapsedMs(start, Clock::now());
+        mismatches += sum != 2 * static_cast<uint64_t>(windowCount) ? 1 : 0;
+
+        std::printf("%8zu  %8.3f %8.3f %8.3f %8.3f  %7zu %8u  %8.3f %8.3f%s\n", windowCount, firstMs, refreshMs, carriedMs, churnMs, churnNew,
+                    identities.WindowIdCount(), flatMs, hashMs, MismatchLabel(mismatches != 0));
+    }
+
+    // Two-snapshot comparison after 1% each of removed, retitled, recreated (new handle, same title),
+    // moved and added windows. Every window must land in exactly one row.
+    void RunCompareBenchmark(size_t windowCount)
+    {
+        auto left = std::make_shared<InspectorSnapshot>(MakeSyntheticSnapshot(windowCount, 37));
+        auto right = std::make_shared<InspectorSnapshot>(*left);
+        std::mt19937 rng(41);
+        uintptr_t nextHandle = 0x70000000;
+        size_t windows = 0;
+        for (auto& entry : right->processes)
+        {
+            std::vector<WindowInfo> kept;
+            for (WindowInfo& window : entry.windows)
+            {
+                const uint32_t roll = rng() % 100;
+                if (roll == 0)
+                {
+                    continue;
+                }
+                window.title += roll == 1 ? L" *" : L"";
+                window.handle = roll == 2 ? reinterpret_cast<HWND>(nextHandle += 2) : window.handle;
+                window.bounds.left += roll == 3 ? 8 : 0;
+                kept.push_back(window);
+                if (roll == 4)
+                {
+                    kept.push_back(window);
+                    kept.back().handle = reinterpret_cast<HWND>(nextHandle += 2);
+                    kept.back().className = L"Popup";
+                }
+            }
+            windows += kept.size();
+            entry.windows = std::move(kept);
+        }
+        right->totalWindowCount = windows;
+        Inspector::PrepareSnapshotStrings(*right);
+
+        Inspector::SnapshotComparison comparison;
+        std::atomic<uint32_t> progress{0};
+        std::atomic<bool> cancel{false};
+        const auto start = Clock::now();
+        Inspector::CompareSnapshots(left, right, comparison, progress, cancel);
+        const double ms = ElapsedMs(start, Clock::now());
+
+        std::vector<uint8_t> leftSeen(comparison.leftWindows.size(), 0);
+        std::vector<uint8_t> rightSeen(comparison.rightWindows.size(), 0);
+        for (const Inspector::CompareRow& row : comparison.rows)
+        {
+            if (row.left != Inspector::CompareRow::kNone)
+            {
+                ++leftSeen[row.left];
+            }
+            if (row.right != Inspector::CompareRow::kNone)
+            {
+                ++rightSeen[row.right];
+            }
+        }
+        const auto once = [](const std::vector<uint8_t>& seen) { return std::all_of(seen.begin(), seen.end(), [](uint8_t count) { return count == 1; }); };
+        using Kind = Inspector::CompareKind;
+        std::printf("%8zu  %9.2f %9zu  %7zu %7zu %7zu  %7zu%s\n", windowCount, ms, comparison.rows.size(), comparison.kinds[static_cast<size_t>(Kind::Added)],
+                    comparison.kinds[static_cast<size_t>(Kind::Removed)], comparison.kinds[static_cast<size_t>(Kind::Changed)],
+                    comparison.matches[static_cast<size_t>(Inspector::CompareMatch::Title)], MismatchLabel(!once(leftSeen) || !once(rightSeen)));
+    }
+
+    // Byte-at-a-time baseline equivalent to the old ContainsCaseInsensitive/ImStristr loops.
+    bool NaiveContains(const std::string& text, const char* needle, size_t needleLength)
+    {
+        if (needleLength > text.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i + needleLength <= text.size(); ++i)
+        {
+            size_t j = 0;
+            while (j < needleLength && Inspector::TextSearch::FoldAscii(static_cast<unsigned char>(text[i + j])) ==
+                                           Inspector::TextSearch::FoldAscii(static_cast<unsigned char>(needle[j])))
+            {
+                ++j;
+            }
+            if (j == needleLength)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reference for FindCaseInsensitive: both strings decoded into folded code points and compared at every
+    // code point of the haystack.
+    const char* ReferenceFind(const std::string& haystack, const std::string& needle)
+    {
+        const auto decode = [](const std::string& text, std::vector<uint32_t>& codepoints, std::vector<size_t>& offsets) {
+            const auto* begin = reinterpret_cast<const unsigned char*>(text.data());
+            const auto* end = begin + text.size();
+            for (const unsigned char* cursor = begin; cursor < end;)
+            {
+                offsets.push_back(static_cast<size_t>(cursor - begin));
+                codepoints.push_back(Inspector::TextSearch::FoldCodepoint(Inspector::TextSearch::DecodeUtf8(cursor, end)));
+            }
+        };
+        std::vector<uint32_t> text;
+        std::vector<uint32_t> pattern;
+        std::vector<size_t> offsets;
+        std::vector<size_t> unused;
+        decode(haystack, text, offsets);
+        decode(needle, pattern, unused);
+        for (size_t i = 0; i + pattern.size() <= text.size(); ++i)
+        {
+            if (std::equal(pattern.begin(), pattern.end(), text.begin() + static_cast<std::ptrdiff_t>(i)))
+            {
+                return haystack.data() + (i < offsets.size() ? offsets[i] : haystack.size());
+            }
+        }
+        return nullptr;
+    }
+
+    // Random haystacks of mixed-case ASCII, Latin-1, Cyrillic and CJK text (with the odd stray continuation
+    // byte), searched for pieces of themselves with their case flipped and for random strings. Needles run
+    // up to 40 bytes and haystacks up to 200, so every SIMD block path and its tail get exercised.
+    size_t CountSearchMismatches(size_t trials)
+    {
+        static const char* const pieces[] = {"a", "B", "c", "D", "e", "x", "Q", "z", " ", "-", "_", ".", "0", "7",
+                                             "\xc3\xa9", "\xc3\x89", "\xc3\xbf", "\xc5\xb8", "\xd0\xb6", "\xd0\x96", "\xe4\xb8\xad", "\x82"};
+        constexpr size_t kPieceCount = sizeof(pieces) / sizeof(pieces[0]);
+        std::mt19937 rng(2024);
+        const auto randomText = [&](size_t count, bool strays) {
+            std::string text;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const char* piece = pieces[rng() % (strays ? kPieceCount : kPieceCount - 1)];
+                text += piece;
+            }
+            return text;
+        };
+        const auto flipCase = [&](std::string text) {
+            for (char& c : text)
+            {
+                if (Inspector::TextSearch::IsAsciiLetter(static_cast<unsigned char>(c)) && rng() % 2 == 0)
+                {
+                    c = static_cast<char>(c ^ 0x20);
+                }
+            }
+            // Swap the case of the two-byte letters whose pairs differ in the last byte only.
+            for (size_t i = 0; i + 1 < text.size(); ++i)
+            {
+                const auto lead = static_cast<unsigned char>(text[i]);
+                const auto next = static_cast<unsigned char>(text[i + 1]);
+                if (lead == 0xC3 && (next == 0xA9 || next == 0x89) && rng() % 2 == 0)
+                {
+                    text[i + 1] = static_cast<char>(next ^ 0x20);
+                }
+                else if (lead == 0xD0 && (next == 0xB6 || next == 0x96) && rng() % 2 == 0)
+                {
+                    text[i + 1] = static_cast<char>(next ^ 0x20);
+                }
+            }
+            return text;
+        };
+
+        size_t mismatches = 0;
+        for (size_t trial = 0; trial < trials; ++trial)
+        {
+            const std::string haystack = randomText(rng() % 120, true);
+            std::string needle;
+            if (!haystack.empty() && rng() % 3 != 0)
+            {
+                // A slice starting on a code point boundary, so it can actually be found.
+                size_t start = rng() % haystack.size();
+                while (start > 0 && (static_cast<unsigned char>(haystack[start]) & 0xC0) == 0x80)
+                {
+                    --start;
+                }
+                size_t end = std::min(haystack.size(), start + 1 + rng() % 40);
+                while (end < haystack.size() && (static_cast<unsigned char>(haystack[end]) & 0xC0) == 0x80)
+                {
+                    ++end;
+                }
+                needle = flipCase(haystack.substr(start, end - start));
+            }
+            else
+            {
+                needle = randomText(1 + rng() % 6, false);
+            }
+            // Needles start on a whole character; a stray continuation byte only ever appears in haystacks.
+            if (!needle.empty() && (static_cast<unsigned char>(needle[0]) & 0xC0) == 0x80)
+            {
+                continue;
+            }
+            const char* expected = ReferenceFind(haystack, needle);
+            const Inspector::TextSearch::FoldedNeedle prepared(needle.data(), needle.size());
+            mismatches += Inspector::TextSearch::FindCaseInsensitive(haystack.data(), haystack.size(), needle.data(), needle.size()) != expected;
+            mismatches += prepared.Find(haystack.data(), haystack.size()) != expected;
+        }
+        return mismatches;
+    }
+
+    void RunSearchBenchmark(size_t windowCount)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 42);
+        std::vector<const std::string*> corpus;
+        corpus.reserve(windowCount * 2);
+        for (const auto& entry : snapshot.processes)
+        {
+            for (const auto& window : entry.windows)
+            {
+                corpus.push_back(&window.titleUtf8);
+                corpus.push_back(&window.classNameUtf8);
+            }
+        }
+
+        std::printf("\nSearch kernel over %zu titles/classes (ns per string)\n", corpus.size());
+        std::printf("%-22s %10s %10s %8s\n", "needle", "kernel", "naive", "matches");
+        // Filters prepare their needle once and test it against every window, and so does this loop.
+        static const char* const needles[] = {"e", "code", "visual studio", "chrome_widgetwin", "zzz-not-there", "\xd0\xbf\xd1\x80\xd0\xbe\xd0\xb2\xd0\xbe\xd0\xb4"};
+        for (const char* needle : needles)
+        {
+            const size_t needleLength = std::strlen(needle);
+            size_t matches = 0;
+            const auto kernelStart = Clock::now();
+            for (int repeat = 0; repeat < 5; ++repeat)
+            {
+                const Inspector::TextSearch::FoldedNeedle prepared(needle, needleLength);
+                for (const std::string* text : corpus)
+                {
+                    matches += prepared.Find(text->data(), text->size()) != nullptr;
+                }
+            }
+            const auto kernelEnd = Clock::now();
+            size_t naiveMatches = 0;
+            for (int repeat = 0; repeat < 5; ++repeat)
+            {
+                for (const std::string* text : corpus)
+                {
+                    naiveMatches += NaiveContains(*text, needle, needleLength);
+                }
+            }
+            const auto naiveEnd = Clock::now();
+
+            const double perString = 1.0e6 / static_cast<double>(corpus.size() * 5);
+            std::printf("%-22s %10.1f %10.1f %8zu%s\n", needle[0] & 0x80 ? "<cyrillic>" : needle,
+                        ElapsedMs(kernelStart, kernelEnd) * perString, ElapsedMs(kernelEnd, naiveEnd) * perString, matches / 5,
+                        MismatchLabel((needle[0] & 0x80) == 0 && matches != naiveMatches));
+        }
+
+        constexpr size_t kTrials = 50000;
+        const size_t mismatches = CountSearchMismatches(kTrials);
+        std::printf("random needles: %zu of %zu disagree with the reference scan%s\n", mismatches, kTrials, MismatchLabel(mismatches != 0));
+    }
+
+    // Pseudo-word `id` of a 4096-word vocabulary: four to eight letters, common letters more likely.
+    std::wstring SyntheticWord(uint32_t id)
+    {
+        static const wchar_t letters[] = L"etaoinshrdlucmfwypvbgkqjxz";
+        std::mt19937 rng(id);
+        std::wstring word(4 + rng() % 5, L' ');
+        for (wchar_t& letter : word)
+        {
+            letter = letters[std::min(rng() % 26, rng() % 26)];
+        }
+        return word;
+    }
+
+    // Two to five vocabulary words and a number, so trigrams are about as selective as in real titles
+    // (MakeSyntheticSnapshot's templated titles repeat a handful of strings).
+    void RetitleWindow(WindowInfo& window, std::mt19937& rng)
+    {
+        std::wstring title;
+        const uint32_t words = 2 + rng() % 4;
+        for (uint32_t word = 0; word < words; ++word)
+        {
+            title += SyntheticWord(rng() % 4096);
+            title += L' ';
+        }
+        window.title = title + std::to_wstring(rng() % 1000);
+        Inspector::PrepareWindowStrings(window);
+        window.hashes = Inspector::HashWindowFields(window);
+    }
+
+    // Exact search with and without the trigram index. "first" is the first Update on the UI thread
+    // (folding every title), "worker" the background build; queries are timed from query text to
+    // ranked results, the way a keystroke is.
+    void RunTrigramBenchmark(size_t windowCount)
+    {
+        InspectorSnapshot snapshot = MakeSyntheticSnapshot(windowCount, 91);
+        std::mt19937 rng(23);
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                RetitleWindow(window, rng);
+            }
+        }
+        Inspector::SpatialIndex index;
+        Inspector::SnapshotDiff diff;
+        Inspector::TrigramIndex trigrams;
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 0.0);
+        trigrams.Update(snapshot, index, diff);
+        const double first = trigrams.CurrentStats().updateMilliseconds;
+        trigrams.WaitForBuild();
+        const double worker = trigrams.CurrentStats().buildMilliseconds;
+
+        for (auto& entry : snapshot.processes)
+        {
+            for (auto& window : entry.windows)
+            {
+                if (rng() % 33 == 0)
+                {
+                    RetitleWindow(window, rng);
+                }
+            }
+        }
+        ++snapshot.generation;
+        index.Update(snapshot);
+        diff.Update(snapshot, index, 1.0);
+        trigrams.Update(snapshot, index, diff);
+        const Inspector::TrigramIndex::Stats churn = trigrams.CurrentStats();
+        std::printf("%8zu  %8.2f %8.2f %9.3f  %9zu %7zu %7zu\n", windowCount, first, worker, churn.updateMilliseconds, churn.postings,
+                    churn.buckets, churn.overlay);
+
+        const std::string rare = Inspector::ToUtf8(SyntheticWord(1234));
+        const std::string pair = Inspector::ToUtf8(SyntheticWord(77)) + " " + Inspector::ToUtf8(SyntheticWord(3001));
+        const std::string fragment = Inspector::ToUtf8(SyntheticWord(42)).substr(0, 3);
+        const std::string queries[] = {rare, pair, fragment, "zzq", "ka"};
+        for (const std::string& query : queries)
+        {
+            Inspector::Fuzzy::RankedSearch indexed;
+            Inspector::Fuzzy::RankedSearch scanned;
+            // The first Update of a search also lists the snapshot's windows; keystrokes after that do not.
+            indexed.Update(snapshot, "", true, &trigrams);
+            scanned.Update(snapshot, "", true, nullptr);
+            indexed.Update(snapshot, query.c_str(), true, &trigrams);
+            scanned.Update(snapshot, query.c_str(), true, nullptr);
+            const bool same = indexed.Results().size() == scanned.Results().size();
+            std::printf("          %-24s %8.3f %8.3f  %9zu %7zu%s%s\n", query.c_str(), indexed.LastSearch().milliseconds,
+                        scanned.LastSearch().milliseconds, indexed.LastSearch().candidates, indexed.Results().size(),
+                        indexed.LastSearch().indexed ? "" : "  (not indexed)", MismatchLabel(!same));
+        }
+    }
+
+    // Renders a fixed, search-free frame so the output only depends on the UI code and the rasterizer.
+    int RunScreenshot(RasterTarget& raster, const char* outputPath, const char* goldenPath)
+    {
+        const InspectorSnapshot snapshot = MakeSyntheticSnapshot(200, 7);
+        ImGuiIO& io = ImGui::GetIO();
+        Inspector::gUiState.processFilter.fill('\0');
+        Inspector::gUiState.fuzzyQuery.fill('\0');
+        io.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+
+        // The first frames settle window sizes and upload the font atlas.
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            io.DeltaTime = 1.0f / 60.0f;
+            RecordFrame(snapshot, raster);
+        }
+
+        if (outputPath != nullptr)
+        {
+            if (!raster.framebuffer.WritePpm(outputPath))
+            {
+                std::fprintf(stderr, "Failed to write %s\n", outputPath);
+                return 1;
+            }
+            std::printf("Wrote %dx%d screenshot to %s (%zu triangles)\n", raster.framebuffer.width, raster.framebuffer.height, outputPath,
+                        raster.renderer->LastTriangleCount());
+        }
+
+        if (goldenPath != nullptr)
+        {
+            Inspector::SoftFramebuffer golden;
+            if (!golden.ReadPpm(goldenPath))
+            {
+                std::fprintf(stderr, "Failed to read golden image %s\n", goldenPath);
+                return 1;
+            }
+            const size_t mismatched = Inspector::CountMismatchedPixels(raster.framebuffer, golden, 2);
+            std::printf("Golden %s: %zu mismatched pixels\n", goldenPath, mismatched);
+            return mismatched == 0 ? 0 : 1;
+        }
+        return 0;
+    }
+
+    std::vector<size_t> ParseSizes(const char* text)
+    {
+        std::vector<size_t> sizes;
+        while (text != nullptr && *text != '\0')
+        {
+            char* end = nullptr;
+            const unsigned long long value = std::strtoull(text, &end, 10);
+            if (end == text)
+            {
+                break;
+            }
+            sizes.push_back(static_cast<size_t>(value));
+            text = (*end == ',') ? end + 1 : end;
+        }
+        return sizes;
+    }
+}
+
+namespace Inspector
+{
+    int RunHeadlessBenchmark(int argc, char** argv)
+    {
+        int frames = 120;
+        bool runSearch = true;
+        bool rasterize = false;
+        const char* screenshotPath = nullptr;
+        const char* goldenPath = nullptr;
+        std::vector<size_t> sizes = {1000, 10000, 50000, 100000};
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            {
+                frames = std::max(3, std::atoi(argv[++i]));
+            }
+            else if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc)
+            {
+                sizes = ParseSizes(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--no-search") == 0)
+            {
+                runSearch = false;
+            }
+            else if (std::strcmp(argv[i], "--raster") == 0)
+            {
+                rasterize = true;
+            }
+            else if (std::strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc)
+            {
+                screenshotPath = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+            {
+                goldenPath = argv[++i];
+            }
+        }
+
+        InstallImGuiAllocationCounter();
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2(1600.0f, 900.0f);
+        io.DeltaTime = 1.0f / 60.0f;
+        io.BackendFlags |= ImGuiBackendFlags_HasMouseCursors | ImGuiBackendFlags_RendererHasTextures | ImGuiBackendFlags_RendererHasVtxOffset;
+        ImGui::StyleColorsDark();
+
+        // The software renderer is the texture backend either way; it only rasterizes when asked to.
+        SoftRenderer renderer;
+        RasterTarget raster;
+        if (screenshotPath != nullptr || goldenPath != nullptr)
+        {
+            raster.renderer = &renderer;
+            const int result = RunScreenshot(raster, screenshotPath, goldenPath);
+            ImGui::DestroyContext();
+            return result;
+        }
+        raster.renderer = rasterize ? &renderer : nullptr;
+
+        std::printf("Headless RenderInspectorUi benchmark: %d frames per size, display %.0fx%.0f\n", frames, io.DisplaySize.x, io.DisplaySize.y);
+        std::printf("%8s  %-7s %6s  %8s %8s %8s %8s %9s  %9s %9s  %8s %8s\n",
+                    "windows", "phase", "frames", "p50 ms", "p99 ms", "max ms", "ui ms", "raster ms", "vertices", "indices", "im-alloc", "new");
+        for (const size_t size : sizes)
+        {
+            RunUiBenchmark(size, frames, raster);
+            RunSteadyStateCheck(size, frames, raster);
+        }
+        for (const size_t size : sizes)
+        {
+            RunMinimapBenchmark(size, frames, raster);
+        }
+        RunTimelineBenchmark(sizes.empty() ? 1000 : std::min<size_t>(sizes.front(), 2000), frames, raster);
+
+        RunTreeBenchmark(frames, raster);
+        RunPacerCheck();
+
+        std::printf("\nSpatial index (times in ms for build/update, us per query)\n");
+        std::printf("%8s  %8s %8s%-9s  %8s %8s %8s %10s  %8s %8s\n", "windows", "build", "update", "", "point", "topmost", "region", "linear pt", "pt hits", "rc hits");
+        for (const size_t size : sizes)
+        {
+            RunSpatialBenchmark(size);
+        }
+
+        std::printf("\nOcclusion (index update + visible-area computation, ms / windows recomputed)\n");
+        std::printf("%8s  %8s  %9s %6s  %9s %6s  %9s %6s  %9s %6s %8s\n", "windows", "visible", "full", "", "8 moved", "", "activate", "", "tiled 8", "",
+                    "covered");
+        for (const size_t size : sizes)
+        {
+            RunOcclusionBenchmark(size);
+        }
+
+        std::printf("\nSnapshot diff (ms, excluding the spatial index update)\n");
+        std::printf("%8s  %9s %9s %9s  %6s %6s %6s\n", "windows", "baseline", "unchanged", "3% churn", "added", "gone", "changed");
+        for (const size_t size : sizes)
+        {
+            RunDiffBenchmark(size);
+        }
+
+        std::printf("\nWindow stats (ms to apply the diff, excluding index and diff updates)\n");
+        std::printf("%8s  %9s %9s %9s %9s  %6s %6s\n", "windows", "baseline", "unchanged", "3% churn", "replaced", "procs", "classes");
+        for (const size_t size : sizes)
+        {
+            RunStatsBenchmark(size);
+        }
+
+        std::printf("\nWatch list poll (us per poll, 400 polls; new = allocations over all unchanged polls)\n");
+        std::printf("%8s  %7s  %8s %8s  %7s %8s\n", "windows", "watched", "p50 us", "p99 us", "changes", "new");
+        for (const size_t size : sizes)
+        {
+            RunWatchBenchmark(size, 12);
+            RunWatchBenchmark(size, 100);
+        }
+
+        std::printf("\nProcess refresh (ms; splice one process vs. rebuilding every window's strings)\n");
+        std::printf("%8s  %8s  %9s %9s  %9s  %6s %6s\n", "windows", "process", "splice", "full", "index+diff", "changed", "gone");
+        for (const size_t size : sizes)
+        {
+            RunProcessRefreshBenchmark(size);
+        }
+
+        std::printf("\nGrouping build (ms per mode)\n");
+        std::printf("%8s  %8s %8s", "windows", "process", "extract");
+        for (size_t mode = 1; mode < Inspector::kGroupingModeCount; ++mode)
+        {
+            std::printf(" %8s", Inspector::GroupingModeName(static_cast<Inspector::GroupingMode>(mode)));
+        }
+        std::printf("\n");
+        for (const size_t size : sizes)
+        {
+            RunGroupingBenchmark(size);
+        }
+
+        std::printf("\nAttribute bitsets (build ms; filter rows: evaluate us, matches, grouped rows from bitsets ms, from WindowInfo ms, rows)\n");
+        std::printf("%8s  %8s\n", "windows", "build");
+        for (const size_t size : sizes)
+        {
+            RunAttributeBenchmark(size);
+        }
+
+        std::printf("\nProcess metadata (sync ms, us per request; queries for the first refresh and the 20 after, replaced processes, entries, bytes)\n");
+        std::printf("%8s  %7s  %7s %8s  %7s %7s %8s  %7s %7s\n", "windows", "procs", "sync", "request", "first", "later", "replaced", "entries", "bytes");
+        for (const size_t size : sizes)
+        {
+            RunProcessMetadataBenchmark(size);
+        }
+
+        std::printf("\nIdentities (ms to assign; new window ids under 3%% churn, ids handed out; ms to read per-window state by id and by handle)\n");
+        std::printf("%8s  %8s %8s %8s %8s  %7s %8s  %8s %8s\n", "windows", "first", "refresh", "carried", "churn", "new", "ids", "by id", "by hwnd");
+        for (const size_t size : sizes)
+        {
+            RunIdentityBenchmark(size);
+        }
+
+        std::printf("\nSnapshot comparison (ms for all three joins and the aligned rows)\n");
+        std::printf("%8s  %9s %9s  %7s %7s %7s  %7s\n", "windows", "compare", "rows", "added", "removed", "changed", "by title");
+        for (const size_t size : sizes)
+        {
+            RunCompareBenchmark(size);
+        }
+
+        std::printf("\nTrigram index (ms; query rows: indexed, full scan, windows scored, matches)\n");
+        std::printf("%8s  %8s %8s %9s  %9s %7s %7s\n", "windows", "first", "worker", "3% churn", "postings", "buckets", "overlay");
+        for (const size_t size : sizes)
+        {
+            RunTrigramBenchmark(size);
+        }
+
+        if (runSearch)
+        {
+            RunSearchBenchmark(sizes.empty() ? 100000 : sizes.back());
+        }
+
+        ImGui::DestroyContext();
+        if (gMismatchCount != 0)
+        {
+            std::fprintf(stderr, "%zu self-checks failed (rows marked MISMATCH)\n", gMismatchCount);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#if defined(INSPECTOR_BENCH_MAIN)
+int main(int argc, char** argv)
+{
+    return Inspector::RunHeadlessBenchmark(argc, argv);
+}
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace Inspector
+{
+    // Headless UI benchmark: drives RenderInspectorUi with synthetic snapshots and no platform or
+    // renderer backend. Reachable as "WindowInspector.exe --bench" or standalone (INSPECTOR_BENCH_MAIN).
+    int RunHeadlessBenchmark(int argc, char** argv);
+}
@@ -0,0 +1,317 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+#include "imgui/imgui.h"
+#include "snapshot_compare.hpp"
+
+namespace Inspector
+{
+    // Window over a SnapshotComparer: pick two of the live snapshot, the one the last full refresh
+    // replaced and snapshots kept by hand, compare them on the worker and page through the aligned rows
+    // side by side with a clipped table. Added rows are green, removed rows red, and the cells that
+    // differ between paired windows are tinted on both sides.
+    class ComparePanel
+    {
+    public:
+        static constexpr size_t kKeptLimit = 8;
+
+        bool visible = false;
+
+        // True while a comparison runs, so the UI keeps drawing its progress and picks up the result.
+        bool Pending() const
+        {
+            return visible && mComparer.Running();
+        }
+
+        // Called with the snapshot a full refresh is about to replace; moved, not copied.
+        void KeepPrevious(InspectorSnapshot&& snapshot)
+        {
+            if (snapshot.generation != 0)
+            {
+                mPrevious = std::make_shared<const InspectorSnapshot>(std::move(snapshot));
+            }
+        }
+
+        // Clicking a row selects its window (the right one when both exist) in `selected`.
+        void Render(const InspectorSnapshot& live, HWND& selected)
+        {
+            if (!visible)
+            {
+                return;
+            }
+            if (mComparer.Poll())
+            {
+                mRowsDirty = true;
+            }
+
+            ImGui::SetNextWindowSize(ImVec2(1100.0f, 560.0f), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Compare snapshots", &visible, ImGuiWindowFlags_NoSavedSettings))
+            {
+                ImGui::End();
+                return;
+            }
+
+            ImGui::BeginDisabled(live.generation == 0);
+            if (ImGui::Button("Keep live snapshot"))
+            {
+                if (mKept.size() >= kKeptLimit)
+                {
+                    mKept.erase(mKept.begin());
+                    mLeft = std::max(0, mLeft - (mLeft >= kFirstKept ? 1 : 0));
+                    mRight = std::max(0, mRight - (mRight >= kFirstKept ? 1 : 0));
+                }
+                mKept.push_back(std::make_shared<const InspectorSnapshot>(live));
+            }
+            ImGui::EndDisabled();
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Copies the live snapshot so it can be compared after later refreshes (up to %zu are kept).", kKeptLimit);
+            }
+
+            ImGui::SameLine();
+            SourceCombo("Left", mLeft, live);
+            ImGui::SameLine();
+            SourceCombo("Right", mRight, live);
+            ImGui::SameLine();
+            const bool running = mComparer.Running();
+            ImGui::BeginDisabled(running || !Available(mLeft, live) || !Available(mRight, live));
+            if (ImGui::Button("Compare"))
+            {
+                mComparer.Start(Resolve(mLeft, live), Resolve(mRight, live));
+            }
+            ImGui::EndDisabled();
+            if (running)
+            {
+                ImGui::SameLine();
+                ImGui::ProgressBar(mComparer.Progress(), ImVec2(160.0f, 0.0f));
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Cancel"))
+                {
+                    mComparer.Cancel();
+                }
+            }
+
+            const SnapshotComparison* comparison = mComparer.Result();
+            if (comparison == nullptr)
+            {
+                ImGui::TextDisabled("Keep a snapshot or refresh with this panel open, then compare two snapshots.");
+                ImGui::End();
+                return;
+            }
+
+            const auto& kinds = comparison->kinds;
+            ImGui::Text("%s vs %s | +%zu -%zu ~%zu =%zu", comparison->left->timestampLabel.c_str(), comparison->right->timestampLabel.c_str(),
+                        kinds[static_cast<size_t>(CompareKind::Added)], kinds[static_cast<size_t>(CompareKind::Removed)],
+                        kinds[static_cast<size_t>(CompareKind::Changed)], kinds[static_cast<size_t>(CompareKind::Same)]);
+            if (ImGui::IsItemHovered())
+            {
+                const auto& matches = comparison->matches;
+                ImGui::SetTooltip("Paired by handle: %zu, by (pid, class, title): %zu, by (pid, class): %zu. Compared in %.1f ms.",
+                                  matches[static_cast<size_t>(CompareMatch::Handle)], matches[static_cast<size_t>(CompareMatch::Title)],
+                                  matches[static_cast<size_t>(CompareMatch::Class)], comparison->milliseconds);
+            }
+            ImGui::SameLine();
+            if (ImGui::Checkbox("Show unchanged", &mShowSame))
+            {
+                mRowsDirty = true;
+            }
+            if (mRowsDirty)
+            {
+                CollectRows(*comparison);
+            }
+            RenderRows(*comparison, selected);
+            ImGui::End();
+        }
+
+    private:
+        static constexpr int kLive = 0;
+        static constexpr int kPrevious = 1;
+        static constexpr int kFirstKept = 2;
+        static constexpr int kSideColumns = 6;
+
+        bool Available(int source, const InspectorSnapshot& live) const
+        {
+            return source == kLive ? live.generation != 0 : source == kPrevious ? mPrevious != nullptr : source - kFirstKept < static_cast<int>(mKept.size());
+        }
+
+        // The live snapshot is copied, since the UI replaces it while the worker reads.
+        std::shared_ptr<const InspectorSnapshot> Resolve(int source, const InspectorSnapshot& live) const
+        {
+            if (source == kLive)
+            {
+                return std::make_shared<const InspectorSnapshot>(live);
+            }
+            return source == kPrevious ? mPrevious : mKept[static_cast<size_t>(source - kFirstKept)];
+        }
+
+        void FormatSource(int source, const InspectorSnapshot& live, char* buffer, size_t size) const
+        {
+            const InspectorSnapshot* snapshot = source == kLive ? &live : Available(source, live) ? Resolve(source, live).get() : nullptr;
+            const char* name = source == kLive ? "Live" : source == kPrevious ? "Previous" : "Kept";
+            if (snapshot == nullptr)
+            {
+                std::snprintf(buffer, size, "%s (none)", name);
+            }
+            else if (source >= kFirstKept)
+            {
+                std::snprintf(buffer, size, "%s #%d (%s, %zu windows)", name, source - kFirstKept + 1, snapshot->timestampLabel.c_str(), snapshot->totalWindowCount);
+            }
+            else
+            {
+                std::snprintf(buffer, size, "%s (%s, %zu windows)", name, snapshot->timestampLabel.c_str(), snapshot->totalWindowCount);
+            }
+        }
+
+        void SourceCombo(const char* label, int& source, const InspectorSnapshot& live)
+        {
+            char preview[128];
+            FormatSource(source, live, preview, sizeof(preview));
+            ImGui::SetNextItemWidth(280.0f);
+            if (ImGui::BeginCombo(label, preview))
+            {
+                for (int option = 0; option < kFirstKept + static_cast<int>(mKept.size()); ++option)
+                {
+                    char name[128];
+                    FormatSource(option, live, name, sizeof(name));
+                    ImGui::PushID(option);
+                    if (ImGui::Selectable(name, option == source))
+                    {
+                        source = option;
+                    }
+                    ImGui::PopID();
+                }
+                ImGui::EndCombo();
+            }
+        }
+
+        void CollectRows(const SnapshotComparison& comparison)
+        {
+            mRows.clear();
+            for (uint32_t row = 0; row < comparison.rows.size(); ++row)
+            {
+                if (mShowSame || comparison.rows[row].kind != CompareKind::Same)
+                {
+                    mRows.push_back(row);
+                }
+            }
+            mRowsDirty = false;
+        }
+
+        static void HighlightCell(const CompareRow& row, uint8_t field)
+        {
+            if ((row.fields & field) != 0)
+            {
+                ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(0.95f, 0.65f, 0.15f, 0.45f)));
+            }
+        }
+
+        // Cells of one side, starting at column `first`; nothing for a missing window.
+        static void RenderSide(const WindowInfo* window, const CompareRow& row, int first)
+        {
+            if (window == nullptr)
+            {
+                return;
+            }
+            ImGui::TableSetColumnIndex(first);
+            if (row.match != CompareMatch::Handle && row.match != CompareMatch::None)
+            {
+                ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(0.95f, 0.65f, 0.15f, 0.45f)));
+            }
+            ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window->handle)));
+            ImGui::TableSetColumnIndex(first + 1);
+            HighlightCell(row, ChangedField::Title);
+            ImGui::TextUnformatted(window->titleUtf8.c_str());
+            ImGui::TableSetColumnIndex(first + 2);
+            HighlightCell(row, ChangedField::Class);
+            ImGui::TextUnformatted(window->classNameUtf8.c_str());
+            ImGui::TableSetColumnIndex(first + 3);
+            HighlightCell(row, ChangedField::State);
+            ImGui::Text("PID %lu TID %lu %s", static_cast<unsigned long>(window->pid), static_cast<unsigned long>(window->threadId), window->visible ? "V" : "H");
+            ImGui::TableSetColumnIndex(first + 4);
+            HighlightCell(row, ChangedField::Styles);
+            ImGui::Text("%08llX %08llX", static_cast<unsigned long long>(static_cast<uint32_t>(window->style)),
+                        static_cast<unsigned long long>(static_cast<uint32_t>(window->exStyle)));
+            ImGui::TableSetColumnIndex(first + 5);
+            HighlightCell(row, ChangedField::Bounds);
+            ImGui::Text("(%ld,%ld)-(%ld,%ld)", static_cast<long>(window->bounds.left), static_cast<long>(window->bounds.top),
+                        static_cast<long>(window->bounds.right), static_cast<long>(window->bounds.bottom));
+        }
+
+        void RenderRows(const SnapshotComparison& comparison, HWND& selected)
+        {
+            if (mRows.empty())
+            {
+                ImGui::TextDisabled("The snapshots hold the same windows.");
+                return;
+            }
+            constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                                                   ImGuiTableFlags_ScrollX | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit;
+            if (!ImGui::BeginTable("##compare", 1 + 2 * kSideColumns, tableFlags))
+            {
+                return;
+            }
+            ImGui::TableSetupScrollFreeze(1, 1);
+            ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed, 16.0f);
+            for (const char* side : {"Left", "Right"})
+            {
+                char name[32];
+                std::snprintf(name, sizeof(name), "%s HWND", side);
+                ImGui::TableSetupColumn(name, ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("Title", ImGuiTableColumnFlags_WidthFixed, 220.0f);
+                ImGui::TableSetupColumn("Class", ImGuiTableColumnFlags_WidthFixed, 150.0f);
+                ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed, 160.0f);
+                ImGui::TableSetupColumn("Styles", ImGuiTableColumnFlags_WidthFixed, 130.0f);
+                ImGui::TableSetupColumn("Bounds", ImGuiTableColumnFlags_WidthFixed, 170.0f);
+            }
+            ImGui::TableHeadersRow();
+
+            static const char* const kKindMarks[kCompareKindCount] = {"=", "~", "+", "-"};
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(mRows.size()));
+            while (clipper.Step())
+            {
+                for (int index = clipper.DisplayStart; index < clipper.DisplayEnd; ++index)
+                {
+                    const CompareRow& row = comparison.rows[mRows[static_cast<size_t>(index)]];
+                    const WindowInfo* left = comparison.LeftWindow(row);
+                    const WindowInfo* right = comparison.RightWindow(row);
+                    ImGui::TableNextRow();
+                    if (row.kind == CompareKind::Added)
+                    {
+                        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.25f, 0.75f, 0.35f, 0.30f)));
+                    }
+                    else if (row.kind == CompareKind::Removed)
+                    {
+                        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.85f, 0.25f, 0.25f, 0.30f)));
+                    }
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::PushID(index);
+                    const HWND handle = right != nullptr ? right->handle : left->handle;
+                    if (ImGui::Selectable(kKindMarks[static_cast<size_t>(row.kind)], handle == selected,
+                                          ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap))
+                    {
+                        selected = handle;
+                    }
+                    ImGui::PopID();
+                    RenderSide(left, row, 1);
+                    RenderSide(right, row, 1 + kSideColumns);
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        std::shared_ptr<const InspectorSnapshot> mPrevious;
+        std::vector<std::shared_ptr<const InspectorSnapshot>> mKept;
+        int mLeft = kPrevious;
+        int mRight = kLive;
+        SnapshotComparer mComparer;
+        bool mShowSame = false;
+        bool mRowsDirty = true;
+        // Indices into the comparison's rows that pass the "Show unchanged" toggle.
+        std::vector<uint32_t> mRows;
+    };
+}
@@ -0,0 +1,576 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "snapshot.hpp"
+#include "text_search.hpp"
+#include "trigram_index.hpp"
+
+// fzf-style fuzzy matching (v1: greedy forward scan, backward shrink, bonus scoring)
+// over process name, window title and class name, ranked across the whole snapshot.
+// Exact mode (fzf -e) matches each term as a case-insensitive substring instead, which
+// a TrigramIndex can narrow down to a few candidates before anything is scored.
+namespace Inspector::Fuzzy
+{
+    constexpr int kScoreMatch = 16;
+    constexpr int kScoreGapStart = -3;
+    constexpr int kScoreGapExtension = -1;
+    constexpr int kBonusBoundary = kScoreMatch / 2;
+    constexpr int kBonusCamel = kBonusBoundary + kScoreGapExtension;
+    constexpr int kBonusConsecutive = -(kScoreGapStart + kScoreGapExtension);
+    constexpr int kBonusFirstCharMultiplier = 2;
+
+    enum class CharClass : uint8_t
+    {
+        NonWord,
+        Delimiter,
+        Lower,
+        Upper,
+        Digit
+    };
+
+    enum class Field : uint8_t
+    {
+        Process,
+        Title,
+        Class,
+        Count
+    };
+
+    // One matched character: its first byte and its UTF-8 length, so a highlight never splits a sequence.
+    struct Position
+    {
+        int offset = 0;
+        int length = 1;
+    };
+
+    // Folded code point starting at byte `i` of t[0, n); advances `i` past it.
+    inline uint32_t FoldedAt(const unsigned char* t, size_t n, size_t& i)
+    {
+        if (t[i] < 0x80)
+        {
+            return TextSearch::FoldAscii(t[i++]);
+        }
+        const unsigned char* cursor = t + i;
+        const uint32_t cp = TextSearch::FoldCodepoint(TextSearch::DecodeUtf8(cursor, t + n));
+        i = static_cast<size_t>(cursor - t);
+        return cp;
+    }
+
+    // Start of the code point that ends at byte `i` (> 0), as a forward decode would have found it.
+    inline size_t PreviousStart(const unsigned char* t, size_t i)
+    {
+        size_t start = i - 1;
+        if (t[start] < 0x80)
+        {
+            return start;
+        }
+        while (start > 0 && i - start < 4 && (t[start] & 0xC0) == 0x80)
+        {
+            --start;
+        }
+        const unsigned char* cursor = t + start;
+        TextSearch::DecodeUtf8(cursor, t + i);
+        // Stray continuation bytes decode one at a time.
+        return cursor == t + i ? start : i - 1;
+    }
+
+    inline CharClass ClassOf(uint32_t cp)
+    {
+        if (cp >= 0x80)
+        {
+            return TextSearch::FoldCodepoint(cp) != cp ? CharClass::Upper : CharClass::Lower;
+        }
+        const auto c = static_cast<unsigned char>(cp);
+        if (c >= 'a' && c <= 'z')
+        {
+            return CharClass::Lower;
+        }
+        if (c >= 'A' && c <= 'Z')
+        {
+            return CharClass::Upper;
+        }
+        if (c >= '0' && c <= '9')
+        {
+            return CharClass::Digit;
+        }
+        switch (c)
+        {
+        case '/':
+        case '\\':
+        case '.':
+        case ',':
+        case ':':
+        case ';':
+        case '_':
+        case '-':
+        case '|':
+            return CharClass::Delimiter;
+        default:
+            return CharClass::NonWord;
+        }
+    }
+
+    inline int BonusFor(CharClass previous, CharClass current)
+    {
+        const bool currentIsWord = current != CharClass::NonWord && current != CharClass::Delimiter;
+        if (!currentIsWord)
+        {
+            return 0;
+        }
+        if (previous == CharClass::NonWord || previous == CharClass::Delimiter)
+        {
+            return kBonusBoundary;
+        }
+        if ((previous == CharClass::Lower && current == CharClass::Upper) ||
+            (previous != CharClass::Digit && current == CharClass::Digit))
+        {
+            return kBonusCamel;
+        }
+        return 0;
+    }
+
+    // Scores the span text[start, end), which starts and ends on code point boundaries, one code point at
+    // a time; `matched(folded)` tells whether the next code point is part of the pattern. Matched
+    // characters are appended to `positions` when it is non-null.
+    template <typename Matched>
+    int ScoreSpan(const unsigned char* t, size_t start, size_t end, Matched&& matched, std::vector<Position>* positions)
+    {
+        int total = 0;
+        int consecutive = 0;
+        int firstBonus = 0;
+        bool inGap = false;
+        bool first = true;
+        CharClass previous = CharClass::Delimiter;
+        if (start > 0)
+        {
+            const unsigned char* before = t + PreviousStart(t, start);
+            previous = ClassOf(TextSearch::DecodeUtf8(before, t + start));
+        }
+        for (size_t i = start; i < end;)
+        {
+            const size_t at = i;
+            const unsigned char* cursor = t + i;
+            const uint32_t cp = TextSearch::DecodeUtf8(cursor, t + end);
+            i = static_cast<size_t>(cursor - t);
+            const CharClass current = ClassOf(cp);
+            if (matched(TextSearch::FoldCodepoint(cp)))
+            {
+                if (positions != nullptr)
+                {
+                    positions->push_back(Position{static_cast<int>(at), static_cast<int>(i - at)});
+                }
+
+                int bonus = BonusFor(previous, current);
+                if (consecutive == 0)
+                {
+                    firstBonus = bonus;
+                }
+                else
+                {
+                    if (bonus >= kBonusBoundary && bonus > firstBonus)
+                    {
+                        firstBonus = bonus;
+                    }
+                    bonus = std::max({bonus, firstBonus, kBonusConsecutive});
+                }
+
+                total += kScoreMatch + (first ? bonus * kBonusFirstCharMultiplier : bonus);
+                inGap = false;
+                first = false;
+                ++consecutive;
+            }
+            else
+            {
+                total += inGap ? kScoreGapExtension : kScoreGapStart;
+                inGap = true;
+                consecutive = 0;
+                firstBonus = 0;
+            }
+            previous = current;
+        }
+        return total;
+    }
+
+    // Scores one pattern (already folded) against `text`, comparing case-folded code points. Returns
+    // false when the pattern is not a subsequence. Matched characters are appended to `positions` when
+    // it is non-null.
+    inline bool MatchTerm(const std::string& text, const std::string& pattern, int& score, std::vector<Position>* positions = nullptr)
+    {
+        const auto* t = reinterpret_cast<const unsigned char*>(text.data());
+        const auto* p = reinterpret_cast<const unsigned char*>(pattern.data());
+        const size_t n = text.size();
+        const size_t m = pattern.size();
+        if (m == 0)
+        {
+            score = 0;
+            return true;
+        }
+        if (m > n)
+        {
+            return false;
+        }
+
+        size_t patternNext = 0;
+        uint32_t wanted = FoldedAt(p, m, patternNext);
+        size_t end = 0;
+        for (size_t i = 0; i < n;)
+        {
+            if (FoldedAt(t, n, i) == wanted)
+            {
+                if (patternNext == m)
+                {
+                    end = i;
+                    break;
+                }
+                wanted = FoldedAt(p, m, patternNext);
+            }
+        }
+        if (end == 0)
+        {
+            return false;
+        }
+
+        // Walk back from the end to find the shortest window that still contains the pattern.
+        size_t start = end;
+        size_t patternStart = PreviousStart(p, m);
+        patternNext = patternStart;
+        wanted = FoldedAt(p, m, patternNext);
+        for (size_t i = end; i > 0;)
+        {
+            i = PreviousStart(t, i);
+            size_t next = i;
+            if (FoldedAt(t, n, next) == wanted)
+            {
+                if (patternStart == 0)
+                {
+                    start = i;
+                    break;
+                }
+                patternStart = PreviousStart(p, patternStart);
+                patternNext = patternStart;
+                wanted = FoldedAt(p, m, patternNext);
+            }
+        }
+
+        patternNext = 0;
+        score = ScoreSpan(t, start, end, [&](uint32_t folded) {
+            if (patternNext >= m)
+            {
+                return false;
+            }
+            size_t next = patternNext;
+            if (FoldedAt(p, m, next) != folded)
+            {
+                return false;
+            }
+            patternNext = next;
+            return true;
+        }, positions);
+        return true;
+    }
+
+    // Scores the first case-insensitive occurrence of `pattern` in `text` as one consecutive run.
+    // Returns false when `text` does not contain it.
+    inline bool MatchExact(const std::string& text, const TextSearch::FoldedNeedle& pattern, int& score, std::vector<Position>* positions = nullptr)
+    {
+        const char* found = pattern.Find(text.data(), text.size());
+        if (found == nullptr)
+        {
+            return false;
+        }
+        // Case folding keeps UTF-8 lengths, so the occurrence is as long as the pattern.
+        const size_t start = static_cast<size_t>(found - text.data());
+        const size_t end = std::min(text.size(), start + pattern.Length());
+        score = ScoreSpan(reinterpret_cast<const unsigned char*>(text.data()), start, end, [](uint32_t) { return true; }, positions);
+        return true;
+    }
+
+    inline bool MatchExact(const std::string& text, const std::string& pattern, int& score, std::vector<Position>* positions = nullptr)
+    {
+        return MatchExact(text, TextSearch::FoldedNeedle(pattern.data(), pattern.size()), score, positions);
+    }
+
+    // Whitespace-separated terms, folded like FindCaseInsensitive folds. Every term has to match at least
+    // one field.
+    inline std::vector<std::string> SplitQuery(const char* query)
+    {
+        std::vector<std::string> terms;
+        for (const char* c = query; c != nullptr && *c != '\0';)
+        {
+            if (*c == ' ' || *c == '\t')
+            {
+                ++c;
+                continue;
+            }
+            const char* begin = c;
+            while (*c != '\0' && *c != ' ' && *c != '\t')
+            {
+                ++c;
+            }
+            terms.emplace_back();
+            TextSearch::AppendFolded(terms.back(), begin, static_cast<size_t>(c - begin));
+        }
+        return terms;
+    }
+
+    inline const std::string& FieldText(const ProcessWindows& entry, const WindowInfo& window, Field field)
+    {
+        switch (field)
+        {
+        case Field::Process:
+            return entry.process.nameUtf8;
+        case Field::Class:
+            return window.classNameUtf8;
+        default:
+            return window.titleUtf8;
+        }
+    }
+
+    struct Result
+    {
+        uint32_t entry = 0;
+        int score = 0;
+    };
+
+    inline bool MatchField(const std::string& text, const std::string& term, bool exact, int& score, std::vector<Position>* positions = nullptr)
+    {
+        return exact ? MatchExact(text, term, score, positions) : MatchTerm(text, term, score, positions);
+    }
+
+    class RankedSearch
+    {
+    public:
+        struct SearchStats
+        {
+            // Windows scored by the last search.
+            size_t candidates = 0;
+            double milliseconds = 0.0;
+            // The candidates came from the trigram index.
+            bool indexed = false;
+        };
+
+        // Re-ranks when the snapshot, query or mode changed. Extending the previous query only rescans
+        // the previous matches, since adding characters or terms can only shrink the match set. In exact
+        // mode, `index` (updated for `snapshot`) supplies the candidates whenever some term is at least
+        // three bytes long and it offers fewer of them.
+        void Update(const InspectorSnapshot& snapshot, const char* query, bool exact = false, TrigramIndex* index = nullptr)
+        {
+            if (snapshot.generation != mGeneration)
+            {
+                RebuildEntries(snapshot);
+                mQuery.clear();
+                mResults.clear();
+                mHasResults = false;
+            }
+
+            if (mHasResults && mQuery == query && mExact == exact)
+            {
+                return;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const std::string next(query);
+            const bool narrowing = mHasResults && mExact == exact && !mQuery.empty() && next.size() > mQuery.size() &&
+                                   next.compare(0, mQuery.size(), mQuery) == 0;
+            mQuery = next;
+            mExact = exact;
+            mTerms = SplitQuery(query);
+            mNeedles.resize(mTerms.size());
+            for (size_t term = 0; term < mTerms.size(); ++term)
+            {
+                mNeedles[term].Reset(mTerms[term].data(), mTerms[term].size());
+            }
+
+            mLastSearch.indexed = exact && index != nullptr && index->Candidates(snapshot, mTerms, mIndexed) &&
+                                  (!narrowing || mIndexed.size() < mResults.size());
+            if (mLastSearch.indexed)
+            {
+                mCandidates.resize(mIndexed.size());
+                std::transform(mIndexed.begin(), mIndexed.end(), mCandidates.begin(),
+                               [this](const WindowRef& ref) { return mProcessOffsets[ref.process] + ref.window; });
+            }
+            else if (narrowing)
+            {
+                mCandidates.resize(mResults.size());
+                std::transform(mResults.begin(), mResults.end(), mCandidates.begin(), [](const Result& result) { return result.entry; });
+            }
+            else
+            {
+                mCandidates.resize(mEntries.size());
+                for (uint32_t i = 0; i < mCandidates.size(); ++i)
+                {
+                    mCandidates[i] = i;
+                }
+            }
+
+            ScoreCandidates(snapshot);
+            mHasResults = true;
+            mLastSearch.candidates = mCandidates.size();
+            mLastSearch.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        const std::vector<Result>& Results() const
+        {
+            return mResults;
+        }
+
+        const std::vector<std::string>& Terms() const
+        {
+            return mTerms;
+        }
+
+        bool Exact() const
+        {
+            return mExact;
+        }
+
+        const SearchStats& LastSearch() const
+        {
+            return mLastSearch;
+        }
+
+        const WindowRef& Entry(uint32_t index) const
+        {
+            return mEntries[index];
+        }
+
+        size_t EntryCount() const
+        {
+            return mEntries.size();
+        }
+
+        // Every matched character in `field`, sorted by offset and unique. Only called for rows that are
+        // actually on screen.
+        void CollectPositions(const InspectorSnapshot& snapshot, uint32_t entry, Field field, std::vector<Position>& positions) const
+        {
+            positions.clear();
+            const WindowRef& ref = mEntries[entry];
+            const auto& process = snapshot.processes[ref.process];
+            const std::string& text = FieldText(process, process.windows[ref.window], field);
+            for (const auto& term : mTerms)
+            {
+                int score = 0;
+                MatchField(text, term, mExact, score, &positions);
+            }
+            std::sort(positions.begin(), positions.end(), [](const Position& a, const Position& b) { return a.offset < b.offset; });
+            positions.erase(std::unique(positions.begin(), positions.end(), [](const Position& a, const Position& b) { return a.offset == b.offset; }),
+                            positions.end());
+        }
+
+    private:
+        static constexpr size_t kParallelThreshold = 8192;
+
+        void RebuildEntries(const InspectorSnapshot& snapshot)
+        {
+            mGeneration = snapshot.generation;
+            mEntries.clear();
+            mEntries.reserve(snapshot.totalWindowCount);
+            mProcessOffsets.resize(snapshot.processes.size());
+            for (uint32_t p = 0; p < snapshot.processes.size(); ++p)
+            {
+                mProcessOffsets[p] = static_cast<uint32_t>(mEntries.size());
+                for (uint32_t w = 0; w < snapshot.processes[p].windows.size(); ++w)
+                {
+                    mEntries.push_back(WindowRef{p, w});
+                }
+            }
+        }
+
+        bool ScoreEntry(const InspectorSnapshot& snapshot, uint32_t entry, int& score) const
+        {
+            const WindowRef& ref = mEntries[entry];
+            const auto& process = snapshot.processes[ref.process];
+            const auto& window = process.windows[ref.window];
+            int total = 0;
+            for (size_t term = 0; term < mTerms.size(); ++term)
+            {
+                int best = 0;
+                bool matched = false;
+                for (int field = 0; field < static_cast<int>(Field::Count); ++field)
+                {
+                    const std::string& text = FieldText(process, window, static_cast<Field>(field));
+                    int fieldScore = 0;
+                    if ((mExact ? MatchExact(text, mNeedles[term], fieldScore) : MatchTerm(text, mTerms[term], fieldScore)) && (!matched || fieldScore > best))
+                    {
+                        best = fieldScore;
+                        matched = true;
+                    }
+                }
+                if (!matched)
+                {
+                    return false;
+                }
+                total += best;
+            }
+            score = total;
+            return true;
+        }
+
+        void ScoreRange(const InspectorSnapshot& snapshot, size_t begin, size_t end, std::vector<Result>& out) const
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                int score = 0;
+                if (ScoreEntry(snapshot, mCandidates[i], score))
+                {
+                    out.push_back(Result{mCandidates[i], score});
+                }
+            }
+        }
+
+        void ScoreCandidates(const InspectorSnapshot& snapshot)
+        {
+            mResults.clear();
+            const size_t count = mCandidates.size();
+            const size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), (count + kParallelThreshold - 1) / kParallelThreshold);
+            if (workers <= 1)
+            {
+                ScoreRange(snapshot, 0, count, mResults);
+            }
+            else
+            {
+                std::vector<std::vector<Result>> partial(workers);
+                std::vector<std::thread> threads;
+                threads.reserve(workers - 1);
+                const size_t chunk = (count + workers - 1) / workers;
+                for (size_t w = 1; w < workers; ++w)
+                {
+                    threads.emplace_back([&, w]() { ScoreRange(snapshot, w * chunk, std::min(count, (w + 1) * chunk), partial[w]); });
+                }
+                ScoreRange(snapshot, 0, std::min(count, chunk), partial[0]);
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                for (auto& part : partial)
+                {
+                    mResults.insert(mResults.end(), part.begin(), part.end());
+                }
+            }
+
+            std::sort(mResults.begin(), mResults.end(), [](const Result& a, const Result& b) {
+                return a.score != b.score ? a.score > b.score : a.entry < b.entry;
+            });
+        }
+
+        uint64_t mGeneration = 0;
+        bool mHasResults = false;
+        bool mExact = false;
+        std::string mQuery;
+        std::vector<std::string> mTerms;
+        // mTerms prepared for exact mode, pointing into its strings.
+        std::vector<TextSearch::FoldedNeedle> mNeedles;
+        std::vector<WindowRef> mEntries;
+        // Entry of each process's first window, to turn a WindowRef from the index into an entry.
+        std::vector<uint32_t> mProcessOffsets;
+        std::vector<WindowRef> mIndexed;
+        std::vector<uint32_t> mCandidates;
+        std::vector<Result> mResults;
+        SearchStats mLastSearch;
+    };
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <iterator>
+#include <unordered_map>
+
+#include "snapshot.hpp"
+
+namespace Inspector
+{
+    // A process as opposed to a pid: Windows hands a pid out again once its process is gone, but never
+    // together with the same creation time.
+    struct ProcessKey
+    {
+        DWORD pid = 0;
+        uint64_t createTime = 0;
+
+        bool operator==(const ProcessKey& other) const
+        {
+            return pid == other.pid && createTime == other.createTime;
+        }
+    };
+
+    inline ProcessKey KeyOf(const ProcessInfo& process)
+    {
+        return ProcessKey{process.pid, process.createTime};
+    }
+
+    // Hands every process and window a dense 32-bit id that is never reused within the session, written
+    // to ProcessInfo::id and WindowInfo::id. Pids and HWNDs are both recycled, so they only name the same
+    // object while it stays listed from one snapshot to the next:
+    //  - a process keeps its id while its pid is listed with the same creation time and parent;
+    //  - a window keeps its id while its handle is listed under the same process identity.
+    // Anything missing from one snapshot and back in a later one gets a new id, which makes a window's
+    // identity (handle, owning pid, first generation seen). Ids count up from 0 in first-seen order, so
+    // anything keyed on them can index a flat array sized by ProcessIdCount() / WindowIdCount() instead
+    // of hashing handles; the two lookup tables here hold only what the last snapshot listed.
+    class IdentityRegistry
+    {
+    public:
+        struct ProcessIdentity
+        {
+            ProcessKey key;
+            DWORD parentPid = 0;
+            uint64_t firstSeen = 0;
+            uint64_t lastSeen = 0;
+        };
+
+        struct WindowIdentity
+        {
+            HWND handle = nullptr;
+            DWORD pid = 0;
+            uint32_t process = kNoIdentity;
+            uint64_t firstSeen = 0;
+            uint64_t lastSeen = 0;
+        };
+
+        struct Stats
+        {
+            size_t liveProcesses = 0;
+            size_t liveWindows = 0;
+            size_t newProcesses = 0;
+            size_t newWindows = 0;
+            double milliseconds = 0.0;
+        };
+
+        // Stamps every process and window of `snapshot` with its id. Call once for each snapshot produced,
+        // in generation order, including after SpliceProcessWindows; a generation already stamped is
+        // left alone.
+        void Assign(InspectorSnapshot& snapshot)
+        {
+            if (snapshot.generation == mGeneration && mGeneration != 0)
+            {
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t previous = mGeneration;
+            mGeneration = snapshot.generation;
+            mStats.newProcesses = 0;
+            mStats.newWindows = 0;
+
+            mLive.clear();
+            for (auto& entry : snapshot.processes)
+            {
+                ProcessInfo& process = entry.process;
+                process.id = AssignProcess(process, previous);
+                for (WindowInfo& window : entry.windows)
+                {
+                    window.id = AssignWindow(window, process.id, previous);
+                    mLive.push_back(window.id);
+                }
+            }
+
+            // Handles not listed this time are free for whichever window gets them next.
+            for (const uint32_t id : mLiveWindows)
+            {
+                const WindowIdentity& identity = mWindows[id];
+                if (identity.lastSeen != mGeneration)
+                {
+                    if (const auto it = mWindowByHandle.find(identity.handle); it != mWindowByHandle.end() && it->second == id)
+                    {
+                        mWindowByHandle.erase(it);
+                    }
+                }
+            }
+            mLiveWindows.swap(mLive);
+            for (auto it = mProcessByPid.begin(); it != mProcessByPid.end();)
+            {
+                it = mProcesses[it->second].lastSeen != mGeneration ? mProcessByPid.erase(it) : std::next(it);
+            }
+
+            mStats.liveProcesses = mProcessByPid.size();
+            mStats.liveWindows = mLiveWindows.size();
+            mStats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        const ProcessIdentity& Process(uint32_t id) const
+        {
+            return mProcesses[id];
+        }
+
+        const WindowIdentity& Window(uint32_t id) const
+        {
+            return mWindows[id];
+        }
+
+        // Ids handed out so far; every id is below its count.
+        uint32_t ProcessIdCount() const
+        {
+            return static_cast<uint32_t>(mProcesses.size());
+        }
+
+        uint32_t WindowIdCount() const
+        {
+            return static_cast<uint32_t>(mWindows.size());
+        }
+
+        const Stats& CurrentStats() const
+        {
+            return mStats;
+        }
+
+    private:
+        uint32_t AssignProcess(const ProcessInfo& process, uint64_t previous)
+        {
+            auto [it, inserted] = mProcessByPid.try_emplace(process.pid, kNoIdentity);
+            if (!inserted)
+            {
+                ProcessIdentity& identity = mProcesses[it->second];
+                // createTime alone would do, but it is 0 for every process OpenProcess was denied on.
+                if (identity.key == KeyOf(process) && identity.parentPid == process.parentPid && identity.lastSeen == previous)
+                {
+                    identity.lastSeen = mGeneration;
+                    return it->second;
+                }
+            }
+            it->second = static_cast<uint32_t>(mProcesses.size());
+            mProcesses.push_back(ProcessIdentity{KeyOf(process), process.parentPid, mGeneration, mGeneration});
+            ++mStats.newProcesses;
+            return it->second;
+        }
+
+        uint32_t AssignWindow(const WindowInfo& window, uint32_t process, uint64_t previous)
+        {
+            // A window carried over by SpliceProcessWindows, or a copied snapshot, already has its id.
+            if (window.id < mWindows.size())
+            {
+                WindowIdentity& identity = mWindows[window.id];
+                if (identity.handle == window.handle && identity.process == process && identity.lastSeen == previous)
+                {
+                    identity.lastSeen = mGeneration;
+                    return window.id;
+                }
+            }
+            auto [it, inserted] = mWindowByHandle.try_emplace(window.handle, kNoIdentity);
+            if (!inserted)
+            {
+                WindowIdentity& identity = mWindows[it->second];
+                if (identity.process == process && identity.lastSeen == previous)
+                {
+                    identity.lastSeen = mGeneration;
+                    return it->second;
+                }
+            }
+            it->second = static_cast<uint32_t>(mWindows.size());
+            mWindows.push_back(WindowIdentity{window.handle, window.pid, process, mGeneration, mGeneration});
+            ++mStats.newWindows;
+            return it->second;
+        }
+
+        uint64_t mGeneration = 0;
+        std::vector<ProcessIdentity> mProcesses;
+        std::vector<WindowIdentity> mWindows;
+        // Only what the last snapshot listed.
+        std::unordered_map<DWORD, uint32_t> mProcessByPid;
+        std::unordered_map<HWND, uint32_t> mWindowByHandle;
+        std::vector<uint32_t> mLiveWindows;
+        std::vector<uint32_t> mLive;
+        Stats mStats;
+    };
+}
@@ -1,17 +1,27 @@
 #define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 #include <windows.h>
 #include <d3d11.h>
 #include <dxgi.h>
 #include <chrono>
 #include <TlHelp32.h>
+#include <psapi.h>
 #include <vector>
 #include <string>
 #include <unordered_map>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
 
+#include "imgui/imgui_impl_dx11.h"
+#include "imgui/imgui_impl_win32.h"
 #include "ui.hpp"
+#include "render_pacing.hpp"
+#include "bench.hpp"
 
 using Inspector::InspectorSnapshot;
 using Inspector::ProcessInfo;
@@ -24,6 +34,7 @@ using Inspector::WindowInfo;
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "psapi.lib")
 
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -34,6 +45,11 @@ namespace
     ID3D11DeviceContext* gDeviceContext = nullptr;
     IDXGISwapChain* gSwapChain = nullptr;
     ID3D11RenderTargetView* gMainRenderTargetView = nullptr;
+    Inspector::RenderPacer gRenderPacer;
+    // Last InspectorSnapshot::generation handed out, by full and per-process refreshes alike.
+    uint64_t gSnapshotGeneration = 0;
+    // Stamps each snapshot, full or spliced, with the process and window ids everything downstream keys on.
+    Inspector::IdentityRegistry gIdentities;
 
     bool CreateDeviceD3D(HWND hWnd);
     void CleanupDeviceD3D();
@@ -44,7 +60,20 @@ namespace
     std::vector<ProcessInfo> EnumerateProcesses();
     std::vector<WindowInfo> EnumerateWindows();
     BOOL CALLBACK EnumWindowsThunk(HWND hwnd, LPARAM lParam);
+    std::vector<WindowInfo> EnumerateProcessWindows(DWORD pid, std::vector<HWND>& handles);
+    BOOL CALLBACK EnumHandlesThunk(HWND hwnd, LPARAM lParam);
+    bool QueryWindowInfo(HWND hwnd, WindowInfo& info);
+    void EnumerateChildWindows(HWND parent, std::vector<WindowInfo>& children);
+    bool HasChildWindows(HWND hwnd);
+    std::vector<RECT> EnumerateMonitors();
+    BOOL CALLBACK EnumMonitorsThunk(HMONITOR monitor, HDC dc, LPRECT rect, LPARAM lParam);
+    void QueryWindowDetails(HWND hwnd, Inspector::WindowDetails& details);
+    BOOL CALLBACK EnumPropsThunk(HWND hwnd, LPWSTR name, HANDLE data, ULONG_PTR lParam);
+    bool QueryWatchedWindow(HWND hwnd, Inspector::WatchSample& sample);
+    uint64_t QueryProcessCreateTime(HANDLE process);
+    void QueryProcessMetadata(const Inspector::ProcessKey& key, uint32_t fields, Inspector::ProcessMetadata& metadata);
     InspectorSnapshot CollectInspectorSnapshot();
+    void RefreshProcessWindows(InspectorSnapshot& snapshot, DWORD pid);
 }
 
 static void SetDpiAware()
@@ -62,9 +91,10 @@ static void SetDpiAware()
 #endif
 }
 
-int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
+int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR lpCmdLine, int)
 {
     SetDpiAware();
+    gRenderPacer.SetEventDriven(lpCmdLine == nullptr || ::wcsstr(lpCmdLine, L"--continuous") == nullptr);
 
     const wchar_t* windowClassName = L"WindowInspectorClass";
     WNDCLASSEXW wc = {};
@@ -98,6 +128,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
     ::UpdateWindow(hwnd);
 
     IMGUI_CHECKVERSION();
+    Inspector::InstallImGuiAllocationCounter();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -105,6 +136,11 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
 
     ImGui_ImplWin32_Init(hwnd);
     ImGui_ImplDX11_Init(gDevice, gDeviceContext);
+    Inspector::gUiState.windowTree.SetSource(Inspector::ChildWindowSource{EnumerateChildWindows, HasChildWindows});
+    Inspector::gUiState.screenCursor = [](POINT& cursor) { return ::GetCursorPos(&cursor) != FALSE; };
+    Inspector::gUiState.windowDetails.SetProvider(QueryWindowDetails);
+    Inspector::gUiState.watchList.SetProvider(QueryWatchedWindow);
+    Inspector::gUiState.processMetadata.SetProvider(QueryProcessMetadata);
 
     InspectorSnapshot snapshot = CollectInspectorSnapshot();
     std::wcout << L"[info] Captured " << snapshot.totalProcessCount << L" processes and "
@@ -119,6 +155,23 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         {
             ::TranslateMessage(&msg);
             ::DispatchMessage(&msg);
+            gRenderPacer.NotifyInput();
+            continue;
+        }
+
+        // Watched windows are polled between frames; only a change costs one.
+        Inspector::WatchList& watchList = Inspector::gUiState.watchList;
+        const auto pollTime = std::chrono::steady_clock::now();
+        if (watchList.Poll(pollTime))
+        {
+            gRenderPacer.NotifySnapshot();
+        }
+
+        // Nothing queued: block until input arrives, the pacer's next deadline or the next watch poll instead of spinning.
+        if (const uint32_t timeout = std::min(gRenderPacer.WaitTimeoutMs(pollTime), watchList.WaitTimeoutMs(pollTime)); timeout != 0)
+        {
+            ::MsgWaitForMultipleObjectsEx(0, nullptr, timeout == Inspector::RenderPacer::kWaitForever ? INFINITE : timeout,
+                                          QS_ALLINPUT, MWMO_INPUTAVAILABLE);
             continue;
         }
 
@@ -126,16 +179,46 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         const float deltaSeconds = std::chrono::duration<float>(now - previousTime).count();
         previousTime = now;
 
+        Inspector::FrameSample frameSample;
+        frameSample.windowCount = snapshot.totalWindowCount;
+        const uint64_t allocationsBefore = Inspector::gImGuiAllocationCount.load(std::memory_order_relaxed);
+        auto stageStart = std::chrono::steady_clock::now();
+        const auto endStage = [&](Inspector::FrameStage stage) {
+            const auto stageEnd = std::chrono::steady_clock::now();
+            frameSample.stageMs[static_cast<size_t>(stage)] = std::chrono::duration<float, std::milli>(stageEnd - stageStart).count();
+            stageStart = stageEnd;
+        };
+
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
+        endStage(Inspector::FrameStage::NewFrame);
 
         const bool shouldRefresh = Inspector::RenderInspectorUi(deltaSeconds, snapshot);
-        if (shouldRefresh)
+        const DWORD refreshPid = std::exchange(Inspector::gUiState.refreshProcess, 0);
+        endStage(Inspector::FrameStage::InspectorUi);
+        // The diff runs inside the UI on the frame after a refresh; keep drawing while its highlights fade out.
+        const Inspector::SnapshotDiff& snapshotDiff = Inspector::gUiState.snapshotDiff;
+        gRenderPacer.NotifyChanges(snapshotDiff.Generation(), snapshotDiff.LastUpdate().Any(),
+                                   now + std::chrono::milliseconds(static_cast<int>(Inspector::SnapshotDiff::kFadeSeconds * 1000.0)));
+        if (shouldRefresh || refreshPid != 0)
         {
-            snapshot = CollectInspectorSnapshot();
-            std::wcout << L"[info] Captured " << snapshot.totalProcessCount << L" processes and "
-                       << snapshot.totalWindowCount << L" windows." << std::endl;
+            if (shouldRefresh)
+            {
+                if (Inspector::gUiState.comparePanel.visible)
+                {
+                    Inspector::gUiState.comparePanel.KeepPrevious(std::move(snapshot));
+                }
+                snapshot = CollectInspectorSnapshot();
+                std::wcout << L"[info] Captured " << snapshot.totalProcessCount << L" processes and "
+                           << snapshot.totalWindowCount << L" windows." << std::endl;
+            }
+            else
+            {
+                RefreshProcessWindows(snapshot, refreshPid);
+            }
+            gRenderPacer.NotifySnapshot();
+            stageStart = std::chrono::steady_clock::now();
         }
 
         ImGui::Render();
@@ -143,8 +226,49 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         gDeviceContext->OMSetRenderTargets(1, &gMainRenderTargetView, nullptr);
         gDeviceContext->ClearRenderTargetView(gMainRenderTargetView, clearColor);
         ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        endStage(Inspector::FrameStage::Render);
 
         gSwapChain->Present(1, 0);
+        endStage(Inspector::FrameStage::Present);
+
+        Inspector::CollectDrawStats(ImGui::GetDrawData(), frameSample);
+        frameSample.allocations = Inspector::gImGuiAllocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        Inspector::gPerfHud.Record(frameSample);
+
+        gRenderPacer.OnFrameRendered(now);
+        if (io.WantTextInput)
+        {
+            // Keep the text caret blinking while a filter box is focused.
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(500));
+        }
+        if (Inspector::gUiState.groupings.Pending())
+        {
+            // Pick up the groupings the worker is still building.
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(15));
+        }
+        if (Inspector::gUiState.processMetadata.Pending())
+        {
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(15));
+        }
+        if (Inspector::gUiState.selectedWindow != nullptr && Inspector::gUiState.windowDetails.Pending())
+        {
+            // The detail pane is waiting on its worker.
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(15));
+        }
+        if (Inspector::gUiState.comparePanel.Pending() || (Inspector::gUiState.exactSearch && Inspector::gUiState.trigramIndex.Building()))
+        {
+            // Advance the comparison's progress bar, and install the trigram base once the worker has built it.
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(15));
+        }
+        if (Inspector::gUiState.pickMode)
+        {
+            // No mouse messages arrive once the cursor leaves the inspector, so poll it for the pick.
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(33));
+        }
+        if (Inspector::gUiState.timeline.recording)
+        {
+            gRenderPacer.ScheduleWake(now + std::chrono::milliseconds(static_cast<int>(Inspector::LifetimeTimeline::kCaptureInterval * 1000.0)));
+        }
     }
 
     ImGui_ImplDX11_Shutdown();
@@ -158,8 +282,15 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
     return 0;
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0)
+        {
+            return Inspector::RunHeadlessBenchmark(argc, argv);
+        }
+    }
     return wWinMain(::GetModuleHandleW(nullptr), nullptr, ::GetCommandLineW(), SW_SHOWDEFAULT);
 }
 
@@ -253,6 +384,7 @@ namespace
                 CleanupRenderTarget();
                 gSwapChain->ResizeBuffers(0, LOWORD(lParam), HIWORD(lParam), DXGI_FORMAT_UNKNOWN, 0);
                 CreateRenderTarget();
+                gRenderPacer.NotifyResize();
             }
             return 0;
         case WM_DPICHANGED:
@@ -294,7 +426,16 @@ namespace
             {
                 ProcessInfo info;
                 info.pid = entry.th32ProcessID;
+                info.parentPid = entry.th32ParentProcessID;
+                info.threadCount = entry.cntThreads;
                 info.name.assign(entry.szExeFile);
+                // Only the start time, which ProcessMetadataCache needs to tell a recycled pid apart; everything
+                // else about the process is queried on demand.
+                if (HANDLE process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, info.pid))
+                {
+                    info.createTime = QueryProcessCreateTime(process);
+                    ::CloseHandle(process);
+                }
                 processes.emplace_back(std::move(info));
             } while (::Process32NextW(snapshot, &entry));
         }
@@ -306,12 +447,21 @@ namespace
     BOOL CALLBACK EnumWindowsThunk(HWND hwnd, LPARAM lParam)
     {
         auto* windows = reinterpret_cast<std::vector<WindowInfo>*>(lParam);
+        WindowInfo info;
+        if (QueryWindowInfo(hwnd, info))
+        {
+            windows->emplace_back(std::move(info));
+        }
+        return TRUE;
+    }
+
+    bool QueryWindowInfo(HWND hwnd, WindowInfo& info)
+    {
         if (!::IsWindow(hwnd))
         {
-            return TRUE;
+            return false;
         }
 
-        WindowInfo info;
         info.handle = hwnd;
         info.threadId = ::GetWindowThreadProcessId(hwnd, &info.pid);
 
@@ -350,13 +500,34 @@ namespace
         info.style = ::GetWindowLongPtrW(hwnd, GWL_STYLE);
         info.exStyle = ::GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
         info.visible = (::IsWindowVisible(hwnd) != FALSE);
+        const HWND rootOwner = ::GetAncestor(hwnd, GA_ROOTOWNER);
+        info.rootOwner = rootOwner != hwnd ? rootOwner : nullptr;
         if (!::GetWindowRect(hwnd, &info.bounds))
         {
             info.bounds = RECT{0, 0, 0, 0};
         }
+        return true;
+    }
 
-        windows->emplace_back(std::move(info));
-        return TRUE;
+    // Direct children only: EnumChildWindows would walk the whole subtree, which the tree view
+    // only wants one level at a time.
+    void EnumerateChildWindows(HWND parent, std::vector<WindowInfo>& children)
+    {
+        for (HWND child = ::GetWindow(parent, GW_CHILD); child != nullptr; child = ::GetWindow(child, GW_HWNDNEXT))
+        {
+            WindowInfo info;
+            if (QueryWindowInfo(child, info))
+            {
+                info.zOrder = static_cast<uint32_t>(children.size());
+                Inspector::PrepareWindowStrings(info);
+                children.emplace_back(std::move(info));
+            }
+        }
+    }
+
+    bool HasChildWindows(HWND hwnd)
+    {
+        return ::GetWindow(hwnd, GW_CHILD) != nullptr;
     }
 
     std::vector<WindowInfo> EnumerateWindows()
@@ -373,10 +544,252 @@ namespace
         return windows;
     }
 
+    BOOL CALLBACK EnumHandlesThunk(HWND hwnd, LPARAM lParam)
+    {
+        reinterpret_cast<std::vector<HWND>*>(lParam)->push_back(hwnd);
+        return TRUE;
+    }
+
+    // Top-level windows of one process. EnumWindows itself only copies handles; the per-window queries
+    // (title, class, styles, bounds) are what a full refresh spends its time on, so every other process's
+    // window costs a single GetWindowThreadProcessId. Walking the whole list also keeps the z-order of
+    // the process's windows right, which EnumThreadWindows over its threads would not. `handles` gets the
+    // whole list, top to bottom, so the splice can renumber every other window's z-order from it as well.
+    std::vector<WindowInfo> EnumerateProcessWindows(DWORD pid, std::vector<HWND>& handles)
+    {
+        handles.clear();
+        ::EnumWindows(EnumHandlesThunk, reinterpret_cast<LPARAM>(&handles));
+
+        std::vector<WindowInfo> windows;
+        for (size_t i = 0; i < handles.size(); ++i)
+        {
+            DWORD owner = 0;
+            ::GetWindowThreadProcessId(handles[i], &owner);
+            WindowInfo info;
+            if (owner == pid && QueryWindowInfo(handles[i], info))
+            {
+                info.zOrder = static_cast<uint32_t>(i);
+                windows.emplace_back(std::move(info));
+            }
+        }
+        return windows;
+    }
+
+    BOOL CALLBACK EnumMonitorsThunk(HMONITOR, HDC, LPRECT rect, LPARAM lParam)
+    {
+        reinterpret_cast<std::vector<RECT>*>(lParam)->push_back(*rect);
+        return TRUE;
+    }
+
+    std::vector<RECT> EnumerateMonitors()
+    {
+        std::vector<RECT> monitors;
+        ::EnumDisplayMonitors(nullptr, nullptr, EnumMonitorsThunk, reinterpret_cast<LPARAM>(&monitors));
+        return monitors;
+    }
+
+    BOOL CALLBACK EnumPropsThunk(HWND, LPWSTR name, HANDLE data, ULONG_PTR lParam)
+    {
+        Inspector::WindowProperty property;
+        if (IS_INTRESOURCE(name))
+        {
+            // Atom-named property.
+            property.name = "#" + std::to_string(static_cast<unsigned>(reinterpret_cast<uintptr_t>(name)));
+        }
+        else
+        {
+            property.name = Inspector::ToUtf8(name);
+        }
+        property.value = reinterpret_cast<uintptr_t>(data);
+        reinterpret_cast<Inspector::WindowDetails*>(lParam)->properties.push_back(std::move(property));
+        return TRUE;
+    }
+
+    // Runs on the details worker thread. Only calls that do not send messages to the target window, so a hung
+    // owner cannot block the query.
+    void QueryWindowDetails(HWND hwnd, Inspector::WindowDetails& details)
+    {
+        details.alive = ::IsWindow(hwnd) != FALSE;
+        if (!details.alive)
+        {
+            return;
+        }
+
+        details.owner = ::GetWindow(hwnd, GW_OWNER);
+        const HWND parent = ::GetAncestor(hwnd, GA_PARENT);
+        details.parent = parent != ::GetDesktopWindow() ? parent : nullptr;
+
+        using GetDpiForWindowFn = UINT(WINAPI*)(HWND);
+        static const auto getDpiForWindow = reinterpret_cast<GetDpiForWindowFn>(::GetProcAddress(::GetModuleHandleW(L"User32.dll"), "GetDpiForWindow"));
+        details.dpi = getDpiForWindow != nullptr ? getDpiForWindow(hwnd) : 96;
+
+        MONITORINFOEXW monitor = {};
+        monitor.cbSize = sizeof(monitor);
+        if (::GetMonitorInfoW(::MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), &monitor))
+        {
+            details.monitorName = Inspector::ToUtf8(monitor.szDevice);
+            details.monitorBounds = monitor.rcMonitor;
+            details.workArea = monitor.rcWork;
+            details.primaryMonitor = (monitor.dwFlags & MONITORINFOF_PRIMARY) != 0;
+        }
+
+        ::EnumPropsExW(hwnd, EnumPropsThunk, reinterpret_cast<LPARAM>(&details));
+
+        details.classStyle = static_cast<uint32_t>(::GetClassLongPtrW(hwnd, GCL_STYLE));
+        details.classAtom = static_cast<uint16_t>(::GetClassLongPtrW(hwnd, GCW_ATOM));
+        details.classExtraBytes = static_cast<int>(::GetClassLongPtrW(hwnd, GCL_CBCLSEXTRA));
+        details.windowExtraBytes = static_cast<int>(::GetClassLongPtrW(hwnd, GCL_CBWNDEXTRA));
+        details.classModule = static_cast<uintptr_t>(::GetClassLongPtrW(hwnd, GCLP_HMODULE));
+
+        DWORD pid = 0;
+        ::GetWindowThreadProcessId(hwnd, &pid);
+        if (HANDLE process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid))
+        {
+            wchar_t path[MAX_PATH * 2] = {};
+            DWORD length = static_cast<DWORD>(std::size(path));
+            if (::QueryFullProcessImageNameW(process, 0, path, &length))
+            {
+                details.modulePath = Inspector::ToUtf8(std::wstring(path, length));
+            }
+            ::CloseHandle(process);
+        }
+    }
+
+    // Runs on the UI thread for every watched window at 20 Hz. GetWindowText of another process's window
+    // reads the caption user32 keeps instead of sending WM_GETTEXT, so a hung window cannot stall the poll,
+    // and the title buffer is reused from poll to poll.
+    bool QueryWatchedWindow(HWND hwnd, Inspector::WatchSample& sample)
+    {
+        if (!::IsWindow(hwnd))
+        {
+            return false;
+        }
+
+        const int length = ::GetWindowTextLengthW(hwnd);
+        sample.title.resize(static_cast<size_t>(std::max(length, 0)) + 1);
+        const int copied = length > 0 ? ::GetWindowTextW(hwnd, sample.title.data(), length + 1) : 0;
+        sample.title.resize(static_cast<size_t>(std::max(copied, 0)));
+        if (sample.title.empty())
+        {
+            sample.title.assign(L"<No Title>");
+        }
+
+        sample.style = ::GetWindowLongPtrW(hwnd, GWL_STYLE);
+        sample.exStyle = ::GetWindowLongPtrW(hwnd, GWL_EXSTYLE);
+        if (!::GetWindowRect(hwnd, &sample.bounds))
+        {
+            sample.bounds = RECT{0, 0, 0, 0};
+        }
+        return true;
+    }
+
+    uint64_t QueryProcessCreateTime(HANDLE process)
+    {
+        FILETIME created = {};
+        FILETIME exited = {};
+        FILETIME kernel = {};
+        FILETIME user = {};
+        if (!::GetProcessTimes(process, &created, &exited, &kernel, &user))
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(created.dwHighDateTime) << 32 | created.dwLowDateTime;
+    }
+
+    // Runs on the process metadata worker thread. PROCESS_QUERY_LIMITED_INFORMATION is enough for all of it,
+    // so elevated and protected processes still report what they can instead of failing outright.
+    void QueryProcessMetadata(const Inspector::ProcessKey& key, uint32_t fields, Inspector::ProcessMetadata& metadata)
+    {
+        HANDLE process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, key.pid);
+        if (process == nullptr)
+        {
+            // Denied, or gone; either way the next snapshot settles which.
+            metadata.alive = true;
+            return;
+        }
+        DWORD exitCode = 0;
+        metadata.alive = QueryProcessCreateTime(process) == key.createTime && ::GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+        metadata.accessible = true;
+        if (!metadata.alive)
+        {
+            ::CloseHandle(process);
+            return;
+        }
+
+        if ((fields & Inspector::kProcessImagePath) != 0)
+        {
+            std::wstring path(MAX_PATH, L'\0');
+            for (;;)
+            {
+                DWORD length = static_cast<DWORD>(path.size());
+                if (::QueryFullProcessImageNameW(process, 0, path.data(), &length))
+                {
+                    path.resize(length);
+                    break;
+                }
+                if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER || path.size() >= 32768)
+                {
+                    // Any other failure leaves the buffer untouched; report the path as unavailable, not as NULs.
+                    path.clear();
+                    break;
+                }
+                path.resize(path.size() * 2);
+            }
+            metadata.imagePath = Inspector::ToUtf8(path);
+        }
+
+        if ((fields & Inspector::kProcessCommandLine) != 0)
+        {
+            // ProcessCommandLineInformation (Windows 8.1+) returns a UNICODE_STRING followed by its characters,
+            // without reading the target's memory.
+            using NtQueryInformationProcessFn = LONG(WINAPI*)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+            static const auto queryInformation =
+                reinterpret_cast<NtQueryInformationProcessFn>(::GetProcAddress(::GetModuleHandleW(L"ntdll.dll"), "NtQueryInformationProcess"));
+            struct CountedString
+            {
+                USHORT length;
+                USHORT maximumLength;
+                PWSTR buffer;
+            };
+            constexpr ULONG kProcessCommandLineInformation = 60;
+            ULONG size = 0;
+            if (queryInformation != nullptr)
+            {
+                queryInformation(process, kProcessCommandLineInformation, nullptr, 0, &size);
+            }
+            if (size > sizeof(CountedString))
+            {
+                std::vector<unsigned char> buffer(size);
+                if (queryInformation(process, kProcessCommandLineInformation, buffer.data(), size, &size) >= 0)
+                {
+                    const auto* commandLine = reinterpret_cast<const CountedString*>(buffer.data());
+                    metadata.commandLine = Inspector::ToUtf8(std::wstring(commandLine->buffer, commandLine->length / sizeof(wchar_t)));
+                }
+            }
+        }
+
+        if ((fields & Inspector::kProcessMemory) != 0)
+        {
+            PROCESS_MEMORY_COUNTERS_EX counters = {};
+            counters.cb = sizeof(counters);
+            if (::GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+            {
+                metadata.workingSetBytes = counters.WorkingSetSize;
+                metadata.peakWorkingSetBytes = counters.PeakWorkingSetSize;
+                metadata.privateBytes = counters.PrivateUsage;
+            }
+        }
+        ::CloseHandle(process);
+    }
+
     InspectorSnapshot CollectInspectorSnapshot()
     {
         auto processes = EnumerateProcesses();
         auto windows = EnumerateWindows();
+        for (size_t i = 0; i < windows.size(); ++i)
+        {
+            windows[i].zOrder = static_cast<uint32_t>(i);
+        }
 
         InspectorSnapshot snapshot;
         snapshot.totalProcessCount = processes.size();
@@ -401,7 +814,34 @@ namespace
             snapshot.processes.emplace_back(std::move(entry));
         }
 
+        snapshot.generation = ++gSnapshotGeneration;
+        snapshot.monitors = EnumerateMonitors();
         ::GetLocalTime(&snapshot.timestamp);
+        PrepareSnapshotStrings(snapshot);
+        gIdentities.Assign(snapshot);
         return snapshot;
     }
+
+    void RefreshProcessWindows(InspectorSnapshot& snapshot, DWORD pid)
+    {
+        std::vector<HWND> handles;
+        std::vector<WindowInfo> windows = EnumerateProcessWindows(pid, handles);
+        const size_t count = windows.size();
+        uint64_t createTime = 0;
+        if (HANDLE process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid))
+        {
+            createTime = QueryProcessCreateTime(process);
+            ::CloseHandle(process);
+        }
+        if (Inspector::SpliceProcessWindows(snapshot, pid, createTime, std::move(windows), handles, ++gSnapshotGeneration))
+        {
+            gIdentities.Assign(snapshot);
+            std::wcout << L"[info] Refreshed " << count << L" windows of PID " << pid << L"." << std::endl;
+            return;
+        }
+        // The process exited, or its pid now belongs to another one, since the snapshot was taken.
+        snapshot = CollectInspectorSnapshot();
+        std::wcout << L"[info] PID " << pid << L" changed since the last refresh; captured " << snapshot.totalProcessCount << L" processes and "
+                   << snapshot.totalWindowCount << L" windows." << std::endl;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,336 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "imgui/imgui.h"
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+
+namespace Inspector
+{
+    // Topmost IsWindowVisible window at a desktop point, resolved against the snapshot rather than WindowFromPoint.
+    inline uint32_t TopmostVisibleAt(const InspectorSnapshot& snapshot, const SpatialIndex& index, LONG x, LONG y)
+    {
+        return index.TopmostWhere(x, y, [&](uint32_t slot) {
+            const WindowRef& ref = index.EntryAt(slot).ref;
+            return snapshot.processes[ref.process].windows[ref.window].visible;
+        });
+    }
+
+    // Stable per-process colour: a golden-ratio hue walk keyed by pid, well spread for neighbouring pids.
+    inline ImU32 ProcessColor(DWORD pid, int alpha)
+    {
+        const float hue = static_cast<float>((static_cast<uint32_t>(pid) * 2654435761u) >> 8) / static_cast<float>(1u << 24);
+        float r, g, b;
+        ImGui::ColorConvertHSVtoRGB(hue, 0.65f, 0.95f, r, g, b);
+        return IM_COL32(static_cast<int>(r * 255.0f), static_cast<int>(g * 255.0f), static_cast<int>(b * 255.0f), alpha);
+    }
+
+    // Virtual-desktop overview: every window rectangle scaled onto a zoomable canvas, coloured by process.
+    // Rectangles are written straight into the draw list as quads (one draw command for the whole map);
+    // windows smaller than a couple of pixels on screen are aggregated into a coarse density grid so the
+    // cost is bounded by the panel size rather than the window count.
+    class DesktopMinimap
+    {
+    public:
+        static constexpr float kLodPixels = 3.0f;
+
+        bool visible = false;
+        bool includeHidden = false;
+
+        // Draws the panel; clicking a window stores its handle in `selected`.
+        void Render(const InspectorSnapshot& snapshot, const SpatialIndex& index, HWND& selected)
+        {
+            if (!visible)
+            {
+                return;
+            }
+
+            ImGui::SetNextWindowSize(ImVec2(800.0f, 480.0f), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Desktop map", &visible, ImGuiWindowFlags_NoSavedSettings))
+            {
+                ImGui::End();
+                return;
+            }
+
+            if (snapshot.generation != mGeneration || includeHidden != mBuiltWithHidden)
+            {
+                Rebuild(snapshot, index);
+            }
+
+            if (ImGui::Checkbox("Hidden windows", &includeHidden))
+            {
+                Rebuild(snapshot, index);
+            }
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Reset view"))
+            {
+                ResetView();
+            }
+            ImGui::SameLine();
+            ImGui::TextDisabled("%zu windows | drawn %zu | aggregated %zu | culled %zu | zoom %.1fx",
+                                mItems.size(), mDrawn, mAggregated, mCulled, mZoom);
+
+            const ImVec2 canvasMin = ImGui::GetCursorScreenPos();
+            const ImVec2 canvasSize(std::max(ImGui::GetContentRegionAvail().x, 64.0f), std::max(ImGui::GetContentRegionAvail().y, 64.0f));
+            const ImVec2 canvasMax(canvasMin.x + canvasSize.x, canvasMin.y + canvasSize.y);
+            ImGui::InvisibleButton("##minimap_canvas", canvasSize, ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight);
+            const bool hovered = ImGui::IsItemHovered();
+            ImGuiIO& io = ImGui::GetIO();
+
+            const float baseScale = std::min(canvasSize.x / DesktopWidth(), canvasSize.y / DesktopHeight());
+            const ImVec2 canvasCenter(canvasMin.x + canvasSize.x * 0.5f, canvasMin.y + canvasSize.y * 0.5f);
+            if (hovered && io.MouseWheel != 0.0f)
+            {
+                // Zoom around the cursor: the desktop point under it stays put.
+                const ImVec2 anchor = ToDesktop(io.MousePos, canvasCenter, baseScale * mZoom);
+                mZoom = std::clamp(mZoom * (io.MouseWheel > 0.0f ? 1.25f : 0.8f), 1.0f, 512.0f);
+                const float scale = baseScale * mZoom;
+                mViewCenter = ImVec2(anchor.x - (io.MousePos.x - canvasCenter.x) / scale, anchor.y - (io.MousePos.y - canvasCenter.y) / scale);
+            }
+            if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Right))
+            {
+                const float scale = baseScale * mZoom;
+                mViewCenter.x -= io.MouseDelta.x / scale;
+                mViewCenter.y -= io.MouseDelta.y / scale;
+            }
+
+            const float scale = baseScale * mZoom;
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+            drawList->PushClipRect(canvasMin, canvasMax, true);
+            drawList->AddRectFilled(canvasMin, canvasMax, IM_COL32(20, 22, 28, 255));
+            for (const RECT& monitor : snapshot.monitors)
+            {
+                drawList->AddRect(ToScreen(monitor.left, monitor.top, canvasCenter, scale), ToScreen(monitor.right, monitor.bottom, canvasCenter, scale),
+                                  IM_COL32(90, 90, 110, 255));
+            }
+            DrawItems(drawList, canvasMin, canvasMax, canvasCenter, scale);
+
+            mHovered = SpatialIndex::kNoEntry;
+            if (hovered)
+            {
+                const ImVec2 point = ToDesktop(io.MousePos, canvasCenter, scale);
+                mHovered = HitTest(index, static_cast<LONG>(point.x), static_cast<LONG>(point.y), snapshot);
+            }
+            if (mHovered != SpatialIndex::kNoEntry)
+            {
+                const SpatialIndex::Entry& entry = index.EntryAt(mHovered);
+                drawList->AddRect(ToScreen(entry.bounds.left, entry.bounds.top, canvasCenter, scale),
+                                  ToScreen(entry.bounds.right, entry.bounds.bottom, canvasCenter, scale), IM_COL32(255, 255, 255, 255), 0.0f, 0, 2.0f);
+                if (ImGui::IsItemClicked(ImGuiMouseButton_Left))
+                {
+                    selected = entry.handle;
+                }
+
+                const auto& process = snapshot.processes[entry.ref.process];
+                const auto& window = process.windows[entry.ref.window];
+                ImGui::SetTooltip("%s [PID %lu]\n0x%llX  %s\n%s\n(%ld,%ld)-(%ld,%ld)", process.process.nameUtf8.c_str(), process.process.pid,
+                                  static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)), window.titleUtf8.c_str(),
+                                  window.classNameUtf8.c_str(), window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom);
+            }
+            if (selected != nullptr)
+            {
+                const uint32_t slot = index.SlotOf(selected);
+                if (slot != SpatialIndex::kNoEntry)
+                {
+                    const RECT& bounds = index.EntryAt(slot).bounds;
+                    drawList->AddRect(ToScreen(bounds.left, bounds.top, canvasCenter, scale), ToScreen(bounds.right, bounds.bottom, canvasCenter, scale),
+                                      IM_COL32(255, 210, 60, 255), 0.0f, 0, 2.0f);
+                }
+            }
+            drawList->PopClipRect();
+            ImGui::End();
+        }
+
+        // Index slot under the cursor during the last Render, or SpatialIndex::kNoEntry.
+        uint32_t HoveredSlot() const
+        {
+            return mHovered;
+        }
+
+    private:
+        struct Item
+        {
+            float left;
+            float top;
+            float right;
+            float bottom;
+            ImU32 fill;
+            ImU32 outline;
+        };
+
+        void Rebuild(const InspectorSnapshot& snapshot, const SpatialIndex& index)
+        {
+            mGeneration = snapshot.generation;
+            mBuiltWithHidden = includeHidden;
+            mItems.clear();
+            mOrder.clear();
+            for (const auto& entry : snapshot.processes)
+            {
+                const ImU32 fill = ProcessColor(entry.process.pid, 48);
+                const ImU32 outline = ProcessColor(entry.process.pid, 220);
+                for (const auto& window : entry.windows)
+                {
+                    if ((!window.visible && !includeHidden) || window.bounds.right <= window.bounds.left || window.bounds.bottom <= window.bounds.top)
+                    {
+                        continue;
+                    }
+                    mOrder.push_back(std::make_pair(window.zOrder, static_cast<uint32_t>(mItems.size())));
+                    mItems.push_back(Item{static_cast<float>(window.bounds.left), static_cast<float>(window.bounds.top),
+                                          static_cast<float>(window.bounds.right), static_cast<float>(window.bounds.bottom), fill, outline});
+                }
+            }
+
+            // Paint bottom-most first so the topmost window ends up on top.
+            std::sort(mOrder.begin(), mOrder.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+            std::vector<Item> sorted;
+            sorted.reserve(mItems.size());
+            for (const auto& order : mOrder)
+            {
+                sorted.push_back(mItems[order.second]);
+            }
+            mItems.swap(sorted);
+
+            // The view spans the monitors, or every window when the layout is unknown.
+            RECT desktop = snapshot.monitors.empty() ? index.Extent() : snapshot.monitors.front();
+            for (const RECT& monitor : snapshot.monitors)
+            {
+                desktop.left = std::min(desktop.left, monitor.left);
+                desktop.top = std::min(desktop.top, monitor.top);
+                desktop.right = std::max(desktop.right, monitor.right);
+                desktop.bottom = std::max(desktop.bottom, monitor.bottom);
+            }
+            const bool layoutChanged = desktop.left != mDesktop.left || desktop.top != mDesktop.top || desktop.right != mDesktop.right ||
+                                       desktop.bottom != mDesktop.bottom;
+            mDesktop = desktop;
+            if (layoutChanged)
+            {
+                ResetView();
+            }
+        }
+
+        void ResetView()
+        {
+            mZoom = 1.0f;
+            mViewCenter = ImVec2(0.5f * static_cast<float>(mDesktop.left + mDesktop.right), 0.5f * static_cast<float>(mDesktop.top + mDesktop.bottom));
+        }
+
+        float DesktopWidth() const
+        {
+            return std::max(1.0f, static_cast<float>(mDesktop.right - mDesktop.left));
+        }
+
+        float DesktopHeight() const
+        {
+            return std::max(1.0f, static_cast<float>(mDesktop.bottom - mDesktop.top));
+        }
+
+        ImVec2 ToScreen(float x, float y, const ImVec2& canvasCenter, float scale) const
+        {
+            return ImVec2(canvasCenter.x + (x - mViewCenter.x) * scale, canvasCenter.y + (y - mViewCenter.y) * scale);
+        }
+
+        ImVec2 ToScreen(LONG x, LONG y, const ImVec2& canvasCenter, float scale) const
+        {
+            return ToScreen(static_cast<float>(x), static_cast<float>(y), canvasCenter, scale);
+        }
+
+        ImVec2 ToDesktop(const ImVec2& point, const ImVec2& canvasCenter, float scale) const
+        {
+            return ImVec2(mViewCenter.x + (point.x - canvasCenter.x) / scale, mViewCenter.y + (point.y - canvasCenter.y) / scale);
+        }
+
+        uint32_t HitTest(const SpatialIndex& index, LONG x, LONG y, const InspectorSnapshot& snapshot) const
+        {
+            if (includeHidden)
+            {
+                return index.TopmostAt(x, y);
+            }
+            return TopmostVisibleAt(snapshot, index, x, y);
+        }
+
+        void DrawItems(ImDrawList* drawList, const ImVec2& canvasMin, const ImVec2& canvasMax, const ImVec2& canvasCenter, float scale)
+        {
+            mDrawn = 0;
+            mAggregated = 0;
+            mCulled = 0;
+
+            const int bucketsX = static_cast<int>((canvasMax.x - canvasMin.x) / kLodPixels) + 1;
+            const int bucketsY = static_cast<int>((canvasMax.y - canvasMin.y) / kLodPixels) + 1;
+            if (mBucketCounts.size() != static_cast<size_t>(bucketsX) * static_cast<size_t>(bucketsY))
+            {
+                mBucketCounts.assign(static_cast<size_t>(bucketsX) * static_cast<size_t>(bucketsY), 0);
+                mBucketColors.assign(mBucketCounts.size(), 0);
+            }
+            mTouchedBuckets.clear();
+
+            const float offsetX = canvasCenter.x - mViewCenter.x * scale;
+            const float offsetY = canvasCenter.y - mViewCenter.y * scale;
+            for (const Item& item : mItems)
+            {
+                const float x0 = item.left * scale + offsetX;
+                const float y0 = item.top * scale + offsetY;
+                const float x1 = item.right * scale + offsetX;
+                const float y1 = item.bottom * scale + offsetY;
+                if (x1 < canvasMin.x || y1 < canvasMin.y || x0 > canvasMax.x || y0 > canvasMax.y)
+                {
+                    ++mCulled;
+                    continue;
+                }
+
+                if (x1 - x0 < kLodPixels && y1 - y0 < kLodPixels)
+                {
+                    const int bx = std::clamp(static_cast<int>((x0 - canvasMin.x) / kLodPixels), 0, bucketsX - 1);
+                    const int by = std::clamp(static_cast<int>((y0 - canvasMin.y) / kLodPixels), 0, bucketsY - 1);
+                    const size_t bucket = static_cast<size_t>(by) * bucketsX + bx;
+                    if (mBucketCounts[bucket]++ == 0)
+                    {
+                        mTouchedBuckets.push_back(static_cast<uint32_t>(bucket));
+                    }
+                    mBucketColors[bucket] = item.outline;
+                    ++mAggregated;
+                    continue;
+                }
+
+                // Fill plus four one-pixel edges, written as raw quads: no path building, no AA fringe.
+                drawList->PrimReserve(30, 20);
+                drawList->PrimRect(ImVec2(x0, y0), ImVec2(x1, y1), item.fill);
+                drawList->PrimRect(ImVec2(x0, y0), ImVec2(x1, y0 + 1.0f), item.outline);
+                drawList->PrimRect(ImVec2(x0, y1 - 1.0f), ImVec2(x1, y1), item.outline);
+                drawList->PrimRect(ImVec2(x0, y0), ImVec2(x0 + 1.0f, y1), item.outline);
+                drawList->PrimRect(ImVec2(x1 - 1.0f, y0), ImVec2(x1, y1), item.outline);
+                ++mDrawn;
+            }
+
+            // One quad per occupied bucket, more opaque the more windows collapsed into it.
+            if (!mTouchedBuckets.empty())
+            {
+                drawList->PrimReserve(static_cast<int>(mTouchedBuckets.size()) * 6, static_cast<int>(mTouchedBuckets.size()) * 4);
+                for (const uint32_t bucket : mTouchedBuckets)
+                {
+                    const float x = canvasMin.x + static_cast<float>(bucket % static_cast<uint32_t>(bucketsX)) * kLodPixels;
+                    const float y = canvasMin.y + static_cast<float>(bucket / static_cast<uint32_t>(bucketsX)) * kLodPixels;
+                    const uint32_t alpha = std::min<uint32_t>(255, 96 + mBucketCounts[bucket] * 32);
+                    drawList->PrimRect(ImVec2(x, y), ImVec2(x + kLodPixels, y + kLodPixels), (mBucketColors[bucket] & ~IM_COL32_A_MASK) | (alpha << IM_COL32_A_SHIFT));
+                    mBucketCounts[bucket] = 0;
+                }
+            }
+        }
+
+        uint64_t mGeneration = 0;
+        bool mBuiltWithHidden = false;
+        std::vector<Item> mItems;
+        std::vector<std::pair<uint32_t, uint32_t>> mOrder;
+        RECT mDesktop{0, 0, 0, 0};
+        ImVec2 mViewCenter{0.0f, 0.0f};
+        float mZoom = 1.0f;
+        uint32_t mHovered = SpatialIndex::kNoEntry;
+        std::vector<uint32_t> mBucketCounts;
+        std::vector<ImU32> mBucketColors;
+        std::vector<uint32_t> mTouchedBuckets;
+        size_t mDrawn = 0;
+        size_t mAggregated = 0;
+        size_t mCulled = 0;
+    };
+}
@@ -0,0 +1,390 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+
+namespace Inspector
+{
+    // The part of a window (or of the screen) that is still uncovered, as disjoint rectangles. Subtracting a rectangle
+    // splits each overlapped piece into at most four; callers stop as soon as nothing is left, which
+    // in practice happens after the first maximized or large window above.
+    class UncoveredRegion
+    {
+    public:
+        void Reset(const RECT& rect, const std::vector<RECT>& clips)
+        {
+            mPieces.clear();
+            if (clips.empty())
+            {
+                AddPiece(rect);
+                return;
+            }
+            // Monitors do not overlap, so clipping against each one keeps the pieces disjoint.
+            for (const RECT& clip : clips)
+            {
+                AddPiece(RECT{std::max(rect.left, clip.left), std::max(rect.top, clip.top), std::min(rect.right, clip.right), std::min(rect.bottom, clip.bottom)});
+            }
+        }
+
+        void Subtract(const RECT& cut)
+        {
+            mNext.clear();
+            for (const RECT& piece : mPieces)
+            {
+                if (cut.left >= piece.right || cut.right <= piece.left || cut.top >= piece.bottom || cut.bottom <= piece.top)
+                {
+                    mNext.push_back(piece);
+                    continue;
+                }
+
+                const LONG top = std::max(piece.top, cut.top);
+                const LONG bottom = std::min(piece.bottom, cut.bottom);
+                if (piece.top < top)
+                {
+                    mNext.push_back(RECT{piece.left, piece.top, piece.right, top});
+                }
+                if (bottom < piece.bottom)
+                {
+                    mNext.push_back(RECT{piece.left, bottom, piece.right, piece.bottom});
+                }
+                if (piece.left < cut.left)
+                {
+                    mNext.push_back(RECT{piece.left, top, cut.left, bottom});
+                }
+                if (cut.right < piece.right)
+                {
+                    mNext.push_back(RECT{cut.right, top, piece.right, bottom});
+                }
+            }
+            mPieces.swap(mNext);
+        }
+
+        bool Empty() const
+        {
+            return mPieces.empty();
+        }
+
+        int64_t AreaWithin(const RECT& clip) const
+        {
+            int64_t area = 0;
+            for (const RECT& piece : mPieces)
+            {
+                const LONG width = std::min(piece.right, clip.right) - std::max(piece.left, clip.left);
+                const LONG height = std::min(piece.bottom, clip.bottom) - std::max(piece.top, clip.top);
+                if (width > 0 && height > 0)
+                {
+                    area += static_cast<int64_t>(width) * height;
+                }
+            }
+            return area;
+        }
+
+        int64_t Area() const
+        {
+            int64_t area = 0;
+            for (const RECT& piece : mPieces)
+            {
+                area += static_cast<int64_t>(piece.right - piece.left) * (piece.bottom - piece.top);
+            }
+            return area;
+        }
+
+    private:
+        void AddPiece(const RECT& rect)
+        {
+            if (rect.right > rect.left && rect.bottom > rect.top)
+            {
+                mPieces.push_back(rect);
+            }
+        }
+
+        std::vector<RECT> mPieces;
+        std::vector<RECT> mNext;
+    };
+
+    struct OcclusionResult
+    {
+        int64_t windowArea = 0;
+        int64_t visibleArea = 0;
+        bool computed = false;
+
+        // Share of the window's own rectangle that is on a monitor and not covered by a window above it.
+        float VisiblePercent() const
+        {
+            return windowArea > 0 ? 100.0f * static_cast<float>(visibleArea) / static_cast<float>(windowArea) : 0.0f;
+        }
+
+        bool FullyHidden() const
+        {
+            return computed && visibleArea == 0;
+        }
+    };
+
+    // Unoccluded area of every visible window, from Z order, bounds and the monitor layout. Results are
+    // stored per SpatialIndex slot. A full pass paints front to back over the uncovered screen; a refresh
+    // where only a few windows appeared, vanished, moved or changed visibility recomputes just the windows
+    // their old and new rectangles touch. A change in relative Z order triggers a full pass.
+    class OcclusionMap
+    {
+    public:
+        struct UpdateStats
+        {
+            size_t recomputed = 0;
+            bool full = false;
+        };
+
+        // `index` must already be updated for `snapshot`.
+        void Update(const InspectorSnapshot& snapshot, SpatialIndex& index)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            mLastUpdate = {};
+
+            bool full = mMonitors.size() != snapshot.monitors.size() ||
+                        !std::equal(mMonitors.begin(), mMonitors.end(), snapshot.monitors.begin(), SameRect);
+            mMonitors = snapshot.monitors;
+
+            const size_t slotCount = index.SlotCount();
+            if (mState.size() < slotCount)
+            {
+                mState.resize(slotCount);
+            }
+
+            // Dirty rectangles: old and new bounds of every window whose geometry or visibility changed,
+            // with the Z position they had at the time. Only windows below them can be affected.
+            mDirty.clear();
+            mPreviousOrder.clear();
+            mPreviousZ.assign(slotCount, kNewWindow);
+            for (uint32_t slot = 0; slot < slotCount; ++slot)
+            {
+                const SpatialIndex::Entry& entry = index.EntryAt(slot);
+                SlotState& state = mState[slot];
+                if (!entry.live)
+                {
+                    if (state.live && state.visible)
+                    {
+                        mDirty.push_back(DirtyRect{state.bounds, state.zOrder, true});
+                    }
+                    state = SlotState{};
+                    continue;
+                }
+
+                const WindowInfo& window = snapshot.processes[entry.ref.process].windows[entry.ref.window];
+                const bool fresh = !state.live || state.handle != entry.handle;
+                if (fresh || state.visible != window.visible || !SameRect(state.bounds, entry.bounds))
+                {
+                    // A reused slot still carries the previous owner's rectangle.
+                    if (state.live && state.visible)
+                    {
+                        mDirty.push_back(DirtyRect{state.bounds, state.zOrder, true});
+                    }
+                    if (window.visible)
+                    {
+                        mDirty.push_back(DirtyRect{entry.bounds, entry.zOrder, false});
+                    }
+                    state.result.computed = false;
+                }
+                else
+                {
+                    mPreviousZ[slot] = state.zOrder;
+                    if (window.visible)
+                    {
+                        mPreviousOrder.push_back(std::make_pair(entry.zOrder, state.zOrder));
+                    }
+                }
+                state.live = true;
+                state.handle = entry.handle;
+                state.visible = window.visible;
+                state.bounds = entry.bounds;
+                state.zOrder = entry.zOrder;
+            }
+
+            // Unchanged visible windows must keep their relative order, otherwise an activation reshuffled the stack.
+            std::sort(mPreviousOrder.begin(), mPreviousOrder.end());
+            for (size_t i = 1; i < mPreviousOrder.size() && !full; ++i)
+            {
+                full = mPreviousOrder[i].second < mPreviousOrder[i - 1].second;
+            }
+
+            // Occluders, topmost first.
+            mStack.clear();
+            for (uint32_t slot = 0; slot < slotCount; ++slot)
+            {
+                if (mState[slot].live && mState[slot].visible && Area(mState[slot].bounds) > 0)
+                {
+                    mStack.push_back(slot);
+                }
+            }
+            std::sort(mStack.begin(), mStack.end(), [this](uint32_t a, uint32_t b) { return mState[a].zOrder < mState[b].zOrder; });
+
+            // Past a quarter of the stack one painter pass is cheaper than per-window recomputation;
+            // that also bounds the dirty-rectangle queries when most windows changed at once.
+            full = full || mDirty.size() * 4 > mStack.size();
+            size_t marked = 0;
+            for (size_t i = 0; i < mDirty.size() && !full; ++i)
+            {
+                const DirtyRect& dirty = mDirty[i];
+                index.QueryRect(dirty.bounds, mHits);
+                for (const uint32_t slot : mHits)
+                {
+                    SlotState& state = mState[slot];
+                    const uint32_t z = dirty.previous ? mPreviousZ[slot] : state.zOrder;
+                    if (state.visible && state.result.computed && (z == kNewWindow || z > dirty.zOrder))
+                    {
+                        state.result.computed = false;
+                        ++marked;
+                    }
+                }
+                full = marked * 4 > mStack.size();
+            }
+
+            if (full)
+            {
+                ComputeAll();
+            }
+            mFullyHidden = 0;
+            for (uint32_t slot = 0; slot < slotCount; ++slot)
+            {
+                SlotState& state = mState[slot];
+                if (state.live && !state.result.computed)
+                {
+                    Compute(slot);
+                    ++mLastUpdate.recomputed;
+                }
+                mFullyHidden += state.live && state.visible && state.result.FullyHidden();
+            }
+            mLastUpdate.full = full;
+        }
+
+        // Null when `slot` has no result (not a live window).
+        const OcclusionResult* ResultFor(uint32_t slot) const
+        {
+            return slot < mState.size() && mState[slot].live ? &mState[slot].result : nullptr;
+        }
+
+        // Visible (IsWindowVisible) windows with no pixel left on screen.
+        size_t FullyHiddenCount() const
+        {
+            return mFullyHidden;
+        }
+
+        const UpdateStats& LastUpdate() const
+        {
+            return mLastUpdate;
+        }
+
+    private:
+        static constexpr uint32_t kNewWindow = 0xFFFFFFFFu;
+
+        struct DirtyRect
+        {
+            RECT bounds;
+            uint32_t zOrder;
+            // Old rectangles carry the previous snapshot's Z numbering.
+            bool previous;
+        };
+
+        struct SlotState
+        {
+            HWND handle = nullptr;
+            RECT bounds{0, 0, 0, 0};
+            uint32_t zOrder = 0;
+            bool visible = false;
+            bool live = false;
+            OcclusionResult result;
+        };
+
+        static bool SameRect(const RECT& a, const RECT& b)
+        {
+            return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+        }
+
+        static int64_t Area(const RECT& rect)
+        {
+            return rect.right > rect.left && rect.bottom > rect.top ? static_cast<int64_t>(rect.right - rect.left) * (rect.bottom - rect.top) : 0;
+        }
+
+        static bool Overlaps(const RECT& a, const RECT& b)
+        {
+            return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+        }
+
+        void ResetResult(SlotState& state)
+        {
+            state.result = OcclusionResult{};
+            state.result.windowArea = Area(state.bounds);
+            state.result.computed = true;
+        }
+
+        // Front-to-back painter pass: each window sees whatever the windows above left uncovered.
+        void ComputeAll()
+        {
+            for (SlotState& state : mState)
+            {
+                if (state.live)
+                {
+                    ResetResult(state);
+                    ++mLastUpdate.recomputed;
+                }
+            }
+
+            constexpr LONG kFar = 0x3FFFFFFF;
+            mRegion.Reset(RECT{-kFar, -kFar, kFar, kFar}, mMonitors);
+            for (const uint32_t slot : mStack)
+            {
+                if (mRegion.Empty())
+                {
+                    break;
+                }
+                SlotState& state = mState[slot];
+                state.result.visibleArea = mRegion.AreaWithin(state.bounds);
+                mRegion.Subtract(state.bounds);
+            }
+        }
+
+        // One window on its own: its rectangle minus every overlapping window above it.
+        void Compute(uint32_t slot)
+        {
+            SlotState& state = mState[slot];
+            ResetResult(state);
+            if (!state.visible || state.result.windowArea == 0)
+            {
+                return;
+            }
+
+            mRegion.Reset(state.bounds, mMonitors);
+            for (const uint32_t other : mStack)
+            {
+                const SlotState& above = mState[other];
+                if (mRegion.Empty() || above.zOrder >= state.zOrder)
+                {
+                    break;
+                }
+                if (Overlaps(above.bounds, state.bounds))
+                {
+                    mRegion.Subtract(above.bounds);
+                }
+            }
+            state.result.visibleArea = mRegion.Area();
+        }
+
+        uint64_t mGeneration = 0;
+        std::vector<RECT> mMonitors;
+        std::vector<SlotState> mState;
+        std::vector<DirtyRect> mDirty;
+        std::vector<uint32_t> mPreviousZ;
+        std::vector<std::pair<uint32_t, uint32_t>> mPreviousOrder;
+        std::vector<uint32_t> mHits;
+        std::vector<uint32_t> mStack;
+        UncoveredRegion mRegion;
+        UpdateStats mLastUpdate;
+        size_t mFullyHidden = 0;
+    };
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "imgui/imgui.h"
+
+namespace Inspector
+{
+    // Counts every allocation imgui makes; installed before the context is created.
+    inline std::atomic<uint64_t> gImGuiAllocationCount{0};
+
+    inline void* CountingImGuiAlloc(size_t size, void*)
+    {
+        gImGuiAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size);
+    }
+
+    inline void CountingImGuiFree(void* ptr, void*)
+    {
+        std::free(ptr);
+    }
+
+    inline void InstallImGuiAllocationCounter()
+    {
+        ImGui::SetAllocatorFunctions(CountingImGuiAlloc, CountingImGuiFree, nullptr);
+    }
+
+    enum class FrameStage : int
+    {
+        NewFrame,
+        InspectorUi,
+        Render,
+        Present,
+        Count
+    };
+
+    struct FrameSample
+    {
+        std::array<float, static_cast<size_t>(FrameStage::Count)> stageMs{};
+        int vertices = 0;
+        int indices = 0;
+        int drawCalls = 0;
+        uint64_t allocations = 0;
+        size_t windowCount = 0;
+
+        float TotalMs() const
+        {
+            float total = 0.0f;
+            for (const float ms : stageMs)
+            {
+                total += ms;
+            }
+            return total;
+        }
+    };
+
+    inline void CollectDrawStats(const ImDrawData* drawData, FrameSample& sample)
+    {
+        if (drawData == nullptr)
+        {
+            return;
+        }
+
+        sample.vertices = drawData->TotalVtxCount;
+        sample.indices = drawData->TotalIdxCount;
+        sample.drawCalls = 0;
+        for (const ImDrawList* list : drawData->CmdLists)
+        {
+            sample.drawCalls += list->CmdBuffer.Size;
+        }
+    }
+
+    // Rolling frame-time overlay: per-stage CPU cost with p99, draw-data totals, imgui allocation
+    // count, and a per-snapshot-size breakdown of how often the frame exceeded its budget.
+    class PerfHud
+    {
+    public:
+        static constexpr int kHistory = 240;
+        static constexpr float kBudgetMs = 16.0f;
+        static constexpr int kSizeBuckets = 6;
+
+        bool visible = false;
+
+        void Record(const FrameSample& sample)
+        {
+            mSamples[static_cast<size_t>(mHead)] = sample;
+            mHead = (mHead + 1) % kHistory;
+            mCount = std::min(mCount + 1, kHistory);
+
+            SizeBucket& bucket = mBuckets[static_cast<size_t>(BucketFor(sample.windowCount))];
+            const float total = sample.TotalMs();
+            ++bucket.frames;
+            bucket.totalMs += total;
+            bucket.worstMs = std::max(bucket.worstMs, total);
+            if (total > kBudgetMs)
+            {
+                ++bucket.overBudget;
+            }
+        }
+
+        void Render()
+        {
+            if (!visible)
+            {
+                return;
+            }
+
+            ImGui::SetNextWindowBgAlpha(0.85f);
+            ImGui::SetNextWindowPos(ImVec2(ImGui::GetIO().DisplaySize.x - 20.0f, 60.0f), ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+            if (ImGui::Begin("Performance", &visible, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings))
+            {
+                if (mCount == 0)
+                {
+                    ImGui::TextDisabled("No frames recorded yet.");
+                    ImGui::End();
+                    return;
+                }
+
+                const FrameSample& last = Latest();
+                ImGui::Text("Frame CPU: %.3f ms (p99 %.3f ms)", last.TotalMs(), Percentile99(-1));
+                ImGui::Text("Vertices: %d | Indices: %d | Draw calls: %d", last.vertices, last.indices, last.drawCalls);
+                ImGui::Text("ImGui allocations: %llu this frame", static_cast<unsigned long long>(last.allocations));
+                ImGui::Separator();
+
+                static const char* const stageNames[] = {"NewFrame", "Inspector UI", "Render", "Present"};
+                for (int stage = 0; stage < static_cast<int>(FrameStage::Count); ++stage)
+                {
+                    for (int i = 0; i < mCount; ++i)
+                    {
+                        mPlot[static_cast<size_t>(i)] = SampleAt(i).stageMs[static_cast<size_t>(stage)];
+                    }
+
+                    char overlay[64] = {};
+                    std::snprintf(overlay, sizeof(overlay), "%.3f ms | p99 %.3f ms", last.stageMs[static_cast<size_t>(stage)], Percentile99(stage));
+                    ImGui::PlotHistogram(stageNames[stage], mPlot.data(), mCount, 0, overlay, 0.0f, kBudgetMs, ImVec2(260.0f, 40.0f));
+                }
+
+                ImGui::Separator();
+                ImGui::Text("Frames over %.0f ms budget by snapshot size", kBudgetMs);
+                if (ImGui::BeginTable("##perf_buckets", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit))
+                {
+                    ImGui::TableSetupColumn("Windows");
+                    ImGui::TableSetupColumn("Frames");
+                    ImGui::TableSetupColumn("Over");
+                    ImGui::TableSetupColumn("Mean ms");
+                    ImGui::TableSetupColumn("Worst ms");
+                    ImGui::TableHeadersRow();
+
+                    static const char* const bucketNames[kSizeBuckets] = {"< 256", "< 1k", "< 4k", "< 16k", "< 64k", ">= 64k"};
+                    for (int i = 0; i < kSizeBuckets; ++i)
+                    {
+                        const SizeBucket& bucket = mBuckets[static_cast<size_t>(i)];
+                        if (bucket.frames == 0)
+                        {
+                            continue;
+                        }
+
+                        ImGui::TableNextRow();
+                        ImGui::TableSetColumnIndex(0);
+                        ImGui::TextUnformatted(bucketNames[i]);
+                        ImGui::TableSetColumnIndex(1);
+                        ImGui::Text("%llu", static_cast<unsigned long long>(bucket.frames));
+                        ImGui::TableSetColumnIndex(2);
+                        if (bucket.overBudget > 0)
+                        {
+                            ImGui::TextColored(ImVec4(1.0f, 0.45f, 0.35f, 1.0f), "%llu", static_cast<unsigned long long>(bucket.overBudget));
+                        }
+                        else
+                        {
+                            ImGui::TextUnformatted("0");
+                        }
+                        ImGui::TableSetColumnIndex(3);
+                        ImGui::Text("%.3f", bucket.totalMs / static_cast<double>(bucket.frames));
+                        ImGui::TableSetColumnIndex(4);
+                        ImGui::Text("%.3f", bucket.worstMs);
+                    }
+                    ImGui::EndTable();
+                }
+
+                if (ImGui::SmallButton("Reset"))
+                {
+                    mBuckets = {};
+                    mCount = 0;
+                    mHead = 0;
+                }
+            }
+            ImGui::End();
+        }
+
+    private:
+        struct SizeBucket
+        {
+            uint64_t frames = 0;
+            uint64_t overBudget = 0;
+            double totalMs = 0.0;
+            float worstMs = 0.0f;
+        };
+
+        static int BucketFor(size_t windowCount)
+        {
+            int bucket = 0;
+            for (size_t limit = 256; bucket < kSizeBuckets - 1 && windowCount >= limit; limit *= 4)
+            {
+                ++bucket;
+            }
+            return bucket;
+        }
+
+        // Oldest-first access into the ring buffer.
+        const FrameSample& SampleAt(int index) const
+        {
+            const int start = (mHead - mCount + kHistory) % kHistory;
+            return mSamples[static_cast<size_t>((start + index) % kHistory)];
+        }
+
+        const FrameSample& Latest() const
+        {
+            return SampleAt(mCount - 1);
+        }
+
+        // p99 of one stage, or of the whole frame when `stage` is negative.
+        float Percentile99(int stage)
+        {
+            for (int i = 0; i < mCount; ++i)
+            {
+                const FrameSample& sample = SampleAt(i);
+                mScratch[static_cast<size_t>(i)] = stage < 0 ? sample.TotalMs() : sample.stageMs[static_cast<size_t>(stage)];
+            }
+            const int rank = std::min(mCount - 1, (mCount * 99) / 100);
+            std::nth_element(mScratch.begin(), mScratch.begin() + rank, mScratch.begin() + mCount);
+            return mScratch[static_cast<size_t>(rank)];
+        }
+
+        std::array<FrameSample, kHistory> mSamples{};
+        std::array<float, kHistory> mPlot{};
+        std::array<float, kHistory> mScratch{};
+        std::array<SizeBucket, kSizeBuckets> mBuckets{};
+        int mHead = 0;
+        int mCount = 0;
+    };
+
+    inline PerfHud gPerfHud;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cstdint>
+
+// Minimal stand-ins for the Win32 types the snapshot model and UI use, so the headless
+// benchmark (bench.cpp) and the platform-free modules build without the Windows SDK.
+using BOOL = int;
+using LONG = long;
+using DWORD = unsigned long;
+using WORD = unsigned short;
+using UINT = unsigned int;
+using LONG_PTR = intptr_t;
+using HWND = struct HWND__*;
+
+struct RECT
+{
+    LONG left;
+    LONG top;
+    LONG right;
+    LONG bottom;
+};
+
+struct POINT
+{
+    LONG x;
+    LONG y;
+};
+
+struct SYSTEMTIME
+{
+    WORD wYear;
+    WORD wMonth;
+    WORD wDayOfWeek;
+    WORD wDay;
+    WORD wHour;
+    WORD wMinute;
+    WORD wSecond;
+    WORD wMilliseconds;
+};
+#endif
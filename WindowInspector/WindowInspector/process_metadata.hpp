@@ -0,0 +1,400 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "identity.hpp"
+
+namespace Inspector
+{
+    // Groups of ProcessMetadata fields; a provider is asked only for the ones that are missing or stale.
+    enum ProcessMetadataField : uint32_t
+    {
+        kProcessImagePath = 1u << 0,
+        kProcessCommandLine = 1u << 1,
+        kProcessMemory = 1u << 2,
+    };
+
+    // What PROCESSENTRY32W does not carry, queried for one process on demand.
+    struct ProcessMetadata
+    {
+        ProcessKey key;
+        // False when the process exited, or its pid now belongs to another process, before the query ran.
+        bool alive = false;
+        // ProcessMetadataField bits loaded so far; a field outside it is empty, not "none".
+        uint32_t fields = 0;
+        // False when OpenProcess was denied; the fields stay empty.
+        bool accessible = false;
+        std::string imagePath;
+        std::string commandLine;
+        uint64_t workingSetBytes = 0;
+        uint64_t peakWorkingSetBytes = 0;
+        uint64_t privateBytes = 0;
+        double queryMs = 0.0;
+    };
+
+    // Where metadata comes from; main.cpp queries Win32. Called on the cache's worker thread with the
+    // ProcessMetadataField bits to fill, and expected to set alive only if the pid still has key's creation time.
+    using ProcessMetadataProvider = std::function<void(const ProcessKey& key, uint32_t fields, ProcessMetadata& metadata)>;
+
+    // Image path, command line and memory counters for the processes the UI asks about, keyed by (pid,
+    // creation time) so a refresh that lists the same process again re-queries nothing and a recycled pid
+    // never shows its predecessor's data. Queries run on one worker thread in request order. The image
+    // path and command line are fixed for a process's lifetime and kept until it exits; memory counters
+    // are re-sampled when a request finds them older than kMemoryMaxAge. Entries whose process is missing
+    // from a new snapshot are dropped, and past kCapacity entries or kByteBudget bytes of strings the least
+    // recently requested go first.
+    class ProcessMetadataCache
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t kCapacity = 256;
+        static constexpr size_t kByteBudget = 1u << 20;
+        // Longer command lines are cut at a character boundary and end in "...".
+        static constexpr size_t kCommandLineLimit = 4096;
+        static constexpr Clock::duration kMemoryMaxAge = std::chrono::seconds(2);
+
+        struct Stats
+        {
+            size_t entries = 0;
+            size_t bytes = 0;
+            uint64_t requests = 0;
+            uint64_t queries = 0;
+            uint64_t evicted = 0;
+        };
+
+        ~ProcessMetadataCache()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mWake.notify_all();
+            if (mWorker.joinable())
+            {
+                mWorker.join();
+            }
+        }
+
+        void SetProvider(ProcessMetadataProvider provider)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mProvider = std::move(provider);
+        }
+
+        bool HasProvider() const
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return static_cast<bool>(mProvider);
+        }
+
+        // Drops entries and queued queries for processes the new snapshot no longer lists under the same key.
+        void Sync(const InspectorSnapshot& snapshot)
+        {
+            CollectCompleted();
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            mLive.clear();
+            mLive.reserve(snapshot.processes.size());
+            for (const auto& entry : snapshot.processes)
+            {
+                mLive.emplace(entry.process.pid, entry.process.createTime);
+            }
+            const auto dead = [this](const ProcessKey& key) {
+                const auto it = mLive.find(key.pid);
+                return it == mLive.end() || it->second != key.createTime;
+            };
+
+            for (auto it = mEntries.begin(); it != mEntries.end();)
+            {
+                if (dead(it->second.metadata.key))
+                {
+                    mBytes -= BytesOf(it->second.metadata);
+                    ++mStats.evicted;
+                    it = mEntries.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueue.erase(std::remove_if(mQueue.begin(), mQueue.end(), [&](const Query& query) { return dead(query.key); }), mQueue.end());
+        }
+
+        // Cached metadata for `process`, possibly without all of `fields` yet, or null before its first query
+        // completes. Missing fields, and memory counters older than kMemoryMaxAge, are queued.
+        const ProcessMetadata* Request(const ProcessInfo& process, uint32_t fields, Clock::time_point now = Clock::now())
+        {
+            CollectCompleted();
+            ++mClock;
+            ++mStats.requests;
+            const ProcessKey key = KeyOf(process);
+            uint32_t missing = fields;
+            const ProcessMetadata* found = nullptr;
+            if (const auto it = mEntries.find(key.pid); it != mEntries.end() && it->second.metadata.key == key)
+            {
+                Entry& entry = it->second;
+                entry.lastUse = mClock;
+                found = &entry.metadata;
+                missing &= ~entry.metadata.fields;
+                if (!entry.metadata.alive || !entry.metadata.accessible)
+                {
+                    // Nothing more to learn until the snapshot lists the pid again.
+                    missing = 0;
+                }
+                else if ((fields & kProcessMemory) != 0 && now - entry.memorySampled >= kMemoryMaxAge)
+                {
+                    missing |= kProcessMemory;
+                }
+            }
+            if (missing != 0)
+            {
+                Enqueue(key, missing, now);
+            }
+            return found;
+        }
+
+        // Forgets `pid` so the next Request queries it again.
+        void Invalidate(DWORD pid)
+        {
+            if (const auto it = mEntries.find(pid); it != mEntries.end())
+            {
+                mBytes -= BytesOf(it->second.metadata);
+                mEntries.erase(it);
+            }
+        }
+
+        // True while queries are queued or running, so the UI keeps drawing until they land.
+        bool Pending() const
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return !mQueue.empty() || mBusy || !mCompleted.empty();
+        }
+
+        Stats CurrentStats() const
+        {
+            Stats stats = mStats;
+            stats.entries = mEntries.size();
+            stats.bytes = mBytes;
+            std::lock_guard<std::mutex> lock(mMutex);
+            stats.queries = mQueries;
+            return stats;
+        }
+
+    private:
+        struct Entry
+        {
+            ProcessMetadata metadata;
+            Clock::time_point memorySampled{};
+            uint64_t lastUse = 0;
+        };
+
+        struct Query
+        {
+            ProcessKey key;
+            uint32_t fields = 0;
+            // When the UI asked; memory counters count their age from here, which the query follows closely.
+            Clock::time_point requested{};
+        };
+
+        struct Result
+        {
+            ProcessMetadata metadata;
+            uint32_t requested = 0;
+            Clock::time_point sampled{};
+        };
+
+        static size_t BytesOf(const ProcessMetadata& metadata)
+        {
+            return sizeof(Entry) + metadata.imagePath.capacity() + metadata.commandLine.capacity();
+        }
+
+        static void LimitCommandLine(std::string& text)
+        {
+            if (text.size() <= kCommandLineLimit)
+            {
+                return;
+            }
+            size_t end = kCommandLineLimit - 3;
+            while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80)
+            {
+                --end;
+            }
+            text.resize(end);
+            text += "...";
+            text.shrink_to_fit();
+        }
+
+        void Enqueue(const ProcessKey& key, uint32_t fields, Clock::time_point now)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mProvider)
+            {
+                return;
+            }
+            if (mBusy && mInFlight.key == key && (mInFlight.fields & fields) == fields)
+            {
+                return;
+            }
+            for (Query& query : mQueue)
+            {
+                if (query.key == key)
+                {
+                    query.fields |= fields;
+                    return;
+                }
+            }
+            if (mQueue.size() >= kCapacity)
+            {
+                // Hovering across a long list outruns the worker; the oldest requests are the least wanted.
+                mQueue.pop_front();
+            }
+            mQueue.push_back(Query{key, fields, now});
+            if (!mWorker.joinable())
+            {
+                mWorker = std::thread([this]() { WorkerLoop(); });
+            }
+            mWake.notify_one();
+        }
+
+        void CollectCompleted()
+        {
+            std::vector<Result> completed;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mCompleted.empty())
+                {
+                    return;
+                }
+                completed.swap(mCompleted);
+            }
+            for (Result& result : completed)
+            {
+                ProcessMetadata& fresh = result.metadata;
+                if (const auto live = mLive.find(fresh.key.pid); !mLive.empty() && (live == mLive.end() || live->second != fresh.key.createTime))
+                {
+                    // Gone since it was queued.
+                    continue;
+                }
+                LimitCommandLine(fresh.commandLine);
+                auto it = mEntries.find(fresh.key.pid);
+                if (it != mEntries.end() && !(it->second.metadata.key == fresh.key))
+                {
+                    mBytes -= BytesOf(it->second.metadata);
+                    mEntries.erase(it);
+                    it = mEntries.end();
+                }
+                if (it == mEntries.end())
+                {
+                    it = mEntries.emplace(fresh.key.pid, Entry{}).first;
+                    it->second.metadata.key = fresh.key;
+                    mBytes += BytesOf(it->second.metadata);
+                }
+
+                Entry& entry = it->second;
+                ProcessMetadata& metadata = entry.metadata;
+                mBytes -= BytesOf(metadata);
+                metadata.alive = fresh.alive;
+                metadata.accessible = fresh.accessible;
+                metadata.fields |= result.requested;
+                metadata.queryMs = fresh.queryMs;
+                if ((result.requested & kProcessImagePath) != 0)
+                {
+                    metadata.imagePath = std::move(fresh.imagePath);
+                }
+                if ((result.requested & kProcessCommandLine) != 0)
+                {
+                    metadata.commandLine = std::move(fresh.commandLine);
+                }
+                if ((result.requested & kProcessMemory) != 0)
+                {
+                    metadata.workingSetBytes = fresh.workingSetBytes;
+                    metadata.peakWorkingSetBytes = fresh.peakWorkingSetBytes;
+                    metadata.privateBytes = fresh.privateBytes;
+                    entry.memorySampled = result.sampled;
+                }
+                mBytes += BytesOf(metadata);
+                entry.lastUse = mClock;
+            }
+            Evict();
+        }
+
+        void Evict()
+        {
+            while (mEntries.size() > kCapacity || (mBytes > kByteBudget && mEntries.size() > 1))
+            {
+                const auto oldest = std::min_element(mEntries.begin(), mEntries.end(),
+                                                     [](const auto& a, const auto& b) { return a.second.lastUse < b.second.lastUse; });
+                mBytes -= BytesOf(oldest->second.metadata);
+                mEntries.erase(oldest);
+                ++mStats.evicted;
+            }
+        }
+
+        void WorkerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            for (;;)
+            {
+                mWake.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+                if (mStopping)
+                {
+                    return;
+                }
+
+                mInFlight = mQueue.front();
+                mQueue.pop_front();
+                mBusy = true;
+                ++mQueries;
+                const ProcessMetadataProvider provider = mProvider;
+                lock.unlock();
+
+                Result result;
+                result.metadata.key = mInFlight.key;
+                result.requested = mInFlight.fields;
+                result.sampled = mInFlight.requested;
+                const auto start = Clock::now();
+                provider(mInFlight.key, mInFlight.fields, result.metadata);
+                result.metadata.queryMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                lock.lock();
+                mBusy = false;
+                mCompleted.push_back(std::move(result));
+            }
+        }
+
+        // UI thread only.
+        std::unordered_map<DWORD, Entry> mEntries;
+        std::unordered_map<DWORD, uint64_t> mLive;
+        size_t mBytes = 0;
+        uint64_t mGeneration = 0;
+        uint64_t mClock = 0;
+        Stats mStats;
+
+        // Shared with the worker, guarded by mMutex.
+        mutable std::mutex mMutex;
+        std::condition_variable mWake;
+        ProcessMetadataProvider mProvider;
+        std::deque<Query> mQueue;
+        Query mInFlight;
+        bool mBusy = false;
+        uint64_t mQueries = 0;
+        std::vector<Result> mCompleted;
+        bool mStopping = false;
+        std::thread mWorker;
+    };
+}
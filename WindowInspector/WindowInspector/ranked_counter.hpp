@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+namespace Inspector
+{
+    // Counts keys that go up and down by one at a time and keeps them ranked by count, most frequent
+    // first, so the top N is simply the first N entries. Keys with equal counts sit in one contiguous
+    // block; a step moves the key to the edge of its block (one swap) and shifts that block's boundary,
+    // so both directions are O(1) and exact, unlike a heap (which would need decrease-key) or a
+    // count-min sketch (which only estimates). Keys whose count drops to zero are forgotten.
+    template <typename Key, typename Hash = std::hash<Key>>
+    class RankedCounter
+    {
+    public:
+        struct Entry
+        {
+            Key key{};
+            uint32_t count = 0;
+        };
+
+        // Returns the key's new count.
+        uint32_t Increment(const Key& key)
+        {
+            auto [it, inserted] = mRank.try_emplace(key, static_cast<uint32_t>(mEntries.size()));
+            if (inserted)
+            {
+                // A new key starts at the very end, which is where count 0 ranks anyway.
+                mEntries.push_back(Entry{key, 0});
+            }
+            const uint32_t rank = it->second;
+            const uint32_t count = mEntries[rank].count;
+            if (count + 1 >= mAbove.size())
+            {
+                mAbove.resize(count + 2, 0);
+            }
+            // Swap to the front of its block, then that slot moves into the block above.
+            const uint32_t front = mAbove[count];
+            Swap(rank, front);
+            ++mEntries[front].count;
+            ++mAbove[count];
+            return count + 1;
+        }
+
+        // Returns the key's new count; decrementing a key that is not counted does nothing.
+        uint32_t Decrement(const Key& key)
+        {
+            const auto it = mRank.find(key);
+            if (it == mRank.end())
+            {
+                return 0;
+            }
+            const uint32_t rank = it->second;
+            const uint32_t count = mEntries[rank].count;
+            // Swap to the back of its block, then that slot moves into the block below.
+            const uint32_t back = mAbove[count - 1] - 1;
+            Swap(rank, back);
+            --mEntries[back].count;
+            --mAbove[count - 1];
+            if (count == 1)
+            {
+                // Every other key has a count of at least one, so `back` is the last entry.
+                mRank.erase(key);
+                mEntries.pop_back();
+            }
+            return count - 1;
+        }
+
+        uint32_t CountOf(const Key& key) const
+        {
+            const auto it = mRank.find(key);
+            return it != mRank.end() ? mEntries[it->second].count : 0;
+        }
+
+        // Entry at `rank`, 0 being the most frequent key.
+        const Entry& At(size_t rank) const
+        {
+            return mEntries[rank];
+        }
+
+        size_t Size() const
+        {
+            return mEntries.size();
+        }
+
+        void Clear()
+        {
+            mEntries.clear();
+            mRank.clear();
+            mAbove.clear();
+        }
+
+    private:
+        void Swap(uint32_t a, uint32_t b)
+        {
+            if (a == b)
+            {
+                return;
+            }
+            std::swap(mEntries[a], mEntries[b]);
+            mRank[mEntries[a].key] = a;
+            mRank[mEntries[b].key] = b;
+        }
+
+        std::vector<Entry> mEntries;
+        std::unordered_map<Key, uint32_t, Hash> mRank;
+        // mAbove[c] is the number of keys counted more than c times, so keys counted exactly c times
+        // occupy ranks [mAbove[c], mAbove[c - 1]).
+        std::vector<uint32_t> mAbove;
+    };
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+namespace Inspector
+{
+    // Decides whether the main loop has to build and present a frame. Every event (input, resize,
+    // new snapshot) arms a few trailing frames so imgui can settle hover and animation state;
+    // after that the loop blocks until the next event or scheduled deadline.
+    class RenderPacer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr int kTrailingFrames = 3;
+        static constexpr uint32_t kWaitForever = 0xFFFFFFFFu;
+
+        void SetEventDriven(bool eventDriven)
+        {
+            mEventDriven = eventDriven;
+            mPendingFrames = kTrailingFrames;
+        }
+
+        bool IsEventDriven() const
+        {
+            return mEventDriven;
+        }
+
+        void NotifyInput()
+        {
+            mPendingFrames = kTrailingFrames;
+        }
+
+        void NotifyResize()
+        {
+            mPendingFrames = kTrailingFrames;
+        }
+
+        void NotifySnapshot()
+        {
+            mPendingFrames = kTrailingFrames;
+        }
+
+        // Keeps rendering every frame until `deadline` (fades, progress indicators).
+        void RequestContinuousUntil(Clock::time_point deadline)
+        {
+            mContinuousUntil = std::max(mContinuousUntil, deadline);
+        }
+
+        // Called every frame with the generation the snapshot diff last saw. The first time a generation
+        // shows up with changes, keeps rendering until `fadeUntil` so the highlights can fade out; a
+        // refresh that changed nothing (the timeline's periodic capture) leaves the loop free to idle.
+        void NotifyChanges(uint64_t generation, bool changed, Clock::time_point fadeUntil)
+        {
+            if (generation == mChangesGeneration)
+            {
+                return;
+            }
+            mChangesGeneration = generation;
+            if (changed)
+            {
+                RequestContinuousUntil(fadeUntil);
+            }
+        }
+
+        // Wakes the loop for a single frame at `when` (caret blink, periodic refresh).
+        void ScheduleWake(Clock::time_point when)
+        {
+            if (!mHasWake || when < mNextWake)
+            {
+                mNextWake = when;
+                mHasWake = true;
+            }
+        }
+
+        bool ShouldRender(Clock::time_point now) const
+        {
+            return !mEventDriven || mPendingFrames > 0 || now < mContinuousUntil || (mHasWake && now >= mNextWake);
+        }
+
+        void OnFrameRendered(Clock::time_point now)
+        {
+            if (mPendingFrames > 0)
+            {
+                --mPendingFrames;
+            }
+            if (mHasWake && now >= mNextWake)
+            {
+                mHasWake = false;
+            }
+        }
+
+        // How long the loop may block waiting for messages, in milliseconds.
+        uint32_t WaitTimeoutMs(Clock::time_point now) const
+        {
+            if (ShouldRender(now))
+            {
+                return 0;
+            }
+            if (!mHasWake)
+            {
+                return kWaitForever;
+            }
+
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(mNextWake - now).count();
+            return static_cast<uint32_t>(std::clamp<long long>(remaining, 0, kWaitForever - 1));
+        }
+
+    private:
+        bool mEventDriven = true;
+        int mPendingFrames = kTrailingFrames;
+        bool mHasWake = false;
+        Clock::time_point mNextWake{};
+        Clock::time_point mContinuousUntil{};
+        uint64_t mChangesGeneration = 0;
+    };
+}
@@ -0,0 +1,275 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "platform.hpp"
+
+namespace Inspector
+{
+    // ProcessInfo::id / WindowInfo::id before IdentityRegistry::Assign has seen the snapshot.
+    constexpr uint32_t kNoIdentity = 0xFFFFFFFFu;
+
+    struct ProcessInfo
+    {
+        DWORD pid = 0;
+        DWORD parentPid = 0;
+        DWORD threadCount = 0;
+        // FILETIME of the process start as one integer; 0 when the process could not be opened. Together with
+        // pid it names one process (see ProcessKey).
+        uint64_t createTime = 0;
+        // Dense id of this process (not of its pid) for the session; see IdentityRegistry.
+        uint32_t id = kNoIdentity;
+        std::wstring name;
+        std::string nameUtf8;
+    };
+
+    // One hash per group of fields the table shows in its own cell, so a diff can tell which cells changed
+    // without comparing strings.
+    struct WindowHashes
+    {
+        uint64_t title = 0;
+        uint64_t className = 0;
+        uint64_t state = 0;
+        uint64_t styles = 0;
+        uint64_t bounds = 0;
+    };
+
+    struct WindowInfo
+    {
+        HWND handle = nullptr;
+        DWORD pid = 0;
+        DWORD threadId = 0;
+        std::wstring title;
+        std::wstring className;
+        std::string titleUtf8;
+        std::string classNameUtf8;
+        LONG_PTR style = 0;
+        LONG_PTR exStyle = 0;
+        RECT bounds{0, 0, 0, 0};
+        bool visible = false;
+        // Top of the owner chain (GetAncestor GA_ROOTOWNER), null for unowned windows.
+        HWND rootOwner = nullptr;
+        // Position in EnumWindows order (0 = topmost); children are numbered among their siblings.
+        uint32_t zOrder = 0;
+        // HashWindowFields of the fields above, filled in by PrepareSnapshotStrings.
+        WindowHashes hashes;
+        // Dense id of this window (not of its handle) for the session; see IdentityRegistry.
+        uint32_t id = kNoIdentity;
+    };
+
+    struct ProcessWindows
+    {
+        ProcessInfo process;
+        std::vector<WindowInfo> windows;
+        std::string headerLabel;
+    };
+
+    // Position of a window inside InspectorSnapshot::processes; only valid for the snapshot it was built from.
+    struct WindowRef
+    {
+        uint32_t process = 0;
+        uint32_t window = 0;
+    };
+
+    struct InspectorSnapshot
+    {
+        uint64_t generation = 0;
+        SYSTEMTIME timestamp{};
+        std::string timestampLabel;
+        std::vector<ProcessWindows> processes;
+        // Monitor rectangles in virtual-screen coordinates.
+        std::vector<RECT> monitors;
+        size_t totalProcessCount = 0;
+        size_t totalWindowCount = 0;
+    };
+
+    inline std::string ToUtf8(const std::wstring& text)
+    {
+        if (text.empty())
+        {
+            return {};
+        }
+
+#if defined(_WIN32)
+        const int required = ::WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+        if (required <= 0)
+        {
+            return {};
+        }
+
+        std::string utf8(static_cast<size_t>(required), '\0');
+        ::WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), utf8.data(), required, nullptr, nullptr);
+        return utf8;
+#else
+        // wchar_t holds UTF-32 here.
+        std::string utf8;
+        utf8.reserve(text.size());
+        for (const wchar_t wc : text)
+        {
+            const auto cp = static_cast<uint32_t>(wc);
+            if (cp < 0x80)
+            {
+                utf8.push_back(static_cast<char>(cp));
+            }
+            else if (cp < 0x800)
+            {
+                utf8.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else if (cp < 0x10000)
+            {
+                utf8.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+            else
+            {
+                utf8.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                utf8.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+        }
+        return utf8;
+#endif
+    }
+
+    // Fast non-cryptographic hash of a byte range, eight bytes per step.
+    inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0x9E3779B97F4A7C15ull)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        uint64_t hash = seed ^ (static_cast<uint64_t>(size) * 0xFF51AFD7ED558CCDull);
+        while (size > 0)
+        {
+            uint64_t word = 0;
+            const size_t step = size < 8 ? size : 8;
+            std::memcpy(&word, bytes, step);
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 32;
+            bytes += step;
+            size -= step;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    inline WindowHashes HashWindowFields(const WindowInfo& window)
+    {
+        WindowHashes hashes;
+        hashes.title = HashBytes(window.title.data(), window.title.size() * sizeof(wchar_t));
+        hashes.className = HashBytes(window.className.data(), window.className.size() * sizeof(wchar_t));
+        const uint64_t state[3] = {window.pid, window.threadId, window.visible ? 1u : 0u};
+        hashes.state = HashBytes(state, sizeof(state));
+        const uint64_t styles[2] = {static_cast<uint64_t>(window.style), static_cast<uint64_t>(window.exStyle)};
+        hashes.styles = HashBytes(styles, sizeof(styles));
+        const int64_t bounds[4] = {window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom};
+        hashes.bounds = HashBytes(bounds, sizeof(bounds));
+        return hashes;
+    }
+
+    inline uint64_t CombineWindowHashes(const WindowHashes& hashes)
+    {
+        return HashBytes(&hashes, sizeof(hashes));
+    }
+
+    // Hash of every field a refresh can change, so "same fingerprint" means "nothing to re-query or redraw".
+    inline uint64_t WindowFingerprint(const WindowInfo& window)
+    {
+        return CombineWindowHashes(HashWindowFields(window));
+    }
+
+    inline std::string FormatTimestamp(const SYSTEMTIME& time)
+    {
+        if (time.wYear == 0)
+        {
+            return {};
+        }
+
+        char buffer[64] = {};
+        std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u %02u:%02u:%02u",
+                      static_cast<unsigned>(time.wYear), static_cast<unsigned>(time.wMonth), static_cast<unsigned>(time.wDay),
+                      static_cast<unsigned>(time.wHour), static_cast<unsigned>(time.wMinute), static_cast<unsigned>(time.wSecond));
+        return std::string(buffer);
+    }
+
+    inline void PrepareWindowStrings(WindowInfo& window)
+    {
+        window.titleUtf8 = window.title.empty() ? std::string("<No Title>") : ToUtf8(window.title);
+        window.classNameUtf8 = window.className.empty() ? std::string("<UnknownClass>") : ToUtf8(window.className);
+    }
+
+    // Builds every string the UI shows once per snapshot, so a steady-state frame formats nothing
+    // on the heap. Widgets are scoped with PushID(pid), so labels carry no "##" suffix. Also hashes each
+    // window's fields, which is what SnapshotDiff compares.
+    inline void PrepareSnapshotStrings(InspectorSnapshot& snapshot)
+    {
+        const std::string timestamp = FormatTimestamp(snapshot.timestamp);
+        snapshot.timestampLabel = timestamp.empty() ? std::string("N/A") : timestamp;
+        for (auto& entry : snapshot.processes)
+        {
+            entry.process.nameUtf8 = entry.process.name.empty() ? std::string("<Unknown>") : ToUtf8(entry.process.name);
+            char pidLabel[32] = {};
+            std::snprintf(pidLabel, sizeof(pidLabel), " [PID %lu]", static_cast<unsigned long>(entry.process.pid));
+            entry.headerLabel = entry.process.nameUtf8 + pidLabel;
+            for (auto& window : entry.windows)
+            {
+                PrepareWindowStrings(window);
+                window.hashes = HashWindowFields(window);
+            }
+        }
+    }
+
+    // Replaces the windows of process `pid` with a fresh enumeration of just that process and stamps the
+    // snapshot with `generation`, so everything keyed on the generation picks the change up. Only the new
+    // windows' strings and hashes are built. `zOrder` is the EnumWindows list the enumeration walked:
+    // every window in the snapshot is renumbered by its position there, so the spliced windows and the
+    // other processes' share one Z order, and windows closed since the last full refresh sink below the
+    // rest in their old order. Returns false, leaving the snapshot alone, when it does not list `pid`
+    // with `createTime`; a recycled pid needs a full refresh.
+    inline bool SpliceProcessWindows(InspectorSnapshot& snapshot, DWORD pid, uint64_t createTime, std::vector<WindowInfo> windows,
+                                     const std::vector<HWND>& zOrder, uint64_t generation)
+    {
+        for (auto& entry : snapshot.processes)
+        {
+            if (entry.process.pid != pid)
+            {
+                continue;
+            }
+            if (entry.process.createTime != createTime)
+            {
+                return false;
+            }
+            for (auto& window : windows)
+            {
+                PrepareWindowStrings(window);
+                window.hashes = HashWindowFields(window);
+            }
+            snapshot.totalWindowCount = snapshot.totalWindowCount - entry.windows.size() + windows.size();
+            entry.windows = std::move(windows);
+            snapshot.generation = generation;
+
+            std::unordered_map<HWND, uint32_t> positions;
+            positions.reserve(zOrder.size());
+            for (size_t i = 0; i < zOrder.size(); ++i)
+            {
+                positions.emplace(zOrder[i], static_cast<uint32_t>(i));
+            }
+            for (auto& other : snapshot.processes)
+            {
+                for (auto& window : other.windows)
+                {
+                    const auto it = positions.find(window.handle);
+                    window.zOrder = it != positions.end() ? it->second : static_cast<uint32_t>(zOrder.size()) + window.zOrder;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+}
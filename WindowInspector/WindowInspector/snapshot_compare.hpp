@@ -0,0 +1,388 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "snapshot_diff.hpp"
+
+namespace Inspector
+{
+    enum class CompareKind : uint8_t
+    {
+        Same,
+        Changed,
+        Added,
+        Removed
+    };
+
+    constexpr size_t kCompareKindCount = 4;
+
+    // Which join paired a row's windows: the handle, or for windows whose handle found no partner, the
+    // same (pid, class, title) and then the same (pid, class).
+    enum class CompareMatch : uint8_t
+    {
+        None,
+        Handle,
+        Title,
+        Class
+    };
+
+    constexpr size_t kCompareMatchCount = 4;
+
+    // One row of an aligned comparison: a window of the left snapshot, of the right one, or one of each.
+    struct CompareRow
+    {
+        static constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+        // Flat window numbers into SnapshotComparison::leftWindows / rightWindows.
+        uint32_t left = kNone;
+        uint32_t right = kNone;
+        CompareKind kind = CompareKind::Same;
+        CompareMatch match = CompareMatch::None;
+        // ChangedField bits of the cells that differ between the two windows.
+        uint8_t fields = 0;
+    };
+
+    struct SnapshotComparison
+    {
+        std::shared_ptr<const InspectorSnapshot> left;
+        std::shared_ptr<const InspectorSnapshot> right;
+        std::vector<WindowRef> leftWindows;
+        std::vector<WindowRef> rightWindows;
+        // The right snapshot's windows in order, with each left-only window placed after the last window
+        // before it (in the left snapshot) that has a partner.
+        std::vector<CompareRow> rows;
+        std::array<size_t, kCompareKindCount> kinds{};
+        std::array<size_t, kCompareMatchCount> matches{};
+        double milliseconds = 0.0;
+
+        const WindowInfo* LeftWindow(const CompareRow& row) const
+        {
+            return row.left != CompareRow::kNone ? &WindowAt(*left, leftWindows[row.left]) : nullptr;
+        }
+
+        const WindowInfo* RightWindow(const CompareRow& row) const
+        {
+            return row.right != CompareRow::kNone ? &WindowAt(*right, rightWindows[row.right]) : nullptr;
+        }
+
+        static const WindowInfo& WindowAt(const InspectorSnapshot& snapshot, const WindowRef& ref)
+        {
+            return snapshot.processes[ref.process].windows[ref.window];
+        }
+    };
+
+    // Build side of a hash join: an open-addressed table from a 64-bit key to the chain of build items
+    // with that key, in the order they were added, so equal keys pair up in window order. Take() hands
+    // each item out once.
+    class CompareJoinTable
+    {
+    public:
+        static constexpr uint32_t kNone = CompareRow::kNone;
+
+        // `keys[item]` for every item in `items`; item numbers must be below keys.size().
+        void Build(const std::vector<uint64_t>& keys, const std::vector<uint32_t>& items)
+        {
+            size_t capacity = 16;
+            while (capacity < items.size() * 2)
+            {
+                capacity *= 2;
+            }
+            mSlotKeys.assign(capacity, 0);
+            mSlotHeads.assign(capacity, kEmpty);
+            mNext.resize(keys.size());
+            // Back to front, so pushing onto the chain's head leaves each chain in item order.
+            for (auto it = items.rbegin(); it != items.rend(); ++it)
+            {
+                const size_t slot = Find(keys[*it]);
+                mSlotKeys[slot] = keys[*it];
+                mNext[*it] = mSlotHeads[slot] == kEmpty ? kNone : mSlotHeads[slot];
+                mSlotHeads[slot] = *it;
+            }
+        }
+
+        // First item not yet taken with `key`, or kNone.
+        uint32_t Peek(uint64_t key) const
+        {
+            const uint32_t head = mSlotHeads[Find(key)];
+            return head == kEmpty ? kNone : head;
+        }
+
+        uint32_t Take(uint64_t key)
+        {
+            const size_t slot = Find(key);
+            const uint32_t head = mSlotHeads[slot];
+            if (head == kEmpty || head == kNone)
+            {
+                return kNone;
+            }
+            mSlotHeads[slot] = mNext[head];
+            return head;
+        }
+
+    private:
+        // Marks a slot no key was ever stored in; a slot whose chain ran out holds kNone instead.
+        static constexpr uint32_t kEmpty = 0xFFFFFFFEu;
+
+        size_t Find(uint64_t key) const
+        {
+            uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+            size_t slot = static_cast<size_t>(hash) & (mSlotKeys.size() - 1);
+            while (mSlotHeads[slot] != kEmpty && mSlotKeys[slot] != key)
+            {
+                slot = (slot + 1) & (mSlotKeys.size() - 1);
+            }
+            return slot;
+        }
+
+        std::vector<uint64_t> mSlotKeys;
+        std::vector<uint32_t> mSlotHeads;
+        std::vector<uint32_t> mNext;
+    };
+
+    // Aligns the windows of two snapshots. Three hash joins run over the windows still unpaired: by
+    // handle (when the pid also agrees, since handles are reused), by (pid, class, title), and by
+    // (pid, class), the last pairing windows whose title changed. Each join builds a table over the
+    // left windows and probes it with the right ones, so the whole comparison is linear in the window
+    // count. Cells are compared through WindowInfo::hashes. `progress` is raised to 1000 by the end;
+    // returns false, leaving `out` incomplete, once `cancel` is set.
+    inline bool CompareSnapshots(std::shared_ptr<const InspectorSnapshot> left, std::shared_ptr<const InspectorSnapshot> right,
+                                 SnapshotComparison& out, std::atomic<uint32_t>& progress, const std::atomic<bool>& cancel)
+    {
+        constexpr uint32_t kSteps = 5;
+        constexpr size_t kCheckInterval = 16384;
+        const auto start = std::chrono::steady_clock::now();
+        out = SnapshotComparison{};
+        out.left = std::move(left);
+        out.right = std::move(right);
+
+        // Step `step` of kSteps is `done` out of `total` items in; false once cancelled.
+        const auto report = [&](uint32_t step, size_t done, size_t total) {
+            const uint64_t within = total != 0 ? static_cast<uint64_t>(done) * 1000 / total : 1000;
+            progress.store(static_cast<uint32_t>((step * 1000 + within) / kSteps), std::memory_order_relaxed);
+            return !cancel.load(std::memory_order_relaxed);
+        };
+
+        const auto flatten = [](const InspectorSnapshot& snapshot, std::vector<WindowRef>& windows) {
+            windows.reserve(snapshot.totalWindowCount);
+            for (uint32_t process = 0; process < snapshot.processes.size(); ++process)
+            {
+                for (uint32_t window = 0; window < snapshot.processes[process].windows.size(); ++window)
+                {
+                    windows.push_back(WindowRef{process, window});
+                }
+            }
+        };
+        flatten(*out.left, out.leftWindows);
+        flatten(*out.right, out.rightWindows);
+        const size_t leftCount = out.leftWindows.size();
+        const size_t rightCount = out.rightWindows.size();
+
+        std::vector<uint32_t> leftPartner(leftCount, CompareRow::kNone);
+        std::vector<uint32_t> rightPartner(rightCount, CompareRow::kNone);
+        std::vector<CompareMatch> rightMatch(rightCount, CompareMatch::None);
+        std::vector<uint64_t> keys(leftCount);
+        std::vector<uint32_t> unpaired(leftCount);
+        for (uint32_t item = 0; item < leftCount; ++item)
+        {
+            unpaired[item] = item;
+        }
+
+        CompareJoinTable table;
+        const auto keyOf = [](CompareMatch match, const WindowInfo& window) {
+            if (match == CompareMatch::Handle)
+            {
+                return static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(window.handle));
+            }
+            const uint64_t fields[3] = {window.pid, window.hashes.className, match == CompareMatch::Title ? window.hashes.title : 0};
+            return HashBytes(fields, sizeof(fields));
+        };
+        for (const CompareMatch match : {CompareMatch::Handle, CompareMatch::Title, CompareMatch::Class})
+        {
+            const auto step = static_cast<uint32_t>(match) - 1;
+            if (unpaired.empty())
+            {
+                break;
+            }
+            for (const uint32_t item : unpaired)
+            {
+                keys[item] = keyOf(match, SnapshotComparison::WindowAt(*out.left, out.leftWindows[item]));
+            }
+            table.Build(keys, unpaired);
+
+            for (uint32_t item = 0; item < rightCount; ++item)
+            {
+                if (item % kCheckInterval == 0 && !report(step, item, rightCount))
+                {
+                    return false;
+                }
+                if (rightPartner[item] != CompareRow::kNone)
+                {
+                    continue;
+                }
+                const WindowInfo& window = SnapshotComparison::WindowAt(*out.right, out.rightWindows[item]);
+                const uint64_t key = keyOf(match, window);
+                const uint32_t partner = table.Peek(key);
+                if (partner == CompareRow::kNone ||
+                    (match == CompareMatch::Handle && SnapshotComparison::WindowAt(*out.left, out.leftWindows[partner]).pid != window.pid))
+                {
+                    continue;
+                }
+                table.Take(key);
+                leftPartner[partner] = item;
+                rightPartner[item] = partner;
+                rightMatch[item] = match;
+            }
+            unpaired.erase(std::remove_if(unpaired.begin(), unpaired.end(), [&leftPartner](uint32_t item) { return leftPartner[item] != CompareRow::kNone; }),
+                           unpaired.end());
+        }
+
+        // Left-only windows keyed by (right number of the nearest paired window before them, left number).
+        std::vector<std::pair<uint64_t, uint32_t>> removed;
+        removed.reserve(unpaired.size());
+        uint64_t anchor = 0;
+        for (uint32_t item = 0; item < leftCount; ++item)
+        {
+            if (item % kCheckInterval == 0 && !report(3, item, leftCount))
+            {
+                return false;
+            }
+            if (leftPartner[item] != CompareRow::kNone)
+            {
+                anchor = static_cast<uint64_t>(leftPartner[item]) + 1;
+            }
+            else
+            {
+                removed.emplace_back(anchor << 32 | item, item);
+            }
+        }
+        std::sort(removed.begin(), removed.end());
+
+        out.rows.reserve(rightCount + removed.size());
+        auto nextRemoved = removed.begin();
+        const auto addRemovedUpTo = [&](uint64_t anchorLimit) {
+            for (; nextRemoved != removed.end() && (nextRemoved->first >> 32) <= anchorLimit; ++nextRemoved)
+            {
+                CompareRow row;
+                row.left = nextRemoved->second;
+                row.kind = CompareKind::Removed;
+                out.rows.push_back(row);
+            }
+        };
+        addRemovedUpTo(0);
+        for (uint32_t item = 0; item < rightCount; ++item)
+        {
+            if (item % kCheckInterval == 0 && !report(4, item, rightCount))
+            {
+                return false;
+            }
+            CompareRow row;
+            row.right = item;
+            row.left = rightPartner[item];
+            row.match = rightMatch[item];
+            if (row.left == CompareRow::kNone)
+            {
+                row.kind = CompareKind::Added;
+            }
+            else
+            {
+                row.fields = ChangedFields(out.LeftWindow(row)->hashes, out.RightWindow(row)->hashes);
+                row.kind = row.fields != 0 || row.match != CompareMatch::Handle ? CompareKind::Changed : CompareKind::Same;
+            }
+            out.rows.push_back(row);
+            addRemovedUpTo(static_cast<uint64_t>(item) + 1);
+        }
+
+        for (const CompareRow& row : out.rows)
+        {
+            ++out.kinds[static_cast<size_t>(row.kind)];
+            ++out.matches[static_cast<size_t>(row.match)];
+        }
+        out.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        progress.store(1000, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Runs CompareSnapshots on a worker thread. The snapshots are shared, so the UI may replace its own
+    // while a comparison runs; starting another one cancels the one in flight.
+    class SnapshotComparer
+    {
+    public:
+        ~SnapshotComparer()
+        {
+            Cancel();
+        }
+
+        void Start(std::shared_ptr<const InspectorSnapshot> left, std::shared_ptr<const InspectorSnapshot> right)
+        {
+            Cancel();
+            mCancel.store(false);
+            mProgress.store(0);
+            mRunning = std::async(std::launch::async, [this, left = std::move(left), right = std::move(right)]() mutable {
+                auto result = std::make_unique<SnapshotComparison>();
+                if (!CompareSnapshots(std::move(left), std::move(right), *result, mProgress, mCancel))
+                {
+                    result.reset();
+                }
+                return result;
+            });
+        }
+
+        void Cancel()
+        {
+            if (mRunning.valid())
+            {
+                mCancel.store(true);
+                mRunning.wait();
+                mRunning = {};
+            }
+        }
+
+        bool Running() const
+        {
+            return mRunning.valid();
+        }
+
+        // Fraction of the running comparison done, 0 to 1.
+        float Progress() const
+        {
+            return static_cast<float>(mProgress.load(std::memory_order_relaxed)) / 1000.0f;
+        }
+
+        // Takes a finished comparison; true when a new result arrived this call.
+        bool Poll()
+        {
+            if (!mRunning.valid() || mRunning.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                return false;
+            }
+            std::unique_ptr<SnapshotComparison> result = mRunning.get();
+            if (result == nullptr)
+            {
+                return false;
+            }
+            mResult = std::move(result);
+            return true;
+        }
+
+        // Latest finished comparison, or null.
+        const SnapshotComparison* Result() const
+        {
+            return mResult.get();
+        }
+
+    private:
+        std::future<std::unique_ptr<SnapshotComparison>> mRunning;
+        std::atomic<uint32_t> mProgress{0};
+        std::atomic<bool> mCancel{false};
+        std::unique_ptr<SnapshotComparison> mResult;
+    };
+}
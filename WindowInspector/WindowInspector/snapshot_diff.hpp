@@ -0,0 +1,237 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <chrono>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+
+namespace Inspector
+{
+    enum class RowChange : uint8_t
+    {
+        None,
+        Added,
+        Changed
+    };
+
+    // Bits of SnapshotDiff::Change::fields, one per table cell.
+    namespace ChangedField
+    {
+        constexpr uint8_t Title = 1u << 0;
+        constexpr uint8_t Class = 1u << 1;
+        constexpr uint8_t State = 1u << 2;
+        constexpr uint8_t Styles = 1u << 3;
+        constexpr uint8_t Bounds = 1u << 4;
+    }
+
+    // ChangedField bits of the cells whose hashes differ.
+    inline uint8_t ChangedFields(const WindowHashes& before, const WindowHashes& after)
+    {
+        uint8_t fields = 0;
+        fields |= after.title != before.title ? ChangedField::Title : 0;
+        fields |= after.className != before.className ? ChangedField::Class : 0;
+        fields |= after.state != before.state ? ChangedField::State : 0;
+        fields |= after.styles != before.styles ? ChangedField::Styles : 0;
+        fields |= after.bounds != before.bounds ? ChangedField::Bounds : 0;
+        return fields;
+    }
+
+    struct RemovedWindow
+    {
+        HWND handle = nullptr;
+        DWORD pid = 0;
+        std::string titleUtf8;
+        std::string classNameUtf8;
+        RECT bounds{0, 0, 0, 0};
+    };
+
+    // What changed between the two most recent snapshots, per SpatialIndex slot. Each window's fields are
+    // hashed once when the snapshot is built (WindowInfo::hashes); a refresh compares those hashes slot by
+    // slot, so an unchanged window costs five integer compares and no string is touched. Titles and classes
+    // are copied only for new or renamed windows, so removed windows can still be listed after their
+    // snapshot is gone.
+    class SnapshotDiff
+    {
+    public:
+        // How long the UI keeps highlighting the last refresh's changes.
+        static constexpr double kFadeSeconds = 3.0;
+
+        struct Change
+        {
+            RowChange row = RowChange::None;
+            uint8_t fields = 0;
+        };
+
+        struct UpdateStats
+        {
+            size_t added = 0;
+            size_t removed = 0;
+            size_t changed = 0;
+            double milliseconds = 0.0;
+
+            bool Any() const
+            {
+                return added != 0 || removed != 0 || changed != 0;
+            }
+        };
+
+        // `index` must already be updated for `snapshot`. `now` (seconds, any clock) stamps the changes for Fade().
+        // The first snapshot only sets the baseline.
+        void Update(const InspectorSnapshot& snapshot, const SpatialIndex& index, double now)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const bool baseline = mGeneration == 0;
+            mGeneration = snapshot.generation;
+            mChangedAt = now;
+            mLastUpdate = {};
+            mRemoved.clear();
+            mTouched.clear();
+
+            const size_t slotCount = index.SlotCount();
+            if (mState.size() < slotCount)
+            {
+                // Headroom: a refresh adds windows before the index frees the slots of removed ones, and
+                // moving every last-seen string on each small growth would cost more than the diff itself.
+                if (mState.capacity() < slotCount)
+                {
+                    mState.reserve(slotCount + slotCount / 8);
+                    mLastSeen.reserve(slotCount + slotCount / 8);
+                }
+                mState.resize(slotCount);
+                mLastSeen.resize(slotCount);
+            }
+            for (uint32_t slot = 0; slot < slotCount; ++slot)
+            {
+                const SpatialIndex::Entry& entry = index.EntryAt(slot);
+                const WindowInfo* window = entry.live ? &snapshot.processes[entry.ref.process].windows[entry.ref.window] : nullptr;
+                SlotState& state = mState[slot];
+                bool touched = false;
+                // A handle recycled into another process keeps its slot but not its WindowInfo::id.
+                if (state.live && (window == nullptr || state.handle != entry.handle || state.id != window->id))
+                {
+                    mRemoved.push_back(std::move(mLastSeen[slot]));
+                    mLastSeen[slot] = RemovedWindow{};
+                    state = SlotState{};
+                    touched = true;
+                }
+                if (window == nullptr)
+                {
+                    if (touched)
+                    {
+                        mTouched.push_back(slot);
+                    }
+                    continue;
+                }
+
+                const WindowHashes& hashes = window->hashes;
+                uint8_t fields = 0;
+                if (!state.live)
+                {
+                    state.live = true;
+                    state.handle = window->handle;
+                    state.id = window->id;
+                    state.change = Change{baseline ? RowChange::None : RowChange::Added, 0};
+                    mLastUpdate.added += baseline ? 0 : 1;
+                    fields = ChangedField::Title | ChangedField::Class | ChangedField::State | ChangedField::Bounds;
+                }
+                else
+                {
+                    fields = ChangedFields(state.hashes, hashes);
+                    state.change = Change{fields != 0 ? RowChange::Changed : RowChange::None, fields};
+                    mLastUpdate.changed += fields != 0 ? 1 : 0;
+                }
+                state.hashes = hashes;
+                if (fields != 0)
+                {
+                    UpdateLastSeen(mLastSeen[slot], *window, fields);
+                    touched = true;
+                }
+                if (touched)
+                {
+                    mTouched.push_back(slot);
+                }
+            }
+            mLastUpdate.removed = mRemoved.size();
+            mLastUpdate.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        Change ChangeFor(uint32_t slot) const
+        {
+            return slot < mState.size() && mState[slot].live ? mState[slot].change : Change{};
+        }
+
+        // Highlight strength at `now`: 1 right after a refresh, 0 once kFadeSeconds have passed.
+        float Fade(double now) const
+        {
+            const double age = now - mChangedAt;
+            return age < 0.0 || age >= kFadeSeconds ? 0.0f : static_cast<float>(1.0 - age / kFadeSeconds);
+        }
+
+        // Windows the latest snapshot no longer lists.
+        const std::vector<RemovedWindow>& Removed() const
+        {
+            return mRemoved;
+        }
+
+        // Slots whose window was added, removed, replaced (another handle or another WindowInfo::id) or
+        // changed by the last Update, in slot order.
+        // Everything else is exactly as it was, which is what lets WindowStats follow a refresh in
+        // proportion to what changed.
+        const std::vector<uint32_t>& TouchedSlots() const
+        {
+            return mTouched;
+        }
+
+        const UpdateStats& LastUpdate() const
+        {
+            return mLastUpdate;
+        }
+
+        // Generation of the snapshot the last Update diffed; 0 before the first one.
+        uint64_t Generation() const
+        {
+            return mGeneration;
+        }
+
+    private:
+        // Compared for every window on every refresh; the strings live apart in mLastSeen.
+        struct SlotState
+        {
+            HWND handle = nullptr;
+            uint32_t id = kNoIdentity;
+            bool live = false;
+            Change change;
+            WindowHashes hashes;
+        };
+
+        static void UpdateLastSeen(RemovedWindow& seen, const WindowInfo& window, uint8_t fields)
+        {
+            seen.handle = window.handle;
+            seen.pid = window.pid;
+            seen.bounds = window.bounds;
+            if ((fields & ChangedField::Title) != 0)
+            {
+                seen.titleUtf8 = window.titleUtf8;
+            }
+            if ((fields & ChangedField::Class) != 0)
+            {
+                seen.classNameUtf8 = window.classNameUtf8;
+            }
+        }
+
+        uint64_t mGeneration = 0;
+        double mChangedAt = -kFadeSeconds;
+        std::vector<SlotState> mState;
+        // How each live window looked when last seen, handed to mRemoved once it is gone.
+        std::vector<RemovedWindow> mLastSeen;
+        std::vector<RemovedWindow> mRemoved;
+        std::vector<uint32_t> mTouched;
+        UpdateStats mLastUpdate;
+    };
+}
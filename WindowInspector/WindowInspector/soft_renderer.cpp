@@ -0,0 +1,552 @@
+#include "soft_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INSPECTOR_RASTER_SSE2 1
+#endif
+
+namespace
+{
+    inline uint32_t Channel(uint32_t color, int shift)
+    {
+        return (color >> shift) & 0xFF;
+    }
+
+    // (x + 128) * 257 >> 16 == round(x / 255) for x <= 255 * 255.
+    inline uint32_t Div255(uint32_t x)
+    {
+        return ((x + 128) * 257) >> 16;
+    }
+
+    inline uint32_t Modulate(uint32_t a, uint32_t b)
+    {
+        return Div255(Channel(a, 0) * Channel(b, 0)) |
+               (Div255(Channel(a, 8) * Channel(b, 8)) << 8) |
+               (Div255(Channel(a, 16) * Channel(b, 16)) << 16) |
+               (Div255(Channel(a, 24) * Channel(b, 24)) << 24);
+    }
+
+    // Same as the DX11 backend: colour = src * srcA + dst * (1 - srcA), alpha = srcA + dstA * (1 - srcA).
+    inline uint32_t Blend(uint32_t src, uint32_t dst)
+    {
+        const uint32_t alpha = Channel(src, 24);
+        if (alpha == 255)
+        {
+            return src;
+        }
+        if (alpha == 0)
+        {
+            return dst;
+        }
+
+        const uint32_t inverse = 255 - alpha;
+        return Div255(Channel(src, 0) * alpha + Channel(dst, 0) * inverse) |
+               (Div255(Channel(src, 8) * alpha + Channel(dst, 8) * inverse) << 8) |
+               (Div255(Channel(src, 16) * alpha + Channel(dst, 16) * inverse) << 16) |
+               (Div255(alpha * 255 + Channel(dst, 24) * inverse) << 24);
+    }
+
+    void BlendSpan(uint32_t* dst, int count, uint32_t color)
+    {
+        const uint32_t alpha = Channel(color, 24);
+        if (alpha == 0)
+        {
+            return;
+        }
+        if (alpha == 255)
+        {
+            std::fill(dst, dst + count, color);
+            return;
+        }
+
+        int i = 0;
+#if defined(INSPECTOR_RASTER_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i inverse = _mm_set1_epi16(static_cast<short>(255 - alpha));
+        const __m128i bias = _mm_set1_epi16(257);
+        const short r = static_cast<short>(Channel(color, 0) * alpha + 128);
+        const short g = static_cast<short>(Channel(color, 8) * alpha + 128);
+        const short b = static_cast<short>(Channel(color, 16) * alpha + 128);
+        const short a = static_cast<short>(alpha * 255 + 128);
+        const __m128i source = _mm_setr_epi16(r, g, b, a, r, g, b, a);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i low = _mm_unpacklo_epi8(pixels, zero);
+            __m128i high = _mm_unpackhi_epi8(pixels, zero);
+            low = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(low, inverse), source), bias);
+            high = _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(high, inverse), source), bias);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(low, high));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            dst[i] = Blend(color, dst[i]);
+        }
+    }
+
+    inline uint32_t SampleNearest(const ImTextureData* texture, float u, float v)
+    {
+        if (texture == nullptr || texture->Pixels == nullptr)
+        {
+            return 0xFFFFFFFFu;
+        }
+
+        const int x = std::clamp(static_cast<int>(u * static_cast<float>(texture->Width)), 0, texture->Width - 1);
+        const int y = std::clamp(static_cast<int>(v * static_cast<float>(texture->Height)), 0, texture->Height - 1);
+        if (texture->Format == ImTextureFormat_Alpha8)
+        {
+            return 0x00FFFFFFu | (static_cast<uint32_t>(texture->Pixels[y * texture->Width + x]) << 24);
+        }
+
+        uint32_t texel = 0;
+        std::memcpy(&texel, texture->Pixels + (static_cast<size_t>(y) * texture->Width + x) * 4, sizeof(texel));
+        return texel;
+    }
+
+    inline uint32_t LerpColor(const float weights[3], const uint32_t colors[3])
+    {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            const float value = weights[0] * static_cast<float>(Channel(colors[0], shift)) +
+                                weights[1] * static_cast<float>(Channel(colors[1], shift)) +
+                                weights[2] * static_cast<float>(Channel(colors[2], shift));
+            result |= static_cast<uint32_t>(std::clamp(static_cast<int>(value + 0.5f), 0, 255)) << shift;
+        }
+        return result;
+    }
+}
+
+namespace Inspector
+{
+    void SoftFramebuffer::Resize(int newWidth, int newHeight)
+    {
+        width = std::max(0, newWidth);
+        height = std::max(0, newHeight);
+        pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    }
+
+    void SoftFramebuffer::Clear(uint32_t color)
+    {
+        std::fill(pixels.begin(), pixels.end(), color);
+    }
+
+    bool SoftFramebuffer::WritePpm(const char* path) const
+    {
+        FILE* file = std::fopen(path, "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+        std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const uint32_t pixel = pixels[static_cast<size_t>(y) * width + x];
+                row[static_cast<size_t>(x) * 3 + 0] = static_cast<unsigned char>(Channel(pixel, 0));
+                row[static_cast<size_t>(x) * 3 + 1] = static_cast<unsigned char>(Channel(pixel, 8));
+                row[static_cast<size_t>(x) * 3 + 2] = static_cast<unsigned char>(Channel(pixel, 16));
+            }
+            std::fwrite(row.data(), 1, row.size(), file);
+        }
+        return std::fclose(file) == 0;
+    }
+
+    bool SoftFramebuffer::ReadPpm(const char* path)
+    {
+        FILE* file = std::fopen(path, "rb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        int fileWidth = 0;
+        int fileHeight = 0;
+        int maxValue = 0;
+        if (std::fscanf(file, "P6 %d %d %d", &fileWidth, &fileHeight, &maxValue) != 3 || maxValue != 255 || std::fgetc(file) == EOF)
+        {
+            std::fclose(file);
+            return false;
+        }
+
+        Resize(fileWidth, fileHeight);
+        std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+        bool ok = true;
+        for (int y = 0; y < height && ok; ++y)
+        {
+            ok = std::fread(row.data(), 1, row.size(), file) == row.size();
+            for (int x = 0; x < width && ok; ++x)
+            {
+                pixels[static_cast<size_t>(y) * width + x] = row[static_cast<size_t>(x) * 3] |
+                                                             (static_cast<uint32_t>(row[static_cast<size_t>(x) * 3 + 1]) << 8) |
+                                                             (static_cast<uint32_t>(row[static_cast<size_t>(x) * 3 + 2]) << 16) | 0xFF000000u;
+            }
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    size_t CountMismatchedPixels(const SoftFramebuffer& a, const SoftFramebuffer& b, int tolerance)
+    {
+        if (a.width != b.width || a.height != b.height)
+        {
+            return std::max(a.pixels.size(), b.pixels.size());
+        }
+
+        size_t mismatched = 0;
+        for (size_t i = 0; i < a.pixels.size(); ++i)
+        {
+            for (int shift = 0; shift < 24; shift += 8)
+            {
+                if (std::abs(static_cast<int>(Channel(a.pixels[i], shift)) - static_cast<int>(Channel(b.pixels[i], shift))) > tolerance)
+                {
+                    ++mismatched;
+                    break;
+                }
+            }
+        }
+        return mismatched;
+    }
+
+    SoftRenderer::SoftRenderer(unsigned workerCount)
+    {
+        if (workerCount == 0)
+        {
+            const unsigned hardware = std::thread::hardware_concurrency();
+            workerCount = hardware > 1 ? hardware - 1 : 0;
+        }
+        mWorkers.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i)
+        {
+            mWorkers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    SoftRenderer::~SoftRenderer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+        for (auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    void SoftRenderer::UpdateTextures(ImDrawData* drawData)
+    {
+        if (drawData == nullptr || drawData->Textures == nullptr)
+        {
+            return;
+        }
+
+        for (ImTextureData* texture : *drawData->Textures)
+        {
+            if (texture->Status == ImTextureStatus_WantCreate)
+            {
+                texture->SetTexID(static_cast<ImTextureID>(reinterpret_cast<intptr_t>(texture)));
+                texture->SetStatus(ImTextureStatus_OK);
+            }
+            else if (texture->Status == ImTextureStatus_WantUpdates)
+            {
+                texture->SetStatus(ImTextureStatus_OK);
+            }
+            else if (texture->Status == ImTextureStatus_WantDestroy && texture->UnusedFrames > 0)
+            {
+                texture->SetTexID(ImTextureID_Invalid);
+                texture->SetStatus(ImTextureStatus_Destroyed);
+            }
+        }
+    }
+
+    void SoftRenderer::Render(ImDrawData* drawData, SoftFramebuffer& target)
+    {
+        if (drawData == nullptr || target.width <= 0 || target.height <= 0)
+        {
+            return;
+        }
+
+        BinTriangles(drawData, target);
+        mTarget = &target;
+        mNextTile.store(0, std::memory_order_relaxed);
+        if (mWorkers.empty())
+        {
+            RasterizeTiles();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPendingWorkers = static_cast<int>(mWorkers.size());
+            ++mJobGeneration;
+        }
+        mWake.notify_all();
+        RasterizeTiles();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDone.wait(lock, [this]() { return mPendingWorkers == 0; });
+    }
+
+    void SoftRenderer::BinTriangles(ImDrawData* drawData, const SoftFramebuffer& target)
+    {
+        mTilesX = (target.width + kTileSize - 1) / kTileSize;
+        mTilesY = (target.height + kTileSize - 1) / kTileSize;
+        mBins.resize(static_cast<size_t>(mTilesX) * static_cast<size_t>(mTilesY));
+        for (auto& bin : mBins)
+        {
+            bin.clear();
+        }
+        mTriangles.clear();
+        mTriangles.reserve(static_cast<size_t>(drawData->TotalIdxCount / 3));
+
+        const ImVec2 offset = drawData->DisplayPos;
+        const ImVec2 scale = drawData->FramebufferScale;
+        for (const ImDrawList* list : drawData->CmdLists)
+        {
+            const ImDrawVert* vertices = list->VtxBuffer.Data;
+            const ImDrawIdx* indices = list->IdxBuffer.Data;
+            for (const ImDrawCmd& cmd : list->CmdBuffer)
+            {
+                if (cmd.UserCallback != nullptr)
+                {
+                    if (cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                    {
+                        cmd.UserCallback(list, &cmd);
+                    }
+                    continue;
+                }
+
+                const int clipMinX = std::max(0, static_cast<int>((cmd.ClipRect.x - offset.x) * scale.x));
+                const int clipMinY = std::max(0, static_cast<int>((cmd.ClipRect.y - offset.y) * scale.y));
+                const int clipMaxX = std::min(target.width, static_cast<int>((cmd.ClipRect.z - offset.x) * scale.x));
+                const int clipMaxY = std::min(target.height, static_cast<int>((cmd.ClipRect.w - offset.y) * scale.y));
+                if (clipMaxX <= clipMinX || clipMaxY <= clipMinY)
+                {
+                    continue;
+                }
+
+                for (unsigned int e = 0; e + 2 < cmd.ElemCount; e += 3)
+                {
+                    Triangle triangle;
+                    triangle.clipMinX = clipMinX;
+                    triangle.clipMinY = clipMinY;
+                    triangle.clipMaxX = clipMaxX;
+                    triangle.clipMaxY = clipMaxY;
+                    triangle.texture = cmd.TexRef._TexData;
+
+                    float minX = 1.0e9f;
+                    float minY = 1.0e9f;
+                    float maxX = -1.0e9f;
+                    float maxY = -1.0e9f;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const ImDrawVert& source = vertices[cmd.VtxOffset + indices[cmd.IdxOffset + e + k]];
+                        Vertex& vertex = triangle.v[k];
+                        vertex.x = (source.pos.x - offset.x) * scale.x;
+                        vertex.y = (source.pos.y - offset.y) * scale.y;
+                        vertex.u = source.uv.x;
+                        vertex.v = source.uv.y;
+                        vertex.color = source.col;
+                        minX = std::min(minX, vertex.x);
+                        minY = std::min(minY, vertex.y);
+                        maxX = std::max(maxX, vertex.x);
+                        maxY = std::max(maxY, vertex.y);
+                    }
+
+                    const int x0 = std::max(clipMinX, static_cast<int>(std::floor(minX)));
+                    const int y0 = std::max(clipMinY, static_cast<int>(std::floor(minY)));
+                    const int x1 = std::min(clipMaxX, static_cast<int>(std::ceil(maxX)));
+                    const int y1 = std::min(clipMaxY, static_cast<int>(std::ceil(maxY)));
+                    if (x1 <= x0 || y1 <= y0)
+                    {
+                        continue;
+                    }
+
+                    const uint32_t index = static_cast<uint32_t>(mTriangles.size());
+                    mTriangles.push_back(triangle);
+                    for (int ty = y0 / kTileSize; ty <= (y1 - 1) / kTileSize; ++ty)
+                    {
+                        for (int tx = x0 / kTileSize; tx <= (x1 - 1) / kTileSize; ++tx)
+                        {
+                            mBins[static_cast<size_t>(ty) * mTilesX + tx].push_back(index);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void SoftRenderer::RasterizeTiles()
+    {
+        const int tileCount = mTilesX * mTilesY;
+        for (int tile = mNextTile.fetch_add(1, std::memory_order_relaxed); tile < tileCount; tile = mNextTile.fetch_add(1, std::memory_order_relaxed))
+        {
+            RasterizeTile(tile);
+        }
+    }
+
+    void SoftRenderer::WorkerLoop()
+    {
+        uint64_t seenGeneration = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWake.wait(lock, [&]() { return mStopping || mJobGeneration != seenGeneration; });
+                if (mStopping)
+                {
+                    return;
+                }
+                seenGeneration = mJobGeneration;
+            }
+
+            RasterizeTiles();
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (--mPendingWorkers == 0)
+            {
+                mDone.notify_one();
+            }
+        }
+    }
+
+    void SoftRenderer::RasterizeTile(int tile) const
+    {
+        const auto& bin = mBins[static_cast<size_t>(tile)];
+        if (bin.empty())
+        {
+            return;
+        }
+
+        SoftFramebuffer& target = *mTarget;
+        const int tileMinX = (tile % mTilesX) * kTileSize;
+        const int tileMinY = (tile / mTilesX) * kTileSize;
+        const int tileMaxX = std::min(target.width, tileMinX + kTileSize);
+        const int tileMaxY = std::min(target.height, tileMinY + kTileSize);
+
+        for (const uint32_t index : bin)
+        {
+            const Triangle& triangle = mTriangles[index];
+            const Vertex* v0 = &triangle.v[0];
+            const Vertex* v1 = &triangle.v[1];
+            const Vertex* v2 = &triangle.v[2];
+            float area = (v1->x - v0->x) * (v2->y - v0->y) - (v2->x - v0->x) * (v1->y - v0->y);
+            if (area == 0.0f)
+            {
+                continue;
+            }
+            if (area < 0.0f)
+            {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            const int minX = std::max(tileMinX, triangle.clipMinX);
+            const int minY = std::max(tileMinY, triangle.clipMinY);
+            const int maxX = std::min(tileMaxX, triangle.clipMaxX);
+            const int maxY = std::min(tileMaxY, triangle.clipMaxY);
+            if (maxX <= minX || maxY <= minY)
+            {
+                continue;
+            }
+
+            // Edge i is opposite vertex i; E_i(x, y) = a_i * x + b_i * y + c_i is >= 0 inside.
+            const Vertex* corners[3] = {v0, v1, v2};
+            float edgeA[3];
+            float edgeB[3];
+            float edgeC[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                const Vertex* from = corners[(i + 1) % 3];
+                const Vertex* to = corners[(i + 2) % 3];
+                edgeA[i] = from->y - to->y;
+                edgeB[i] = to->x - from->x;
+                edgeC[i] = from->x * to->y - from->y * to->x;
+            }
+
+            const bool flatColor = v0->color == v1->color && v1->color == v2->color;
+            const bool flatUv = v0->u == v1->u && v1->u == v2->u && v0->v == v1->v && v1->v == v2->v;
+            const uint32_t flatTexel = flatUv ? SampleNearest(triangle.texture, v0->u, v0->v) : 0;
+            const uint32_t colors[3] = {v0->color, v1->color, v2->color};
+            const float inverseArea = 1.0f / area;
+
+            for (int y = minY; y < maxY; ++y)
+            {
+                const float sampleY = static_cast<float>(y) + 0.5f;
+                float left = static_cast<float>(minX);
+                float right = static_cast<float>(maxX);
+                bool empty = false;
+                for (int i = 0; i < 3 && !empty; ++i)
+                {
+                    const float rowC = edgeB[i] * sampleY + edgeC[i];
+                    if (edgeA[i] > 0.0f)
+                    {
+                        left = std::max(left, -rowC / edgeA[i]);
+                    }
+                    else if (edgeA[i] < 0.0f)
+                    {
+                        right = std::min(right, -rowC / edgeA[i]);
+                    }
+                    else if (rowC < 0.0f)
+                    {
+                        empty = true;
+                    }
+                }
+                if (empty)
+                {
+                    continue;
+                }
+
+                // Pixel centres in [left, right): shared edges between adjacent triangles are covered once.
+                const int startX = std::max(minX, static_cast<int>(std::ceil(left - 0.5f)));
+                const int endX = std::min(maxX, static_cast<int>(std::ceil(right - 0.5f)));
+                if (endX <= startX)
+                {
+                    continue;
+                }
+
+                uint32_t* row = target.pixels.data() + static_cast<size_t>(y) * target.width;
+                if (flatColor && flatUv)
+                {
+                    BlendSpan(row + startX, endX - startX, Modulate(v0->color, flatTexel));
+                    continue;
+                }
+
+                const float sampleX = static_cast<float>(startX) + 0.5f;
+                float weights[3];
+                float weightStep[3];
+                for (int i = 0; i < 3; ++i)
+                {
+                    weights[i] = (edgeA[i] * sampleX + edgeB[i] * sampleY + edgeC[i]) * inverseArea;
+                    weightStep[i] = edgeA[i] * inverseArea;
+                }
+
+                for (int x = startX; x < endX; ++x)
+                {
+                    const uint32_t texel = flatUv ? flatTexel
+                                                  : SampleNearest(triangle.texture,
+                                                                  weights[0] * v0->u + weights[1] * v1->u + weights[2] * v2->u,
+                                                                  weights[0] * v0->v + weights[1] * v1->v + weights[2] * v2->v);
+                    const uint32_t color = flatColor ? v0->color : LerpColor(weights, colors);
+                    row[x] = Blend(Modulate(color, texel), row[x]);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        weights[i] += weightStep[i];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "imgui/imgui.h"
+
+namespace Inspector
+{
+    // RGBA8 image in the same byte order as ImU32 colours (IM_COL32).
+    struct SoftFramebuffer
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint32_t> pixels;
+
+        void Resize(int newWidth, int newHeight);
+        void Clear(uint32_t color);
+        bool WritePpm(const char* path) const;
+        bool ReadPpm(const char* path);
+    };
+
+    // Pixels whose RGB differs by more than `tolerance` on any channel; size mismatches count every pixel.
+    size_t CountMismatchedPixels(const SoftFramebuffer& a, const SoftFramebuffer& b, int tolerance);
+
+    // CPU rasterizer for ImDrawData: textured, alpha-blended triangles with clip rects, matching the
+    // DX11 backend's blend state. Triangles are binned into fixed tiles in submission order, tiles are
+    // rasterized in parallel by a small worker pool, and flat-coloured spans use SSE2 blending.
+    class SoftRenderer
+    {
+    public:
+        static constexpr int kTileSize = 64;
+
+        // `workerCount` extra threads; 0 picks hardware_concurrency() - 1. The caller also rasterizes.
+        explicit SoftRenderer(unsigned workerCount = 0);
+        ~SoftRenderer();
+        SoftRenderer(const SoftRenderer&) = delete;
+        SoftRenderer& operator=(const SoftRenderer&) = delete;
+
+        // Acknowledges ImGuiBackendFlags_RendererHasTextures requests. Textures are sampled straight from
+        // ImTextureData::Pixels, so creation and updates need no copy.
+        static void UpdateTextures(ImDrawData* drawData);
+
+        // Draws into `target`, which must already be sized and cleared.
+        void Render(ImDrawData* drawData, SoftFramebuffer& target);
+
+        size_t LastTriangleCount() const
+        {
+            return mTriangles.size();
+        }
+
+    private:
+        struct Vertex
+        {
+            float x;
+            float y;
+            float u;
+            float v;
+            uint32_t color;
+        };
+
+        struct Triangle
+        {
+            Vertex v[3];
+            int clipMinX;
+            int clipMinY;
+            int clipMaxX;
+            int clipMaxY;
+            const ImTextureData* texture;
+        };
+
+        void BinTriangles(ImDrawData* drawData, const SoftFramebuffer& target);
+        void RasterizeTiles();
+        void RasterizeTile(int tile) const;
+        void WorkerLoop();
+
+        std::vector<Triangle> mTriangles;
+        std::vector<std::vector<uint32_t>> mBins;
+        int mTilesX = 0;
+        int mTilesY = 0;
+        SoftFramebuffer* mTarget = nullptr;
+
+        std::vector<std::thread> mWorkers;
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mDone;
+        uint64_t mJobGeneration = 0;
+        int mPendingWorkers = 0;
+        bool mStopping = false;
+        std::atomic<int> mNextTile{0};
+    };
+}
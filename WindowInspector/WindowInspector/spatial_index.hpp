@@ -0,0 +1,449 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+#include "snapshot.hpp"
+
+namespace Inspector
+{
+    // Uniform grid over every window rectangle in the snapshot, answering "what is under this point"
+    // and "what touches this region" without scanning all windows. Entries are keyed by HWND and kept
+    // across snapshots, so a refresh only re-buckets windows that appeared, vanished or moved; the grid
+    // is rebuilt only when a rectangle falls outside its current extent. Each cell is kept sorted by
+    // Z order, so point queries come out topmost-first and TopmostAt stops at the first hit.
+    class SpatialIndex
+    {
+    public:
+        static constexpr uint32_t kNoEntry = 0xFFFFFFFFu;
+        static constexpr LONG kMinCellSize = 256;
+        static constexpr LONG kMaxCellsPerAxis = 256;
+
+        struct Entry
+        {
+            HWND handle = nullptr;
+            RECT bounds{0, 0, 0, 0};
+            uint32_t zOrder = 0;
+            WindowRef ref;
+            uint64_t generation = 0;
+            bool indexed = false;
+            bool live = false;
+        };
+
+        struct UpdateStats
+        {
+            size_t added = 0;
+            size_t removed = 0;
+            size_t moved = 0;
+            bool rebuilt = false;
+        };
+
+        void Update(const InspectorSnapshot& snapshot)
+        {
+            if (snapshot.generation == mGeneration && !mEntries.empty())
+            {
+                return;
+            }
+
+            mGeneration = snapshot.generation;
+            mLastUpdate = {};
+            mPending.clear();
+            bool rebuild = mCells.empty();
+            bool reordered = false;
+            for (uint32_t p = 0; p < snapshot.processes.size(); ++p)
+            {
+                const auto& windows = snapshot.processes[p].windows;
+                for (uint32_t w = 0; w < windows.size(); ++w)
+                {
+                    const WindowInfo& window = windows[w];
+                    auto [it, inserted] = mSlotByHandle.try_emplace(window.handle, kNoEntry);
+                    if (inserted)
+                    {
+                        it->second = AllocateSlot();
+                        Entry& entry = mEntries[it->second];
+                        entry.handle = window.handle;
+                        entry.bounds = window.bounds;
+                        mPending.push_back(it->second);
+                        ++mLastUpdate.added;
+                    }
+                    else if (!SameRect(mEntries[it->second].bounds, window.bounds))
+                    {
+                        Unlink(it->second);
+                        mEntries[it->second].bounds = window.bounds;
+                        mPending.push_back(it->second);
+                        ++mLastUpdate.moved;
+                    }
+
+                    Entry& entry = mEntries[it->second];
+                    reordered |= entry.indexed && entry.zOrder != window.zOrder;
+                    entry.zOrder = window.zOrder;
+                    entry.ref = WindowRef{p, w};
+                    entry.generation = mGeneration;
+                }
+            }
+
+            for (uint32_t slot = 0; slot < mEntries.size(); ++slot)
+            {
+                Entry& entry = mEntries[slot];
+                if (entry.live && entry.generation != mGeneration)
+                {
+                    Unlink(slot);
+                    mSlotByHandle.erase(entry.handle);
+                    entry = Entry{};
+                    mFreeSlots.push_back(slot);
+                    ++mLastUpdate.removed;
+                }
+            }
+
+            for (const uint32_t slot : mPending)
+            {
+                if (!rebuild && IsIndexable(mEntries[slot].bounds) && !Fits(mEntries[slot].bounds))
+                {
+                    rebuild = true;
+                    break;
+                }
+            }
+
+            if (rebuild)
+            {
+                Rebuild();
+            }
+            else
+            {
+                for (const uint32_t slot : mPending)
+                {
+                    Link(slot, !reordered);
+                }
+                if (reordered)
+                {
+                    SortCells();
+                }
+            }
+            mLastUpdate.rebuilt = rebuild;
+        }
+
+        // Every window containing (x, y), topmost first.
+        void QueryPoint(LONG x, LONG y, std::vector<uint32_t>& out) const
+        {
+            out.clear();
+            const std::vector<uint32_t>* cell = CellAt(x, y);
+            if (cell == nullptr)
+            {
+                return;
+            }
+            for (const uint32_t slot : *cell)
+            {
+                if (Contains(mEntries[slot].bounds, x, y))
+                {
+                    out.push_back(slot);
+                }
+            }
+        }
+
+        // Topmost window containing (x, y), or kNoEntry.
+        uint32_t TopmostAt(LONG x, LONG y) const
+        {
+            return TopmostWhere(x, y, [](uint32_t) { return true; });
+        }
+
+        // Topmost window containing (x, y) that `accept(slot)` lets through, e.g. visible windows only.
+        template <typename Accept>
+        uint32_t TopmostWhere(LONG x, LONG y, Accept&& accept) const
+        {
+            const std::vector<uint32_t>* cell = CellAt(x, y);
+            if (cell == nullptr)
+            {
+                return kNoEntry;
+            }
+            for (const uint32_t slot : *cell)
+            {
+                if (Contains(mEntries[slot].bounds, x, y) && accept(slot))
+                {
+                    return slot;
+                }
+            }
+            return kNoEntry;
+        }
+
+        // Every window whose rectangle intersects `region`, topmost first.
+        void QueryRect(const RECT& region, std::vector<uint32_t>& out)
+        {
+            out.clear();
+            if (mCells.empty() || !IsIndexable(region))
+            {
+                return;
+            }
+
+            // A window spanning several cells is reported once: each query stamps what it has seen.
+            if (++mQueryStamp == 0)
+            {
+                std::fill(mStamps.begin(), mStamps.end(), 0u);
+                mQueryStamp = 1;
+            }
+            int x0, y0, x1, y1;
+            if (!CellRange(region, x0, y0, x1, y1))
+            {
+                return;
+            }
+            for (int cy = y0; cy <= y1; ++cy)
+            {
+                for (int cx = x0; cx <= x1; ++cx)
+                {
+                    for (const uint32_t slot : mCells[static_cast<size_t>(cy) * mCols + cx])
+                    {
+                        if (mStamps[slot] != mQueryStamp && Intersects(mEntries[slot].bounds, region))
+                        {
+                            mStamps[slot] = mQueryStamp;
+                            out.push_back(slot);
+                        }
+                    }
+                }
+            }
+            SortByZOrder(out);
+        }
+
+        const Entry& EntryAt(uint32_t slot) const
+        {
+            return mEntries[slot];
+        }
+
+        size_t Size() const
+        {
+            return mSlotByHandle.size();
+        }
+
+        // Upper bound for slot numbers, live or free.
+        size_t SlotCount() const
+        {
+            return mEntries.size();
+        }
+
+        uint32_t SlotOf(HWND handle) const
+        {
+            const auto it = mSlotByHandle.find(handle);
+            return it != mSlotByHandle.end() ? it->second : kNoEntry;
+        }
+
+        uint64_t Generation() const
+        {
+            return mGeneration;
+        }
+
+        const UpdateStats& LastUpdate() const
+        {
+            return mLastUpdate;
+        }
+
+        // Area covered by the grid: the union of all rectangles at the last rebuild plus a margin.
+        RECT Extent() const
+        {
+            return RECT{mOriginX, mOriginY, mOriginX + mCols * mCellSize, mOriginY + mRows * mCellSize};
+        }
+
+    private:
+        static bool SameRect(const RECT& a, const RECT& b)
+        {
+            return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+        }
+
+        static bool IsIndexable(const RECT& rect)
+        {
+            return rect.right > rect.left && rect.bottom > rect.top;
+        }
+
+        static bool Contains(const RECT& rect, LONG x, LONG y)
+        {
+            return x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom;
+        }
+
+        static bool Intersects(const RECT& a, const RECT& b)
+        {
+            return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+        }
+
+        void SortByZOrder(std::vector<uint32_t>& slots) const
+        {
+            std::sort(slots.begin(), slots.end(), [this](uint32_t a, uint32_t b) { return Above(a, b); });
+        }
+
+        uint32_t AllocateSlot()
+        {
+            uint32_t slot;
+            if (!mFreeSlots.empty())
+            {
+                slot = mFreeSlots.back();
+                mFreeSlots.pop_back();
+            }
+            else
+            {
+                slot = static_cast<uint32_t>(mEntries.size());
+                mEntries.emplace_back();
+                mStamps.push_back(0);
+            }
+            mEntries[slot].live = true;
+            return slot;
+        }
+
+        bool Fits(const RECT& rect) const
+        {
+            return !mCells.empty() && rect.left >= mOriginX && rect.top >= mOriginY &&
+                   rect.right <= mOriginX + mCols * mCellSize && rect.bottom <= mOriginY + mRows * mCellSize;
+        }
+
+        // Inclusive cell range covered by `rect`, clamped to the grid; false when it misses the grid.
+        bool CellRange(const RECT& rect, int& x0, int& y0, int& x1, int& y1) const
+        {
+            const LONG maxX = mOriginX + mCols * mCellSize;
+            const LONG maxY = mOriginY + mRows * mCellSize;
+            if (rect.right <= mOriginX || rect.bottom <= mOriginY || rect.left >= maxX || rect.top >= maxY)
+            {
+                return false;
+            }
+            x0 = static_cast<int>((std::max(rect.left, mOriginX) - mOriginX) / mCellSize);
+            y0 = static_cast<int>((std::max(rect.top, mOriginY) - mOriginY) / mCellSize);
+            x1 = static_cast<int>((std::min(rect.right, maxX) - 1 - mOriginX) / mCellSize);
+            y1 = static_cast<int>((std::min(rect.bottom, maxY) - 1 - mOriginY) / mCellSize);
+            return true;
+        }
+
+        const std::vector<uint32_t>* CellAt(LONG x, LONG y) const
+        {
+            if (mCells.empty() || x < mOriginX || y < mOriginY)
+            {
+                return nullptr;
+            }
+            const LONG cx = (x - mOriginX) / mCellSize;
+            const LONG cy = (y - mOriginY) / mCellSize;
+            if (cx >= mCols || cy >= mRows)
+            {
+                return nullptr;
+            }
+            return &mCells[static_cast<size_t>(cy) * mCols + cx];
+        }
+
+        bool Above(uint32_t a, uint32_t b) const
+        {
+            return mEntries[a].zOrder < mEntries[b].zOrder;
+        }
+
+        void SortCells()
+        {
+            for (auto& cell : mCells)
+            {
+                std::sort(cell.begin(), cell.end(), [this](uint32_t a, uint32_t b) { return Above(a, b); });
+            }
+        }
+
+        // `keepSorted` inserts in Z order; bulk callers append and sort once afterwards.
+        void Link(uint32_t slot, bool keepSorted)
+        {
+            Entry& entry = mEntries[slot];
+            int x0, y0, x1, y1;
+            if (!IsIndexable(entry.bounds) || !CellRange(entry.bounds, x0, y0, x1, y1))
+            {
+                return;
+            }
+            for (int cy = y0; cy <= y1; ++cy)
+            {
+                for (int cx = x0; cx <= x1; ++cx)
+                {
+                    auto& cell = mCells[static_cast<size_t>(cy) * mCols + cx];
+                    if (keepSorted)
+                    {
+                        cell.insert(std::upper_bound(cell.begin(), cell.end(), slot, [this](uint32_t a, uint32_t b) { return Above(a, b); }), slot);
+                    }
+                    else
+                    {
+                        cell.push_back(slot);
+                    }
+                }
+            }
+            entry.indexed = true;
+        }
+
+        void Unlink(uint32_t slot)
+        {
+            Entry& entry = mEntries[slot];
+            int x0, y0, x1, y1;
+            if (!entry.indexed || !CellRange(entry.bounds, x0, y0, x1, y1))
+            {
+                entry.indexed = false;
+                return;
+            }
+            for (int cy = y0; cy <= y1; ++cy)
+            {
+                for (int cx = x0; cx <= x1; ++cx)
+                {
+                    auto& cell = mCells[static_cast<size_t>(cy) * mCols + cx];
+                    const auto it = std::find(cell.begin(), cell.end(), slot);
+                    if (it != cell.end())
+                    {
+                        cell.erase(it);
+                    }
+                }
+            }
+            entry.indexed = false;
+        }
+
+        void Rebuild()
+        {
+            bool any = false;
+            RECT extent{0, 0, 0, 0};
+            for (const Entry& entry : mEntries)
+            {
+                if (!entry.live || !IsIndexable(entry.bounds))
+                {
+                    continue;
+                }
+                if (!any)
+                {
+                    extent = entry.bounds;
+                    any = true;
+                    continue;
+                }
+                extent.left = std::min(extent.left, entry.bounds.left);
+                extent.top = std::min(extent.top, entry.bounds.top);
+                extent.right = std::max(extent.right, entry.bounds.right);
+                extent.bottom = std::max(extent.bottom, entry.bounds.bottom);
+            }
+
+            // One spare cell of margin on each side absorbs small moves without another rebuild. Cells stay
+            // at least kMinCellSize so typical windows touch a handful of them, and the grid stays bounded
+            // even with minimized windows parked at (-32000, -32000).
+            extent = RECT{extent.left - kMinCellSize, extent.top - kMinCellSize, extent.right + kMinCellSize, extent.bottom + kMinCellSize};
+            const LONG width = std::max<LONG>(1, extent.right - extent.left);
+            const LONG height = std::max<LONG>(1, extent.bottom - extent.top);
+            mCellSize = std::max(kMinCellSize, (std::max(width, height) + kMaxCellsPerAxis - 1) / kMaxCellsPerAxis);
+            mOriginX = extent.left;
+            mOriginY = extent.top;
+            mCols = (width + mCellSize - 1) / mCellSize;
+            mRows = (height + mCellSize - 1) / mCellSize;
+            mCells.assign(static_cast<size_t>(mCols) * static_cast<size_t>(mRows), {});
+            for (uint32_t slot = 0; slot < mEntries.size(); ++slot)
+            {
+                mEntries[slot].indexed = false;
+                if (mEntries[slot].live)
+                {
+                    Link(slot, false);
+                }
+            }
+            SortCells();
+        }
+
+        uint64_t mGeneration = 0;
+        std::vector<Entry> mEntries;
+        std::vector<uint32_t> mFreeSlots;
+        std::unordered_map<HWND, uint32_t> mSlotByHandle;
+        std::vector<uint32_t> mPending;
+        std::vector<std::vector<uint32_t>> mCells;
+        std::vector<uint32_t> mStamps;
+        uint32_t mQueryStamp = 0;
+        LONG mOriginX = 0;
+        LONG mOriginY = 0;
+        LONG mCellSize = kMinCellSize;
+        LONG mCols = 0;
+        LONG mRows = 0;
+        UpdateStats mLastUpdate;
+    };
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+#include "imgui/imgui.h"
+#include "window_stats.hpp"
+
+namespace Inspector
+{
+    // Window over a WindowStats: ranked windows-per-process and class lists, visible versus hidden,
+    // size histograms and per-monitor counts. Everything shown is read straight from the counters, so
+    // drawing the panel costs the same however many windows there are.
+    class StatsPanel
+    {
+    public:
+        bool visible = false;
+        int topCount = 10;
+
+        void Render(const WindowStats& stats)
+        {
+            if (!visible)
+            {
+                return;
+            }
+
+            ImGui::SetNextWindowSize(ImVec2(560.0f, 640.0f), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Statistics", &visible, ImGuiWindowFlags_NoSavedSettings))
+            {
+                ImGui::End();
+                return;
+            }
+
+            const size_t windowCount = stats.WindowCount();
+            const size_t visibleCount = stats.VisibleCount();
+            ImGui::Text("Windows: %zu | Visible: %zu | Hidden: %zu | Processes with windows: %zu | Classes: %zu",
+                        windowCount, visibleCount, windowCount - visibleCount, stats.Processes().Size(), stats.Classes().Size());
+            ImGui::TextDisabled("Last refresh touched %zu windows, applied in %.2f ms.", stats.LastUpdate().touched, stats.LastUpdate().milliseconds);
+            ImGui::SetNextItemWidth(160.0f);
+            ImGui::SliderInt("Top", &topCount, 5, 50);
+
+            char label[160];
+            if (ImGui::CollapsingHeader("Windows per process", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                const RankedCounter<DWORD>& processes = stats.Processes();
+                RenderRanked("##processes", processes.Size(), windowCount, [&](size_t rank, uint32_t& count) {
+                    const auto& entry = processes.At(rank);
+                    count = entry.count;
+                    std::snprintf(label, sizeof(label), "%s [PID %lu]", stats.ProcessName(entry.key).c_str(), static_cast<unsigned long>(entry.key));
+                    return label;
+                });
+            }
+
+            if (ImGui::CollapsingHeader("Window classes", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                const RankedCounter<uint64_t>& classes = stats.Classes();
+                RenderRanked("##classes", classes.Size(), windowCount, [&](size_t rank, uint32_t& count) {
+                    const auto& entry = classes.At(rank);
+                    count = entry.count;
+                    return stats.ClassName(entry.key).c_str();
+                });
+            }
+
+            if (ImGui::CollapsingHeader("Sizes", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                RenderHistograms(stats, windowCount);
+            }
+
+            if (ImGui::CollapsingHeader("Monitors", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                RenderMonitors(stats, windowCount);
+            }
+            ImGui::End();
+        }
+
+    private:
+        static float Share(uint32_t count, size_t total)
+        {
+            return total != 0 ? static_cast<float>(count) / static_cast<float>(total) : 0.0f;
+        }
+
+        static void CountBar(uint32_t count, size_t total)
+        {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%u", count);
+            ImGui::ProgressBar(Share(count, total), ImVec2(-FLT_MIN, 0.0f), text);
+        }
+
+        // `entryAt(rank, count)` returns the label of the entry at `rank` and sets its count.
+        template <typename EntryAt>
+        void RenderRanked(const char* id, size_t size, size_t total, EntryAt entryAt)
+        {
+            const size_t shown = std::min(size, static_cast<size_t>(std::max(topCount, 0)));
+            if (shown == 0)
+            {
+                ImGui::TextDisabled("No windows.");
+                return;
+            }
+            if (!ImGui::BeginTable(id, 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+            {
+                return;
+            }
+            ImGui::TableSetupColumn("#", ImGuiTableColumnFlags_WidthFixed, 28.0f);
+            ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_WidthStretch, 0.6f);
+            ImGui::TableSetupColumn("Windows", ImGuiTableColumnFlags_WidthStretch, 0.4f);
+            for (size_t rank = 0; rank < shown; ++rank)
+            {
+                uint32_t count = 0;
+                const char* name = entryAt(rank, count);
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextDisabled("%zu", rank + 1);
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(name[0] != '\0' ? name : "(unnamed)");
+                ImGui::TableSetColumnIndex(2);
+                CountBar(count, total);
+            }
+            ImGui::EndTable();
+            if (size > shown)
+            {
+                ImGui::TextDisabled("%zu more not shown.", size - shown);
+            }
+        }
+
+        static void RenderHistograms(const WindowStats& stats, size_t total)
+        {
+            const WindowStats::Histogram& widths = stats.Widths();
+            const WindowStats::Histogram& heights = stats.Heights();
+            if (!ImGui::BeginTable("##sizes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+            {
+                return;
+            }
+            ImGui::TableSetupColumn("Pixels", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+            ImGui::TableSetupColumn("Width");
+            ImGui::TableSetupColumn("Height");
+            ImGui::TableHeadersRow();
+            for (size_t bucket = 0; bucket < kSizeBuckets; ++bucket)
+            {
+                if (widths[bucket] == 0 && heights[bucket] == 0)
+                {
+                    continue;
+                }
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                if (bucket == 0)
+                {
+                    ImGui::TextUnformatted("0");
+                }
+                else if (bucket + 1 == kSizeBuckets)
+                {
+                    ImGui::Text("%ld+", static_cast<long>(SizeBucketFloor(bucket)));
+                }
+                else
+                {
+                    ImGui::Text("%ld-%ld", static_cast<long>(SizeBucketFloor(bucket)), static_cast<long>(SizeBucketFloor(bucket + 1) - 1));
+                }
+                ImGui::TableSetColumnIndex(1);
+                CountBar(widths[bucket], total);
+                ImGui::TableSetColumnIndex(2);
+                CountBar(heights[bucket], total);
+            }
+            ImGui::EndTable();
+        }
+
+        static void RenderMonitors(const WindowStats& stats, size_t total)
+        {
+            const std::vector<RECT>& monitors = stats.Monitors();
+            const std::vector<uint32_t>& counts = stats.MonitorCounts();
+            if (!ImGui::BeginTable("##monitors", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+            {
+                return;
+            }
+            for (size_t monitor = 0; monitor < counts.size(); ++monitor)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                if (monitor < monitors.size())
+                {
+                    const RECT& area = monitors[monitor];
+                    ImGui::Text("Monitor %zu  (%ld,%ld)-(%ld,%ld)", monitor + 1, static_cast<long>(area.left), static_cast<long>(area.top),
+                                static_cast<long>(area.right), static_cast<long>(area.bottom));
+                }
+                else
+                {
+                    ImGui::TextUnformatted("Off-screen or zero-sized");
+                }
+                ImGui::TableSetColumnIndex(1);
+                CountBar(counts[monitor], total);
+            }
+            ImGui::EndTable();
+        }
+    };
+}
@@ -0,0 +1,496 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define INSPECTOR_SEARCH_AVX2 1
+#define INSPECTOR_SEARCH_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INSPECTOR_SEARCH_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Case-insensitive substring search shared by the inspector filters and ImStristr.
+// ASCII needles go through a SIMD candidate scan anchored on their two rarest bytes; needles
+// containing non-ASCII bytes fall back to a UTF-8 decoder with simple case folding.
+namespace Inspector::TextSearch
+{
+    inline unsigned char FoldAscii(unsigned char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+    }
+
+    inline bool IsAsciiLetter(unsigned char c)
+    {
+        const unsigned char lower = static_cast<unsigned char>(c | 0x20);
+        return lower >= 'a' && lower <= 'z';
+    }
+
+    inline unsigned CountTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    inline unsigned CountTrailingZeros64(uint64_t mask)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index = 0;
+        _BitScanForward64(&index, mask);
+        return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+        const uint32_t low = static_cast<uint32_t>(mask);
+        return low != 0 ? CountTrailingZeros(low) : 32 + CountTrailingZeros(static_cast<uint32_t>(mask >> 32));
+#else
+        return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+    }
+
+    inline unsigned PopCount64(uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        // __popcnt64 needs the POPCNT instruction, which the x64 baseline does not guarantee.
+        bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+        bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<unsigned>((bits * 0x0101010101010101ull) >> 56);
+#else
+        return static_cast<unsigned>(__builtin_popcountll(bits));
+#endif
+    }
+
+    // Compares `length` bytes, folding ASCII letters only. Bytes >= 0x80 must match exactly,
+    // so an ASCII needle can never match in the middle of a multi-byte sequence.
+    inline bool EqualsFoldedAscii(const unsigned char* text, const unsigned char* foldedNeedle, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (FoldAscii(text[i]) != foldedNeedle[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Simple (1:1) case folding for the scripts that show up in window titles.
+    inline uint32_t FoldCodepoint(uint32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            return FoldAscii(static_cast<unsigned char>(cp));
+        }
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7)
+        {
+            return cp + 0x20;
+        }
+        if (cp >= 0x100 && cp <= 0x17F)
+        {
+            if (cp == 0x130 || cp == 0x131 || cp == 0x138 || cp == 0x149 || cp == 0x17F)
+            {
+                return cp;
+            }
+            if (cp == 0x178)
+            {
+                return 0xFF;
+            }
+            if ((cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E))
+            {
+                return (cp & 1) ? cp + 1 : cp;
+            }
+            return cp | 1;
+        }
+        if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2)
+        {
+            return cp + 0x20;
+        }
+        if (cp >= 0x400 && cp <= 0x40F)
+        {
+            return cp + 0x50;
+        }
+        if (cp >= 0x410 && cp <= 0x42F)
+        {
+            return cp + 0x20;
+        }
+        if (cp >= 0xFF21 && cp <= 0xFF3A)
+        {
+            return cp + 0x20;
+        }
+        return cp;
+    }
+
+    // Decodes one code point and advances `text`. Malformed bytes decode to a private value
+    // derived from the byte so they only ever match themselves.
+    inline uint32_t DecodeUtf8(const unsigned char*& text, const unsigned char* end)
+    {
+        const unsigned char lead = *text++;
+        if (lead < 0x80)
+        {
+            return lead;
+        }
+
+        int extra = 0;
+        uint32_t cp = 0;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            extra = 1;
+            cp = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            extra = 2;
+            cp = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            extra = 3;
+            cp = lead & 0x07;
+        }
+        else
+        {
+            return 0x80000000u | lead;
+        }
+
+        if (end - text < extra)
+        {
+            return 0x80000000u | lead;
+        }
+        for (int i = 0; i < extra; ++i)
+        {
+            if ((text[i] & 0xC0) != 0x80)
+            {
+                return 0x80000000u | lead;
+            }
+        }
+        for (int i = 0; i < extra; ++i)
+        {
+            cp = (cp << 6) | (*text++ & 0x3F);
+        }
+        return cp;
+    }
+
+    // Appends `text` with every code point case-folded as FindCaseInsensitive folds it. A folded code
+    // point is always encoded in as many bytes as the original, so on well-formed UTF-8 (everything
+    // ToUtf8 produces) a case-insensitive match is a plain byte match between folded texts. Malformed
+    // and overlong sequences are copied unchanged.
+    inline void AppendFolded(std::string& out, const char* text, size_t length)
+    {
+        // Folding never changes the length, so copy once and fold in place.
+        const size_t base = out.size();
+        out.append(text, length);
+        auto* cursor = reinterpret_cast<unsigned char*>(&out[base]);
+        auto* end = cursor + length;
+        while (cursor < end)
+        {
+            if (*cursor < 0x80)
+            {
+                *cursor = FoldAscii(*cursor);
+                ++cursor;
+                continue;
+            }
+            unsigned char* start = cursor;
+            const unsigned char* next = cursor;
+            const uint32_t cp = DecodeUtf8(next, end);
+            const uint32_t folded = FoldCodepoint(cp);
+            cursor = start + (next - start);
+            const size_t size = static_cast<size_t>(cursor - start);
+            if (folded != cp && size == 2 && cp >= 0x80 && folded < 0x800)
+            {
+                start[0] = static_cast<unsigned char>(0xC0 | (folded >> 6));
+                start[1] = static_cast<unsigned char>(0x80 | (folded & 0x3F));
+            }
+            else if (folded != cp && size == 3 && cp >= 0x800 && folded >= 0x800 && folded < 0x10000)
+            {
+                start[0] = static_cast<unsigned char>(0xE0 | (folded >> 12));
+                start[1] = static_cast<unsigned char>(0x80 | ((folded >> 6) & 0x3F));
+                start[2] = static_cast<unsigned char>(0x80 | (folded & 0x3F));
+            }
+        }
+    }
+
+    inline const char* FindUtf8(const char* haystack, size_t haystackLength, const char* needle, size_t needleLength)
+    {
+        const auto* needleBegin = reinterpret_cast<const unsigned char*>(needle);
+        const auto* needleEnd = needleBegin + needleLength;
+        const auto* start = reinterpret_cast<const unsigned char*>(haystack);
+        const auto* end = start + haystackLength;
+        // Folding never maps a non-ASCII code point to ASCII, so when the needle starts with one
+        // only lead bytes can begin a match and ASCII runs can be skipped without decoding.
+        const bool skipAscii = *needleBegin >= 0x80;
+        while (start < end)
+        {
+            if (skipAscii)
+            {
+                while (start < end && *start < 0xC0)
+                {
+                    ++start;
+                }
+                if (start == end)
+                {
+                    break;
+                }
+            }
+
+            const unsigned char* cursor = start;
+            const unsigned char* n = needleBegin;
+            while (n < needleEnd && cursor < end)
+            {
+                const unsigned char* nextNeedle = n;
+                if (FoldCodepoint(DecodeUtf8(cursor, end)) != FoldCodepoint(DecodeUtf8(nextNeedle, needleEnd)))
+                {
+                    break;
+                }
+                n = nextNeedle;
+            }
+            if (n == needleEnd)
+            {
+                return reinterpret_cast<const char*>(start);
+            }
+
+            const unsigned char* next = start;
+            DecodeUtf8(next, end);
+            start = next;
+        }
+        return nullptr;
+    }
+
+    // How common each folded ASCII byte is in window titles and class names, higher meaning more
+    // common; bytes not listed rank 0. FoldedNeedle anchors its SIMD scan on the two rarest needle bytes.
+    struct AnchorRanks
+    {
+        unsigned char rank[128] = {};
+    };
+
+    // Folded ASCII bytes from most to least common; each byte appears once.
+    inline constexpr char kAnchorFrequencyOrder[] = " eoaintsrlcdhmu-pwgf.bvy0k1_23()x4956:78jqz";
+
+    inline constexpr bool ListsEachByteOnce(const char* bytes)
+    {
+        bool seen[128] = {};
+        for (; *bytes != '\0'; ++bytes)
+        {
+            const auto byte = static_cast<unsigned char>(*bytes);
+            if (byte >= 128 || seen[byte])
+            {
+                return false;
+            }
+            seen[byte] = true;
+        }
+        return true;
+    }
+
+    static_assert(ListsEachByteOnce(kAnchorFrequencyOrder), "a repeated byte would take the rarer of its two ranks");
+
+    inline constexpr AnchorRanks MakeAnchorRanks()
+    {
+        AnchorRanks ranks;
+        constexpr size_t kCount = sizeof(kAnchorFrequencyOrder) - 1;
+        for (size_t i = 0; i < kCount; ++i)
+        {
+            ranks.rank[static_cast<unsigned char>(kAnchorFrequencyOrder[i])] = static_cast<unsigned char>(kCount - i);
+        }
+        return ranks;
+    }
+
+    inline constexpr AnchorRanks kAnchorRanks = MakeAnchorRanks();
+
+    // Walks the set bits of a SIMD candidate mask (bit n = position base + n) and returns the first
+    // position where the whole needle matches.
+    inline const char* VerifyCandidates(const char* haystack, size_t base, uint32_t mask, const unsigned char* folded, size_t needleLength)
+    {
+        const auto* text = reinterpret_cast<const unsigned char*>(haystack);
+        while (mask != 0)
+        {
+            const size_t offset = base + CountTrailingZeros(mask);
+            if (EqualsFoldedAscii(text + offset, folded, needleLength))
+            {
+                return haystack + offset;
+            }
+            mask &= mask - 1;
+        }
+        return nullptr;
+    }
+
+    // A needle folded once and searched for in many haystacks, such as one filter tested against every
+    // window; FindCaseInsensitive builds one per call. The needle's bytes must outlive it. ASCII needles
+    // of up to 256 bytes are found with a SIMD scan anchored on their two rarest bytes, so a candidate
+    // has to match both before the needle is compared; anything else goes to FindUtf8.
+    class FoldedNeedle
+    {
+    public:
+        FoldedNeedle() = default;
+
+        FoldedNeedle(const char* needle, size_t length)
+        {
+            Reset(needle, length);
+        }
+
+        void Reset(const char* needle, size_t length)
+        {
+            mNeedle = needle;
+            mLength = length;
+            mAscii = length <= sizeof(mFolded);
+            if (!mAscii || length == 0)
+            {
+                return;
+            }
+
+            // Fold and rank in one pass.
+            size_t first = 0;
+            size_t second = length - 1;
+            unsigned char firstRank = 0xFF;
+            unsigned char secondRank = 0xFF;
+            unsigned char high = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const unsigned char c = static_cast<unsigned char>(needle[i]);
+                high |= c;
+                mFolded[i] = FoldAscii(c);
+                const unsigned char rank = kAnchorRanks.rank[mFolded[i] & 0x7F];
+                if (rank < firstRank)
+                {
+                    second = first;
+                    secondRank = firstRank;
+                    first = i;
+                    firstRank = rank;
+                }
+                else if (rank < secondRank)
+                {
+                    second = i;
+                    secondRank = rank;
+                }
+            }
+            mAscii = high < 0x80;
+            mFirst = std::min(first, second);
+            mSecond = std::max(first, second);
+            // OR-ing 0x20 maps only 'A'/'a' (etc.) onto a lowercase letter, so it is an exact fold for letters.
+            mFirstOr = IsAsciiLetter(mFolded[mFirst]) ? 0x20 : 0x00;
+            mSecondOr = IsAsciiLetter(mFolded[mSecond]) ? 0x20 : 0x00;
+        }
+
+        size_t Length() const
+        {
+            return mLength;
+        }
+
+        // Returns the first case-insensitive occurrence in `haystack`, or nullptr.
+        const char* Find(const char* haystack, size_t haystackLength) const
+        {
+            if (mLength == 0)
+            {
+                return haystack;
+            }
+            if (haystack == nullptr || mLength > haystackLength)
+            {
+                return nullptr;
+            }
+            if (!mAscii)
+            {
+                return FindUtf8(haystack, haystackLength, mNeedle, mLength);
+            }
+
+            const auto* text = reinterpret_cast<const unsigned char*>(haystack);
+            const unsigned char* folded = mFolded;
+            const size_t needleLength = mLength;
+            const size_t first = mFirst;
+            const size_t second = mSecond;
+            const unsigned char firstFold = folded[first];
+            const unsigned char secondFold = folded[second];
+            const unsigned char firstOr = mFirstOr;
+            const unsigned char secondOr = mSecondOr;
+            const size_t candidates = haystackLength - needleLength + 1;
+            size_t i = 0;
+
+#if defined(INSPECTOR_SEARCH_AVX2)
+            const __m256i firstVec = _mm256_set1_epi8(static_cast<char>(firstFold));
+            const __m256i secondVec = _mm256_set1_epi8(static_cast<char>(secondFold));
+            const __m256i firstOrVec = _mm256_set1_epi8(static_cast<char>(firstOr));
+            const __m256i secondOrVec = _mm256_set1_epi8(static_cast<char>(secondOr));
+            for (; i + 32 <= candidates; i += 32)
+            {
+                const __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + first)), firstOrVec);
+                const __m256i blockSecond = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + second)), secondOrVec);
+                const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, firstVec), _mm256_cmpeq_epi8(blockSecond, secondVec))));
+                if (const char* match = VerifyCandidates(haystack, i, mask, folded, needleLength))
+                {
+                    return match;
+                }
+            }
+#endif
+#if defined(INSPECTOR_SEARCH_SSE2)
+            const __m128i firstVec16 = _mm_set1_epi8(static_cast<char>(firstFold));
+            const __m128i secondVec16 = _mm_set1_epi8(static_cast<char>(secondFold));
+            const __m128i firstOrVec16 = _mm_set1_epi8(static_cast<char>(firstOr));
+            const __m128i secondOrVec16 = _mm_set1_epi8(static_cast<char>(secondOr));
+            const auto candidateMask16 = [&](size_t offset) {
+                const __m128i blockFirst = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + offset + first)), firstOrVec16);
+                const __m128i blockSecond = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + offset + second)), secondOrVec16);
+                return static_cast<uint32_t>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstVec16), _mm_cmpeq_epi8(blockSecond, secondVec16))));
+            };
+            for (; i + 16 <= candidates; i += 16)
+            {
+                if (const char* match = VerifyCandidates(haystack, i, candidateMask16(i), folded, needleLength))
+                {
+                    return match;
+                }
+            }
+            if (i < candidates && candidates >= 16)
+            {
+                // Overlapping final block instead of a scalar tail; positions below `i` were already checked.
+                const size_t base = candidates - 16;
+                const uint32_t mask = candidateMask16(base) & ~((1u << (i - base)) - 1u);
+                return VerifyCandidates(haystack, base, mask, folded, needleLength);
+            }
+#endif
+
+            for (; i < candidates; ++i)
+            {
+                if ((text[i + first] | firstOr) == firstFold && (text[i + second] | secondOr) == secondFold && EqualsFoldedAscii(text + i, folded, needleLength))
+                {
+                    return haystack + i;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        const char* mNeedle = nullptr;
+        size_t mLength = 0;
+        bool mAscii = false;
+        size_t mFirst = 0;
+        size_t mSecond = 0;
+        unsigned char mFirstOr = 0;
+        unsigned char mSecondOr = 0;
+        // Only the first mLength bytes are written; left uninitialized so a per-call needle stays cheap.
+        unsigned char mFolded[256];
+    };
+
+    // Returns the first case-insensitive occurrence of `needle` in `haystack`, or nullptr.
+    inline const char* FindCaseInsensitive(const char* haystack, size_t haystackLength, const char* needle, size_t needleLength)
+    {
+        if (needleLength == 0)
+        {
+            return haystack;
+        }
+        if (haystack == nullptr || needleLength > haystackLength)
+        {
+            return nullptr;
+        }
+        return FoldedNeedle(needle, needleLength).Find(haystack, haystackLength);
+    }
+}
@@ -0,0 +1,413 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "imgui/imgui.h"
+#include "window_history.hpp"
+#include "minimap.hpp"
+
+namespace Inspector
+{
+    // Formats `seconds` since the start of a recording as H:MM:SS (M:SS under an hour).
+    inline void FormatTimelineOffset(double seconds, char* buffer, size_t size)
+    {
+        const long long total = static_cast<long long>(std::max(0.0, seconds));
+        if (total >= 3600)
+        {
+            std::snprintf(buffer, size, "%lld:%02lld:%02lld", total / 3600, (total / 60) % 60, total % 60);
+        }
+        else
+        {
+            std::snprintf(buffer, size, "%lld:%02lld", total / 60, total % 60);
+        }
+    }
+
+    // Lifetime timeline over a WindowHistory: one row per process followed by its windows, each with a
+    // bar for the time it was listed and ticks for title, visibility and bounds changes. Only lifetimes
+    // overlapping the visible time range are queried from the history's interval tree, only the rows on
+    // screen are submitted, and markers closer than a pixel apart are skipped, so zooming and panning
+    // over hours of captures costs about the same as over a minute.
+    class LifetimeTimeline
+    {
+    public:
+        static constexpr double kCaptureInterval = 1.0;
+        static constexpr double kMinSpan = 5.0;
+        static constexpr float kLabelWidth = 280.0f;
+
+        bool visible = false;
+        // While set, RenderInspectorUi requests a snapshot every kCaptureInterval and records it.
+        bool recording = false;
+
+        // Draws the panel; clicking a live window's row stores its handle in `selected`.
+        void Render(WindowHistory& history, HWND& selected)
+        {
+            if (!visible)
+            {
+                return;
+            }
+
+            ImGui::SetNextWindowSize(ImVec2(960.0f, 480.0f), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Timeline", &visible, ImGuiWindowFlags_NoSavedSettings))
+            {
+                ImGui::End();
+                return;
+            }
+
+            ImGui::Checkbox("Record (1 Hz)", &recording);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Fit"))
+            {
+                mFollow = true;
+                mFit = true;
+            }
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Clear"))
+            {
+                history.Clear();
+                mFit = true;
+            }
+            ImGui::SameLine();
+            ImGui::TextDisabled("%zu records | %zu lifetimes (%zu open) | %zu in view", history.RecordCount(), history.LifetimeCount(),
+                                history.OpenCount(), mRows.size());
+            if (history.Empty())
+            {
+                ImGui::TextDisabled("Nothing recorded yet. Tick Record to capture a snapshot every second.");
+                ImGui::End();
+                return;
+            }
+
+            UpdateView(history);
+            RefreshRows(history);
+
+            const ImGuiStyle& style = ImGui::GetStyle();
+            const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+            const ImVec2 axisMin = ImGui::GetCursorScreenPos();
+            const float barsWidth = std::max(64.0f, ImGui::GetContentRegionAvail().x - kLabelWidth - style.ScrollbarSize);
+            const float barsMinX = axisMin.x + kLabelWidth;
+            const double secondsPerPixel = (mViewEnd - mViewStart) / barsWidth;
+            DrawAxis(history, ImGui::GetWindowDrawList(), ImVec2(barsMinX, axisMin.y), barsWidth, rowHeight);
+            ImGui::Dummy(ImVec2(kLabelWidth + barsWidth, rowHeight));
+
+            ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+            ImGui::BeginChild("##timeline_rows", ImVec2(0.0f, 0.0f), ImGuiChildFlags_None,
+                              ImGuiWindowFlags_AlwaysVerticalScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
+            ImGui::PopStyleVar();
+            // Rows are exactly rowHeight apart, which is what the clipper assumes.
+            ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(style.ItemSpacing.x, 0.0f));
+            ImGuiIO& io = ImGui::GetIO();
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+            double panSeconds = 0.0;
+            uint32_t hoveredLifetime = kNoLifetime;
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(mRows.size()), rowHeight);
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                {
+                    const uint32_t index = mRows[static_cast<size_t>(row)];
+                    const WindowLifetime& lifetime = history.LifetimeAt(index);
+                    ImGui::PushID(row);
+                    const ImVec2 rowMin = ImGui::GetCursorScreenPos();
+                    const bool alive = lifetime.end == WindowLifetime::kOpen;
+                    if (lifetime.IsProcess())
+                    {
+                        drawList->AddRectFilled(rowMin, ImVec2(rowMin.x + kLabelWidth + barsWidth, rowMin.y + rowHeight), ImGui::GetColorU32(ImGuiCol_TableHeaderBg));
+                    }
+                    ImGui::PushClipRect(rowMin, ImVec2(rowMin.x + kLabelWidth - 4.0f, rowMin.y + rowHeight), true);
+                    if (lifetime.IsProcess())
+                    {
+                        ImGui::Text("%s [PID %lu]", lifetime.titleUtf8.c_str(), lifetime.pid);
+                    }
+                    else
+                    {
+                        char label[64];
+                        std::snprintf(label, sizeof(label), "  0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(lifetime.handle)));
+                        if (ImGui::Selectable(label, alive && lifetime.handle == selected, ImGuiSelectableFlags_None, ImVec2(kLabelWidth * 0.4f, rowHeight - 4.0f)) && alive)
+                        {
+                            selected = lifetime.handle;
+                        }
+                        ImGui::SameLine(0.0f, 0.0f);
+                        if (alive)
+                        {
+                            ImGui::TextUnformatted(lifetime.titleUtf8.c_str());
+                        }
+                        else
+                        {
+                            ImGui::TextDisabled("%s", lifetime.titleUtf8.c_str());
+                        }
+                    }
+                    ImGui::PopClipRect();
+
+                    // The bar area is its own item, so dragging it pans instead of moving the window.
+                    ImGui::SameLine(kLabelWidth, 0.0f);
+                    ImGui::InvisibleButton("##bars", ImVec2(barsWidth, rowHeight));
+                    if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left, 0.0f))
+                    {
+                        panSeconds = -io.MouseDelta.x * secondsPerPixel;
+                    }
+                    if (ImGui::IsItemHovered())
+                    {
+                        hoveredLifetime = index;
+                    }
+                    DrawLifetime(lifetime, drawList, ImVec2(barsMinX, rowMin.y), barsWidth, rowHeight, secondsPerPixel);
+                    ImGui::PopID();
+                }
+            }
+
+            const bool hovered = ImGui::IsWindowHovered();
+            if (hovered && io.MouseWheel != 0.0f)
+            {
+                if (io.MousePos.x >= barsMinX)
+                {
+                    Zoom(history, io.MouseWheel > 0.0f ? 0.8 : 1.25, mViewStart + (io.MousePos.x - barsMinX) * secondsPerPixel);
+                }
+                else
+                {
+                    ImGui::SetScrollY(ImGui::GetScrollY() - io.MouseWheel * rowHeight * 3.0f);
+                }
+            }
+            if (panSeconds != 0.0)
+            {
+                mViewStart += panSeconds;
+                mViewEnd += panSeconds;
+                mFollow = false;
+            }
+            ImGui::PopStyleVar();
+            ImGui::EndChild();
+
+            if (hoveredLifetime != kNoLifetime)
+            {
+                ShowTooltip(history, history.LifetimeAt(hoveredLifetime), mViewStart + (io.MousePos.x - barsMinX) * secondsPerPixel, secondsPerPixel);
+            }
+            ImGui::End();
+        }
+
+    private:
+        static constexpr uint32_t kNoLifetime = 0xFFFFFFFFu;
+
+        static ImU32 MarkerColor(LifetimeEvent event)
+        {
+            switch (event)
+            {
+            case LifetimeEvent::Title:
+                return IM_COL32(255, 210, 60, 255);
+            case LifetimeEvent::Visibility:
+                return IM_COL32(90, 220, 255, 255);
+            default:
+                return IM_COL32(255, 110, 200, 255);
+            }
+        }
+
+        static const char* MarkerName(LifetimeEvent event)
+        {
+            switch (event)
+            {
+            case LifetimeEvent::Title:
+                return "title";
+            case LifetimeEvent::Visibility:
+                return "visibility";
+            default:
+                return "bounds";
+            }
+        }
+
+        // Keeps the view inside the recording; while following, the right edge tracks the latest record.
+        void UpdateView(const WindowHistory& history)
+        {
+            const double first = history.FirstTime();
+            const double last = std::max(history.LastTime(), first + kMinSpan);
+            if (mFit)
+            {
+                mViewStart = first;
+                mViewEnd = last;
+                mFit = false;
+            }
+            const double span = std::clamp(mViewEnd - mViewStart, kMinSpan, MaxSpan(history));
+            if (mFollow)
+            {
+                mViewEnd = last;
+            }
+            mViewEnd = std::clamp(mViewEnd, first + std::min(span, last - first), last + span * 0.5);
+            mViewStart = mViewEnd - span;
+        }
+
+        double MaxSpan(const WindowHistory& history) const
+        {
+            return std::max(kMinSpan, (history.LastTime() - history.FirstTime()) * 1.25);
+        }
+
+        void Zoom(const WindowHistory& history, double factor, double anchor)
+        {
+            const double span = std::clamp((mViewEnd - mViewStart) * factor, kMinSpan, MaxSpan(history));
+            if (mFollow)
+            {
+                // Zoom towards the live edge.
+                anchor = mViewEnd;
+            }
+            const double ratio = (anchor - mViewStart) / (mViewEnd - mViewStart);
+            mViewStart = anchor - span * ratio;
+            mViewEnd = mViewStart + span;
+        }
+
+        // Re-queries the interval tree when the view or the history moved, and orders the hits as rows:
+        // by pid, the process lifetime before its windows, then by start time.
+        void RefreshRows(WindowHistory& history)
+        {
+            if (history.RecordCount() == mRowsRecordCount && mViewStart == mRowsFrom && mViewEnd == mRowsTo && history.LifetimeCount() == mOrder.size())
+            {
+                return;
+            }
+            if (history.LifetimeCount() != mOrder.size() || history.RecordCount() < mRowsRecordCount)
+            {
+                // New lifetimes only arrive with a record, about once a second.
+                mOrder.resize(history.LifetimeCount());
+                std::iota(mOrder.begin(), mOrder.end(), 0u);
+                std::sort(mOrder.begin(), mOrder.end(), [&](uint32_t a, uint32_t b) {
+                    const WindowLifetime& left = history.LifetimeAt(a);
+                    const WindowLifetime& right = history.LifetimeAt(b);
+                    if (left.pid != right.pid)
+                    {
+                        return left.pid < right.pid;
+                    }
+                    if (left.IsProcess() != right.IsProcess())
+                    {
+                        return left.IsProcess();
+                    }
+                    return a < b;
+                });
+                mRank.resize(mOrder.size());
+                for (uint32_t position = 0; position < mOrder.size(); ++position)
+                {
+                    mRank[mOrder[position]] = position;
+                }
+            }
+            mRowsRecordCount = history.RecordCount();
+            mRowsFrom = mViewStart;
+            mRowsTo = mViewEnd;
+
+            history.QueryRange(mViewStart, mViewEnd, mHits);
+            mRows.clear();
+            if (mHits.size() * 8 < mOrder.size())
+            {
+                mRows = mHits;
+                std::sort(mRows.begin(), mRows.end(), [&](uint32_t a, uint32_t b) { return mRank[a] < mRank[b]; });
+                return;
+            }
+            // Most lifetimes are in view: filtering the presorted order beats sorting the hits.
+            mInView.assign(mOrder.size(), 0);
+            for (const uint32_t hit : mHits)
+            {
+                mInView[hit] = 1;
+            }
+            for (const uint32_t index : mOrder)
+            {
+                if (mInView[index] != 0)
+                {
+                    mRows.push_back(index);
+                }
+            }
+        }
+
+        void DrawAxis(const WindowHistory& history, ImDrawList* drawList, const ImVec2& origin, float width, float height) const
+        {
+            static constexpr double kSteps[] = {1, 2, 5, 10, 15, 30, 60, 120, 300, 600, 900, 1800, 3600, 7200, 14400, 28800, 86400};
+            const double pixelsPerSecond = width / (mViewEnd - mViewStart);
+            double step = kSteps[sizeof(kSteps) / sizeof(kSteps[0]) - 1];
+            for (const double candidate : kSteps)
+            {
+                if (candidate * pixelsPerSecond >= 90.0)
+                {
+                    step = candidate;
+                    break;
+                }
+            }
+
+            const ImU32 textColor = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+            const double first = history.FirstTime();
+            drawList->PushClipRect(origin, ImVec2(origin.x + width, origin.y + height), true);
+            for (double tick = first + std::ceil((mViewStart - first) / step) * step; tick <= mViewEnd; tick += step)
+            {
+                const float x = origin.x + static_cast<float>((tick - mViewStart) * pixelsPerSecond);
+                char label[32];
+                FormatTimelineOffset(tick - first, label, sizeof(label));
+                drawList->AddLine(ImVec2(x, origin.y + height - 4.0f), ImVec2(x, origin.y + height), textColor);
+                drawList->AddText(ImVec2(x + 3.0f, origin.y), textColor, label);
+            }
+            drawList->PopClipRect();
+        }
+
+        void DrawLifetime(const WindowLifetime& lifetime, ImDrawList* drawList, const ImVec2& origin, float width, float height, double secondsPerPixel) const
+        {
+            const double end = std::min(lifetime.end, mViewEnd);
+            const double start = std::max(lifetime.start, mViewStart);
+            if (end < start)
+            {
+                return;
+            }
+
+            const float x0 = origin.x + static_cast<float>((start - mViewStart) / secondsPerPixel);
+            const float x1 = std::max(x0 + 1.0f, origin.x + static_cast<float>((end - mViewStart) / secondsPerPixel));
+            const float y0 = origin.y + 3.0f;
+            const float y1 = origin.y + height - 3.0f;
+            drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(std::min(x1, origin.x + width), y1),
+                                    lifetime.IsProcess() ? IM_COL32(150, 150, 170, 120) : ProcessColor(lifetime.pid, 150));
+
+            // Markers in view, at most one per pixel column: after drawing one, jump past its pixel.
+            const auto byTime = [](const LifetimeMarker& marker, double time) { return marker.time < time; };
+            auto it = std::lower_bound(lifetime.markers.begin(), lifetime.markers.end(), mViewStart, byTime);
+            while (it != lifetime.markers.end() && it->time <= mViewEnd)
+            {
+                const float x = origin.x + static_cast<float>((it->time - mViewStart) / secondsPerPixel);
+                drawList->AddRectFilled(ImVec2(x - 1.0f, origin.y + 1.0f), ImVec2(x + 1.0f, origin.y + height - 1.0f), MarkerColor(it->event));
+                it = std::lower_bound(it + 1, lifetime.markers.end(), it->time + 2.0 * secondsPerPixel, byTime);
+            }
+        }
+
+        void ShowTooltip(const WindowHistory& history, const WindowLifetime& lifetime, double cursorTime, double secondsPerPixel) const
+        {
+            char start[32];
+            char end[32];
+            FormatTimelineOffset(lifetime.start - history.FirstTime(), start, sizeof(start));
+            FormatTimelineOffset(lifetime.end - history.FirstTime(), end, sizeof(end));
+            ImGui::BeginTooltip();
+            if (lifetime.IsProcess())
+            {
+                ImGui::Text("%s [PID %lu]", lifetime.titleUtf8.c_str(), lifetime.pid);
+            }
+            else
+            {
+                ImGui::Text("0x%llX  %s", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(lifetime.handle)), lifetime.titleUtf8.c_str());
+                ImGui::TextDisabled("%s [PID %lu]", lifetime.classNameUtf8.c_str(), lifetime.pid);
+            }
+            ImGui::Text("Listed %s - %s | %zu changes", start, lifetime.end == WindowLifetime::kOpen ? "now" : end, lifetime.markers.size());
+
+            const auto byTime = [](const LifetimeMarker& marker, double time) { return marker.time < time; };
+            auto it = std::lower_bound(lifetime.markers.begin(), lifetime.markers.end(), cursorTime - 3.0 * secondsPerPixel, byTime);
+            for (; it != lifetime.markers.end() && it->time <= cursorTime + 3.0 * secondsPerPixel; ++it)
+            {
+                char at[32];
+                FormatTimelineOffset(it->time - history.FirstTime(), at, sizeof(at));
+                ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(MarkerColor(it->event)), "%s changed at %s", MarkerName(it->event), at);
+            }
+            ImGui::EndTooltip();
+        }
+
+        double mViewStart = 0.0;
+        double mViewEnd = 0.0;
+        bool mFollow = true;
+        bool mFit = true;
+        std::vector<uint32_t> mOrder;
+        std::vector<uint32_t> mRank;
+        std::vector<uint32_t> mHits;
+        std::vector<uint32_t> mRows;
+        std::vector<uint8_t> mInView;
+        size_t mRowsRecordCount = 0;
+        double mRowsFrom = 0.0;
+        double mRowsTo = 0.0;
+    };
+}
@@ -0,0 +1,595 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <future>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <unordered_map>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+#include "snapshot_diff.hpp"
+#include "text_search.hpp"
+
+namespace Inspector
+{
+    // Inverted index from the trigrams of each window's title, class and process name to the windows
+    // containing them, so a substring search only verifies the windows that hold every trigram of the
+    // query. Text is case-folded first (TextSearch::AppendFolded), so any FindCaseInsensitive match shares
+    // all of the query's trigrams. Trigrams are hashed into buckets sized to the desktop; a collision can
+    // add candidates but never lose one.
+    //
+    // Windows are keyed by SpatialIndex slot. The bulk of the index is an immutable array of posting
+    // lists sorted by slot, built on a worker thread from a copy of the folded texts while the previous
+    // one keeps answering. Refreshes are applied on top of it as per-bucket added and removed slots,
+    // visiting only the slots SnapshotDiff touched; once that overlay outgrows an eighth of the base, the
+    // base is rebuilt in the background.
+    class TrigramIndex
+    {
+    public:
+        struct Stats
+        {
+            size_t buckets = 0;
+            size_t postings = 0;
+            size_t overlay = 0;
+            bool building = false;
+            // Last base build on the worker thread.
+            double buildMilliseconds = 0.0;
+            // Last Update on the calling thread.
+            double updateMilliseconds = 0.0;
+        };
+
+        // `index` and `diff` must already be updated for `snapshot`. After the first call only the slots
+        // the diff touched are re-read, so every later snapshot must be passed in (Clear() before skipping
+        // some).
+        void Update(const InspectorSnapshot& snapshot, const SpatialIndex& index, const SnapshotDiff& diff)
+        {
+            Install(false);
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const bool first = mGeneration == 0;
+            mGeneration = snapshot.generation;
+            mIndex = &index;
+            if (mDocuments.spans.size() < index.SlotCount())
+            {
+                mDocuments.spans.resize(index.SlotCount());
+                mPendingFlags.resize(index.SlotCount(), 0);
+            }
+
+            const auto reread = [&](uint32_t slot) {
+                std::string& document = mDocumentScratch;
+                document.clear();
+                const SpatialIndex::Entry& entry = index.EntryAt(slot);
+                if (entry.live)
+                {
+                    AppendDocument(snapshot, entry.ref, document);
+                }
+                // Moved, restyled and shown/hidden windows keep their text.
+                if (!mDocuments.Equals(slot, document))
+                {
+                    Replace(slot, document);
+                }
+            };
+            if (first)
+            {
+                for (uint32_t slot = 0; slot < index.SlotCount(); ++slot)
+                {
+                    reread(slot);
+                }
+            }
+            else
+            {
+                for (const uint32_t slot : diff.TouchedSlots())
+                {
+                    reread(slot);
+                }
+            }
+            FlushOverlay();
+            mDocuments.CompactIfStale();
+
+            if (!mBuild.valid() && (mBase.offsets.empty() || mOverlaySize > mBase.postings.size() / 8 + kOverlaySlack))
+            {
+                StartBuild();
+            }
+            mStats.updateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Windows of `snapshot` that may contain every term; the caller verifies them. Returns false when
+        // the index cannot narrow the search: no base built yet, `snapshot` is not the one last passed to
+        // Update, or no term is three bytes long.
+        bool Candidates(const InspectorSnapshot& snapshot, const std::vector<std::string>& terms, std::vector<WindowRef>& out)
+        {
+            out.clear();
+            if (mBase.offsets.empty() || mIndex == nullptr || snapshot.generation != mGeneration)
+            {
+                return false;
+            }
+
+            mQueryBuckets.clear();
+            for (const std::string& term : terms)
+            {
+                mDocumentScratch.clear();
+                TextSearch::AppendFolded(mDocumentScratch, term.data(), term.size());
+                ForEachBucket(mDocumentScratch.data(), mDocumentScratch.size(), mBase.bits, [this](uint32_t bucket) { mQueryBuckets.push_back(bucket); });
+            }
+            if (mQueryBuckets.empty())
+            {
+                return false;
+            }
+            std::sort(mQueryBuckets.begin(), mQueryBuckets.end());
+            mQueryBuckets.erase(std::unique(mQueryBuckets.begin(), mQueryBuckets.end()), mQueryBuckets.end());
+
+            // Start from the shortest list; every other bucket only filters it down.
+            std::sort(mQueryBuckets.begin(), mQueryBuckets.end(), [this](uint32_t a, uint32_t b) { return ListSize(a) < ListSize(b); });
+            CollectBucket(mQueryBuckets.front(), mSlots);
+            for (size_t i = 1; i < mQueryBuckets.size() && !mSlots.empty(); ++i)
+            {
+                KeepMembers(mQueryBuckets[i], mSlots);
+            }
+
+            out.reserve(mSlots.size());
+            for (const uint32_t slot : mSlots)
+            {
+                const SpatialIndex::Entry& entry = mIndex->EntryAt(slot);
+                if (entry.live)
+                {
+                    out.push_back(entry.ref);
+                }
+            }
+            return true;
+        }
+
+        // Blocks until a background build (if any) is done and installs it.
+        void WaitForBuild()
+        {
+            Install(true);
+        }
+
+        // Drops everything (waiting for a running build), e.g. while nothing searches.
+        void Clear()
+        {
+            if (mBuild.valid())
+            {
+                mBuild.wait();
+                mBuild = {};
+            }
+            mGeneration = 0;
+            mIndex = nullptr;
+            mDocuments = Documents{};
+            mBase = Base{};
+            mOverlay = {};
+            mOverlaySize = 0;
+            mPending = {};
+            mPendingFlags = {};
+            mStats = Stats{};
+        }
+
+        // True while the worker builds a new base, which the next Update installs.
+        bool Building() const
+        {
+            return mBuild.valid();
+        }
+
+        Stats CurrentStats() const
+        {
+            Stats stats = mStats;
+            stats.buckets = mBase.offsets.empty() ? 0 : mBase.offsets.size() - 1;
+            stats.postings = mBase.postings.size();
+            stats.overlay = mOverlaySize;
+            stats.building = mBuild.valid();
+            return stats;
+        }
+
+    private:
+        static constexpr uint32_t kMinBits = 12;
+        static constexpr uint32_t kMaxBits = 20;
+        static constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+        // Overlay entries tolerated on top of postings / 8 before a rebuild, so small desktops do not
+        // rebuild on every refresh.
+        static constexpr size_t kOverlaySlack = 4096;
+
+        // Posting lists for buckets [0, 2^bits): slots offsets[b] .. offsets[b + 1] of `postings`, ascending.
+        struct Base
+        {
+            uint32_t bits = 0;
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> postings;
+        };
+
+        // Folded text of every slot, back to back in one buffer, so handing them to a build copies two
+        // arrays rather than a string per window. A changed text is rewritten in place when it fits and
+        // appended otherwise; the buffer is compacted once more than half of it is stale.
+        struct Documents
+        {
+            struct Span
+            {
+                size_t offset = 0;
+                uint32_t length = 0;
+            };
+
+            std::string text;
+            std::vector<Span> spans;
+            size_t stale = 0;
+
+            const char* Data(uint32_t slot) const
+            {
+                return text.data() + spans[slot].offset;
+            }
+
+            uint32_t Length(uint32_t slot) const
+            {
+                return slot < spans.size() ? spans[slot].length : 0;
+            }
+
+            bool Equals(uint32_t slot, const std::string& document) const
+            {
+                return Length(slot) == document.size() && std::memcmp(Data(slot), document.data(), document.size()) == 0;
+            }
+
+            void Assign(uint32_t slot, const std::string& document)
+            {
+                Span& span = spans[slot];
+                const auto length = static_cast<uint32_t>(document.size());
+                if (length > span.length)
+                {
+                    stale += span.length;
+                    span.offset = text.size();
+                    text.append(document);
+                }
+                else
+                {
+                    stale += span.length - length;
+                    text.replace(span.offset, length, document);
+                }
+                span.length = length;
+            }
+
+            void CompactIfStale()
+            {
+                if (stale < 4096 || stale * 2 < text.size())
+                {
+                    return;
+                }
+                std::string packed;
+                packed.reserve(text.size() - stale);
+                for (Span& span : spans)
+                {
+                    const size_t offset = packed.size();
+                    packed.append(text, span.offset, span.length);
+                    span.offset = offset;
+                }
+                text.swap(packed);
+                stale = 0;
+            }
+        };
+
+        struct Build
+        {
+            Base base;
+            // The texts the base was built from, to tell what changed while it was building.
+            Documents documents;
+            double milliseconds = 0.0;
+        };
+
+        // Changes to one bucket since the base was built. `added` never overlaps the base list and
+        // `removed` is always part of it; both ascending.
+        struct Overlay
+        {
+            std::vector<uint32_t> added;
+            std::vector<uint32_t> removed;
+        };
+
+        struct Op
+        {
+            uint32_t bucket = 0;
+            uint32_t slot = 0;
+            bool add = false;
+        };
+
+        // Title, class and process name, folded and separated by NULs (which no trigram spans).
+        static void AppendDocument(const InspectorSnapshot& snapshot, const WindowRef& ref, std::string& out)
+        {
+            const ProcessWindows& owner = snapshot.processes[ref.process];
+            const WindowInfo& window = owner.windows[ref.window];
+            TextSearch::AppendFolded(out, window.titleUtf8.data(), window.titleUtf8.size());
+            out.push_back('\0');
+            TextSearch::AppendFolded(out, window.classNameUtf8.data(), window.classNameUtf8.size());
+            out.push_back('\0');
+            TextSearch::AppendFolded(out, owner.process.nameUtf8.data(), owner.process.nameUtf8.size());
+        }
+
+        static uint32_t BucketOf(uint32_t trigram, uint32_t bits)
+        {
+            return (trigram * 0x9E3779B1u) >> (32 - bits);
+        }
+
+        template <typename Visit>
+        static void ForEachBucket(const char* text, size_t length, uint32_t bits, Visit&& visit)
+        {
+            uint32_t trigram = 0;
+            size_t run = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const auto byte = static_cast<unsigned char>(text[i]);
+                if (byte == 0)
+                {
+                    run = 0;
+                    continue;
+                }
+                trigram = ((trigram << 8) | byte) & 0xFFFFFFu;
+                if (++run >= 3)
+                {
+                    visit(BucketOf(trigram, bits));
+                }
+            }
+        }
+
+        // Runs on the worker thread; touches nothing but its argument. Two passes over the texts (count,
+        // then fill) lay every list out in one array, already sorted because slots are visited in order.
+        static Build BuildBase(Documents documents)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            Build build;
+            Base& base = build.base;
+            base.bits = kMinBits;
+            const auto slots = static_cast<uint32_t>(documents.spans.size());
+            while (base.bits < kMaxBits && (size_t{1} << base.bits) < slots)
+            {
+                ++base.bits;
+            }
+            const uint32_t buckets = 1u << base.bits;
+            base.offsets.assign(buckets + 1, 0);
+
+            // A slot is listed once per bucket however many of its trigrams land there.
+            std::vector<uint32_t> last(buckets, kNoSlot);
+            for (uint32_t slot = 0; slot < slots; ++slot)
+            {
+                ForEachBucket(documents.Data(slot), documents.Length(slot), base.bits, [&](uint32_t bucket) {
+                    if (last[bucket] != slot)
+                    {
+                        last[bucket] = slot;
+                        ++base.offsets[bucket + 1];
+                    }
+                });
+            }
+            for (uint32_t bucket = 0; bucket < buckets; ++bucket)
+            {
+                base.offsets[bucket + 1] += base.offsets[bucket];
+            }
+
+            base.postings.resize(base.offsets[buckets]);
+            std::vector<uint32_t> cursor(base.offsets.begin(), base.offsets.end() - 1);
+            std::fill(last.begin(), last.end(), kNoSlot);
+            for (uint32_t slot = 0; slot < slots; ++slot)
+            {
+                ForEachBucket(documents.Data(slot), documents.Length(slot), base.bits, [&](uint32_t bucket) {
+                    if (last[bucket] != slot)
+                    {
+                        last[bucket] = slot;
+                        base.postings[cursor[bucket]++] = slot;
+                    }
+                });
+            }
+
+            build.documents = std::move(documents);
+            build.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            return build;
+        }
+
+        void StartBuild()
+        {
+            mPending.clear();
+            std::fill(mPendingFlags.begin(), mPendingFlags.end(), 0);
+            mBuild = std::async(std::launch::async, &TrigramIndex::BuildBase, mDocuments);
+        }
+
+        // Swaps in a finished base, then re-applies every text that changed while it was being built.
+        void Install(bool wait)
+        {
+            if (!mBuild.valid() || (!wait && mBuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready))
+            {
+                return;
+            }
+            Build build = mBuild.get();
+            mBase = std::move(build.base);
+            mOverlay.clear();
+            mOverlaySize = 0;
+            const Documents& built = build.documents;
+            for (const uint32_t slot : mPending)
+            {
+                const uint32_t length = built.Length(slot);
+                if (length != mDocuments.Length(slot) || std::memcmp(length != 0 ? built.Data(slot) : "", mDocuments.Data(slot), length) != 0)
+                {
+                    QueueOps(slot, length != 0 ? built.Data(slot) : "", length, mDocuments.Data(slot), mDocuments.Length(slot));
+                }
+                mPendingFlags[slot] = 0;
+            }
+            mPending.clear();
+            FlushOverlay();
+            mStats.buildMilliseconds = build.milliseconds;
+        }
+
+        void Replace(uint32_t slot, const std::string& document)
+        {
+            if (!mBase.offsets.empty())
+            {
+                QueueOps(slot, mDocuments.Data(slot), mDocuments.Length(slot), document.data(), document.size());
+            }
+            if (mBuild.valid() && !mPendingFlags[slot])
+            {
+                mPendingFlags[slot] = 1;
+                mPending.push_back(slot);
+            }
+            mDocuments.Assign(slot, document);
+        }
+
+        // Sorted, distinct buckets of a text's trigrams.
+        void CollectBuckets(const char* text, size_t length, std::vector<uint32_t>& out) const
+        {
+            out.clear();
+            ForEachBucket(text, length, mBase.bits, [&out](uint32_t bucket) { out.push_back(bucket); });
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+
+        // Queues the buckets the slot leaves and enters when its text goes from `before` to `after`;
+        // buckets both texts hit are left alone, so a title that only changed a few characters costs a
+        // few ops.
+        void QueueOps(uint32_t slot, const char* before, size_t beforeLength, const char* after, size_t afterLength)
+        {
+            CollectBuckets(before, beforeLength, mBefore);
+            CollectBuckets(after, afterLength, mAfter);
+            auto old = mBefore.begin();
+            auto next = mAfter.begin();
+            while (old != mBefore.end() || next != mAfter.end())
+            {
+                if (next == mAfter.end() || (old != mBefore.end() && *old < *next))
+                {
+                    mOps.push_back(Op{*old++, slot, false});
+                }
+                else if (old == mBefore.end() || *next < *old)
+                {
+                    mOps.push_back(Op{*next++, slot, true});
+                }
+                else
+                {
+                    ++old;
+                    ++next;
+                }
+            }
+        }
+
+        // Applies the queued ops one bucket at a time. Each (bucket, slot) pair is queued at most once.
+        void FlushOverlay()
+        {
+            if (mOps.empty())
+            {
+                return;
+            }
+            // Ascending slots within a bucket mostly insert at the end of its lists.
+            std::sort(mOps.begin(), mOps.end(), [](const Op& a, const Op& b) { return a.bucket != b.bucket ? a.bucket < b.bucket : a.slot < b.slot; });
+            size_t i = 0;
+            while (i < mOps.size())
+            {
+                const uint32_t bucket = mOps[i].bucket;
+                Overlay& overlay = mOverlay[bucket];
+                const size_t before = overlay.added.size() + overlay.removed.size();
+                for (; i < mOps.size() && mOps[i].bucket == bucket; ++i)
+                {
+                    // Adding a slot the overlay removed restores its base entry; removing an added one drops it.
+                    if (mOps[i].add)
+                    {
+                        Apply(overlay.removed, mOps[i].slot, overlay.added);
+                    }
+                    else
+                    {
+                        Apply(overlay.added, mOps[i].slot, overlay.removed);
+                    }
+                }
+                const size_t after = overlay.added.size() + overlay.removed.size();
+                mOverlaySize = mOverlaySize + after - before;
+                if (after == 0)
+                {
+                    mOverlay.erase(bucket);
+                }
+            }
+            mOps.clear();
+        }
+
+        // Takes `slot` out of `cancel` if it is there, otherwise inserts it into `extend`.
+        static void Apply(std::vector<uint32_t>& cancel, uint32_t slot, std::vector<uint32_t>& extend)
+        {
+            const auto it = std::lower_bound(cancel.begin(), cancel.end(), slot);
+            if (it != cancel.end() && *it == slot)
+            {
+                cancel.erase(it);
+                return;
+            }
+            extend.insert(std::lower_bound(extend.begin(), extend.end(), slot), slot);
+        }
+
+        const Overlay* OverlayOf(uint32_t bucket) const
+        {
+            const auto it = mOverlay.find(bucket);
+            return it != mOverlay.end() ? &it->second : nullptr;
+        }
+
+        size_t ListSize(uint32_t bucket) const
+        {
+            const Overlay* overlay = OverlayOf(bucket);
+            return mBase.offsets[bucket + 1] - mBase.offsets[bucket] + (overlay != nullptr ? overlay->added.size() : 0);
+        }
+
+        // The bucket's current list: base minus removed plus added, ascending.
+        void CollectBucket(uint32_t bucket, std::vector<uint32_t>& out)
+        {
+            const uint32_t* begin = mBase.postings.data() + mBase.offsets[bucket];
+            const uint32_t* end = mBase.postings.data() + mBase.offsets[bucket + 1];
+            const Overlay* overlay = OverlayOf(bucket);
+            out.clear();
+            if (overlay == nullptr)
+            {
+                out.assign(begin, end);
+                return;
+            }
+            mMerge.clear();
+            std::set_difference(begin, end, overlay->removed.begin(), overlay->removed.end(), std::back_inserter(mMerge));
+            std::merge(mMerge.begin(), mMerge.end(), overlay->added.begin(), overlay->added.end(), std::back_inserter(out));
+        }
+
+        // Drops the slots of `slots` (ascending) that are not in the bucket's list. Each lookup resumes
+        // where the previous one stopped, so a short candidate list never walks a long posting list.
+        void KeepMembers(uint32_t bucket, std::vector<uint32_t>& slots) const
+        {
+            const uint32_t* cursor = mBase.postings.data() + mBase.offsets[bucket];
+            const uint32_t* end = mBase.postings.data() + mBase.offsets[bucket + 1];
+            const Overlay* overlay = OverlayOf(bucket);
+            size_t kept = 0;
+            for (const uint32_t slot : slots)
+            {
+                cursor = std::lower_bound(cursor, end, slot);
+                bool member = false;
+                if (cursor != end && *cursor == slot)
+                {
+                    member = overlay == nullptr || !std::binary_search(overlay->removed.begin(), overlay->removed.end(), slot);
+                }
+                else
+                {
+                    member = overlay != nullptr && std::binary_search(overlay->added.begin(), overlay->added.end(), slot);
+                }
+                if (member)
+                {
+                    slots[kept++] = slot;
+                }
+            }
+            slots.resize(kept);
+        }
+
+        uint64_t mGeneration = 0;
+        const SpatialIndex* mIndex = nullptr;
+        // Folded text per slot as of the last Update (empty for free slots).
+        Documents mDocuments;
+        Base mBase;
+        std::unordered_map<uint32_t, Overlay> mOverlay;
+        size_t mOverlaySize = 0;
+        std::future<Build> mBuild;
+        // Slots whose text changed since the running build copied mDocuments.
+        std::vector<uint32_t> mPending;
+        std::vector<uint8_t> mPendingFlags;
+        std::vector<Op> mOps;
+        std::vector<uint32_t> mBefore;
+        std::vector<uint32_t> mAfter;
+        std::vector<uint32_t> mMerge;
+        std::vector<uint32_t> mQueryBuckets;
+        std::vector<uint32_t> mSlots;
+        std::string mDocumentScratch;
+        Stats mStats;
+    };
+}
@@ -3,94 +3,911 @@
 #include <string>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <array>
 #include <algorithm>
-#include <cctype>
+#include <chrono>
+#include <functional>
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_internal.h"
-#include "imgui/imgui_impl_dx11.h"
-#include "imgui/imgui_impl_win32.h"
+#include "snapshot.hpp"
+#include "text_search.hpp"
+#include "fuzzy_search.hpp"
+#include "trigram_index.hpp"
+#include "window_tree.hpp"
+#include "spatial_index.hpp"
+#include "occlusion.hpp"
+#include "minimap.hpp"
+#include "window_grouping.hpp"
+#include "window_list.hpp"
+#include "attribute_index.hpp"
+#include "window_styles.hpp"
+#include "window_details.hpp"
+#include "process_metadata.hpp"
+#include "snapshot_diff.hpp"
+#include "window_history.hpp"
+#include "timeline.hpp"
+#include "window_stats.hpp"
+#include "stats_panel.hpp"
+#include "watch_list.hpp"
+#include "watch_panel.hpp"
+#include "compare_panel.hpp"
+#include "perf_hud.hpp"
 
 namespace Inspector
 {
-    struct ProcessInfo
+    inline bool ContainsCaseInsensitive(const std::string& text, const char* filter)
     {
-        DWORD pid = 0;
-        std::wstring name;
-    };
+        if (filter == nullptr || *filter == '\0')
+        {
+            return true;
+        }
 
-    struct WindowInfo
-    {
-        HWND handle = nullptr;
-        DWORD pid = 0;
-        DWORD threadId = 0;
-        std::wstring title;
-        std::wstring className;
-        LONG_PTR style = 0;
-        LONG_PTR exStyle = 0;
-        RECT bounds{0, 0, 0, 0};
-        bool visible = false;
-    };
+        return TextSearch::FindCaseInsensitive(text.data(), text.size(), filter, std::strlen(filter)) != nullptr;
+    }
 
-    struct ProcessWindows
+    // Draws `text` with the characters at `positions` (sorted) in the highlight colour, one run per segment.
+    inline void RenderHighlightedText(const std::string& text, const std::vector<Fuzzy::Position>& positions)
     {
-        ProcessInfo process;
-        std::vector<WindowInfo> windows;
-    };
+        if (positions.empty())
+        {
+            ImGui::TextUnformatted(text.c_str(), text.c_str() + text.size());
+            return;
+        }
+
+        const ImU32 highlight = ImGui::GetColorU32(ImGuiCol_PlotHistogram);
+        const char* begin = text.c_str();
+        size_t cursor = 0;
+        size_t index = 0;
+        bool first = true;
+        while (cursor < text.size())
+        {
+            const bool matched = index < positions.size() && static_cast<size_t>(positions[index].offset) == cursor;
+            size_t runEnd = cursor;
+            if (matched)
+            {
+                while (index < positions.size() && static_cast<size_t>(positions[index].offset) == runEnd)
+                {
+                    runEnd += static_cast<size_t>(positions[index].length);
+                    ++index;
+                }
+                runEnd = std::min(runEnd, text.size());
+            }
+            else
+            {
+                runEnd = index < positions.size() ? static_cast<size_t>(positions[index].offset) : text.size();
+            }
+
+            if (!first)
+            {
+                ImGui::SameLine(0.0f, 0.0f);
+            }
+            first = false;
+            if (matched)
+            {
+                ImGui::PushStyleColor(ImGuiCol_Text, highlight);
+            }
+            ImGui::TextUnformatted(begin + cursor, begin + runEnd);
+            if (matched)
+            {
+                ImGui::PopStyleColor();
+            }
+            cursor = runEnd;
+        }
+    }
+
+    inline void RenderFuzzyResults(const InspectorSnapshot& snapshot, Fuzzy::RankedSearch& search)
+    {
+        const auto& results = search.Results();
+        const Fuzzy::RankedSearch::SearchStats& last = search.LastSearch();
+        ImGui::Text("Matches: %zu of %zu windows", results.size(), search.EntryCount());
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%zu checked%s in %.2f ms)", last.candidates, last.indexed ? " via trigram index" : "", last.milliseconds);
+        if (results.empty())
+        {
+            ImGui::TextDisabled("No windows match the current search.");
+            return;
+        }
+
+        constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                                               ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY;
+        if (ImGui::BeginTable("##fuzzy_results", 5, tableFlags))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Score", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+            ImGui::TableSetupColumn("Process", ImGuiTableColumnFlags_WidthStretch, 0.2f);
+            ImGui::TableSetupColumn("HWND", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+            ImGui::TableSetupColumn("Title", ImGuiTableColumnFlags_WidthStretch, 0.45f);
+            ImGui::TableSetupColumn("Class", ImGuiTableColumnFlags_WidthStretch, 0.35f);
+            ImGui::TableHeadersRow();
+
+            static std::vector<Fuzzy::Position> positions;
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(results.size()));
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                {
+                    const Fuzzy::Result& result = results[static_cast<size_t>(row)];
+                    const WindowRef& ref = search.Entry(result.entry);
+                    const auto& entry = snapshot.processes[ref.process];
+                    const auto& window = entry.windows[ref.window];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%d", result.score);
+
+                    ImGui::TableSetColumnIndex(1);
+                    search.CollectPositions(snapshot, result.entry, Fuzzy::Field::Process, positions);
+                    RenderHighlightedText(entry.process.nameUtf8, positions);
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(%lu)", entry.process.pid);
+
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)));
+
+                    ImGui::TableSetColumnIndex(3);
+                    search.CollectPositions(snapshot, result.entry, Fuzzy::Field::Title, positions);
+                    RenderHighlightedText(window.titleUtf8, positions);
 
-    struct InspectorSnapshot
+                    ImGui::TableSetColumnIndex(4);
+                    search.CollectPositions(snapshot, result.entry, Fuzzy::Field::Class, positions);
+                    RenderHighlightedText(window.classNameUtf8, positions);
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    inline void RenderWindowTree(WindowTree& tree)
     {
-        SYSTEMTIME timestamp{};
-        std::vector<ProcessWindows> processes;
-        size_t totalProcessCount = 0;
-        size_t totalWindowCount = 0;
+        const auto& rows = tree.VisibleRows();
+        ImGui::Text("Rows: %zu | Loaded nodes: %zu | Top-level windows: %zu", rows.size(), tree.NodeCount(), tree.RootCount());
+        if (!tree.HasSource())
+        {
+            ImGui::TextDisabled("Child window enumeration is not available.");
+        }
+
+        constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                                               ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY;
+        if (!ImGui::BeginTable("##window_tree", 4, tableFlags))
+        {
+            return;
+        }
+
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_WidthStretch, 0.5f);
+        ImGui::TableSetupColumn("Class", ImGuiTableColumnFlags_WidthStretch, 0.3f);
+        ImGui::TableSetupColumn("Thread/Visible", ImGuiTableColumnFlags_WidthFixed, 130.0f);
+        ImGui::TableSetupColumn("Bounds", ImGuiTableColumnFlags_WidthFixed, 190.0f);
+        ImGui::TableHeadersRow();
+
+        // Toggles are applied after the loop: they rebuild `rows`.
+        uint32_t toggledNode = WindowTree::kNoNode;
+        bool toggledRecursive = false;
+        const float indent = ImGui::GetStyle().IndentSpacing;
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows.size()));
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+            {
+                const uint32_t index = rows[static_cast<size_t>(row)];
+                tree.ProbeChildren(index);
+                const WindowTree::Node& node = tree.NodeAt(index);
+                const WindowInfo& window = *node.info;
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                const float depthIndent = indent * static_cast<float>(node.depth);
+                if (depthIndent > 0.0f)
+                {
+                    ImGui::Indent(depthIndent);
+                }
+
+                ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+                if (node.children == WindowTree::ChildState::None)
+                {
+                    flags |= ImGuiTreeNodeFlags_Leaf;
+                }
+                ImGui::SetNextItemOpen(tree.IsExpanded(index));
+                ImGui::TreeNodeEx(reinterpret_cast<void*>(window.handle), flags, "0x%llX  %s",
+                                  static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)), window.titleUtf8.c_str());
+                if (ImGui::IsItemToggledOpen())
+                {
+                    toggledNode = index;
+                    toggledRecursive = ImGui::GetIO().KeyShift;
+                }
+                if (depthIndent > 0.0f)
+                {
+                    ImGui::Unindent(depthIndent);
+                }
+
+                ImGui::TableSetColumnIndex(1);
+                ImGui::TextUnformatted(window.classNameUtf8.c_str());
+
+                ImGui::TableSetColumnIndex(2);
+                ImGui::Text("TID %lu %s", window.threadId, window.visible ? "Visible" : "Hidden");
+
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("(%ld,%ld)-(%ld,%ld)", window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom);
+            }
+        }
+        ImGui::EndTable();
+
+        if (toggledNode != WindowTree::kNoNode)
+        {
+            tree.SetExpanded(toggledNode, !tree.IsExpanded(toggledNode), toggledRecursive);
+        }
+    }
+
+    // Persistent UI state, kept outside RenderInspectorUi so the headless benchmark can script it.
+    struct InspectorUiState
+    {
+        std::array<char, 128> processFilter{};
+        std::array<char, 128> fuzzyQuery{};
+        Fuzzy::RankedSearch fuzzySearch;
+        // Substring terms instead of fuzzy ones; only then is the trigram index kept up to date.
+        bool exactSearch = false;
+        TrigramIndex trigramIndex;
+        bool showWindowTree = false;
+        WindowTree windowTree;
+        bool showHitTest = false;
+        bool hitTestRegion = false;
+        std::array<int, 4> hitTestRect{0, 0, 800, 600};
+        SpatialIndex spatialIndex;
+        std::vector<uint32_t> spatialHits;
+        OcclusionMap occlusion;
+        DesktopMinimap minimap;
+        GroupingMode groupingMode = GroupingMode::Process;
+        WindowGroupings groupings;
+        GroupedWindowList windowList;
+        SnapshotDiff snapshotDiff;
+        WindowHistory history;
+        LifetimeTimeline timeline;
+        WindowStats stats;
+        StatsPanel statsPanel;
+        WatchList watchList;
+        WatchPanel watchPanel;
+        ComparePanel comparePanel;
+        WindowDetailsCache windowDetails;
+        ProcessMetadataCache processMetadata;
+        std::array<char, 128> styleFilterText{};
+        StyleFilter styleFilter;
+        // Style and state bitsets of the current snapshot, which the style filter is evaluated against.
+        AttributeIndex attributeIndex;
+        StyleNameCache styleNames;
+        // Clicked on the desktop map or in the list.
+        HWND selectedWindow = nullptr;
+        bool pickMode = false;
+        // Topmost window under the cursor while pick mode is on.
+        HWND pickedWindow = nullptr;
+        // Row the grouped view scrolls to on its next frame.
+        HWND scrollToWindow = nullptr;
+        // Process whose windows main.cpp re-enumerates and splices into the snapshot after this frame (0 = none).
+        DWORD refreshProcess = 0;
+        // Screen cursor position; main.cpp installs GetCursorPos, the benchmark leaves it empty.
+        std::function<bool(POINT& cursor)> screenCursor;
     };
 
-    inline std::string ToUtf8(const std::wstring& text)
+    inline InspectorUiState gUiState;
+
+    // Point / region query against the spatial index, listing hits topmost first.
+    inline void RenderHitTestPanel(const InspectorSnapshot& snapshot)
+    {
+        if (!gUiState.showHitTest)
+        {
+            return;
+        }
+
+        ImGui::SetNextWindowSize(ImVec2(720.0f, 360.0f), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Hit test", &gUiState.showHitTest, ImGuiWindowFlags_NoSavedSettings))
+        {
+            SpatialIndex& index = gUiState.spatialIndex;
+            auto& rect = gUiState.hitTestRect;
+            auto& hits = gUiState.spatialHits;
+            index.Update(snapshot);
+
+            if (ImGui::RadioButton("Point", !gUiState.hitTestRegion))
+            {
+                gUiState.hitTestRegion = false;
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Region", gUiState.hitTestRegion))
+            {
+                gUiState.hitTestRegion = true;
+            }
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(320.0f);
+            if (gUiState.hitTestRegion)
+            {
+                ImGui::InputInt4("Left, top, right, bottom", rect.data());
+            }
+            else
+            {
+                ImGui::InputInt2("X, Y", rect.data());
+            }
+
+            const auto queryStart = std::chrono::steady_clock::now();
+            if (gUiState.hitTestRegion)
+            {
+                index.QueryRect(RECT{rect[0], rect[1], rect[2], rect[3]}, hits);
+            }
+            else
+            {
+                index.QueryPoint(rect[0], rect[1], hits);
+            }
+            const float queryUs = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - queryStart).count();
+
+            const SpatialIndex::UpdateStats& update = index.LastUpdate();
+            ImGui::Text("Hits: %zu of %zu windows in %.1f us | last update: +%zu -%zu moved %zu%s",
+                        hits.size(), index.Size(), queryUs, update.added, update.removed, update.moved, update.rebuilt ? " (rebuilt)" : "");
+
+            constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                                                   ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY;
+            if (ImGui::BeginTable("##hit_results", 5, tableFlags))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Z", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+                ImGui::TableSetupColumn("HWND", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+                ImGui::TableSetupColumn("Process", ImGuiTableColumnFlags_WidthStretch, 0.25f);
+                ImGui::TableSetupColumn("Title", ImGuiTableColumnFlags_WidthStretch, 0.45f);
+                ImGui::TableSetupColumn("Bounds", ImGuiTableColumnFlags_WidthFixed, 190.0f);
+                ImGui::TableHeadersRow();
+
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(hits.size()));
+                while (clipper.Step())
+                {
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                    {
+                        const SpatialIndex::Entry& entry = index.EntryAt(hits[static_cast<size_t>(row)]);
+                        const auto& process = snapshot.processes[entry.ref.process];
+                        const auto& window = process.windows[entry.ref.window];
+
+                        ImGui::TableNextRow();
+                        ImGui::TableSetColumnIndex(0);
+                        ImGui::Text("%u", entry.zOrder);
+                        ImGui::TableSetColumnIndex(1);
+                        ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)));
+                        ImGui::TableSetColumnIndex(2);
+                        ImGui::TextUnformatted(process.process.nameUtf8.c_str());
+                        ImGui::TableSetColumnIndex(3);
+                        ImGui::TextUnformatted(window.titleUtf8.c_str());
+                        ImGui::TableSetColumnIndex(4);
+                        ImGui::Text("(%ld,%ld)-(%ld,%ld)", window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom);
+                    }
+                }
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
+    // Tints the current cell when `field` changed in the last refresh; `fade` is SnapshotDiff::Fade.
+    inline void HighlightChangedCell(const SnapshotDiff::Change& change, uint8_t field, float fade)
+    {
+        if ((change.fields & field) != 0)
+        {
+            ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(0.95f, 0.65f, 0.15f, 0.45f * fade)));
+        }
+    }
+
+    // One table row per window of the grouped view; the HWND cell selects the row. Rows and cells that the
+    // last refresh added or changed are tinted while `changeFade` is above zero.
+    inline void RenderWindowRow(const WindowInfo& window, float rowHeight, float changeFade)
     {
-        if (text.empty())
+        const uint32_t slot = gUiState.spatialIndex.SlotOf(window.handle);
+        const SnapshotDiff::Change change = changeFade > 0.0f ? gUiState.snapshotDiff.ChangeFor(slot) : SnapshotDiff::Change{};
+
+        ImGui::TableSetColumnIndex(0);
+        char handleLabel[32];
+        std::snprintf(handleLabel, sizeof(handleLabel), "0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)));
+        if (window.handle == gUiState.pickedWindow)
+        {
+            ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImGuiCol_HeaderHovered));
+        }
+        else if (change.row == RowChange::Added)
+        {
+            ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.25f, 0.75f, 0.35f, 0.45f * changeFade)));
+        }
+        if (ImGui::Selectable(handleLabel, window.handle == gUiState.selectedWindow, ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap,
+                              ImVec2(0.0f, rowHeight - ImGui::GetStyle().CellPadding.y * 2.0f)))
+        {
+            gUiState.selectedWindow = window.handle;
+        }
+
+        ImGui::TableSetColumnIndex(1);
+        HighlightChangedCell(change, ChangedField::Title, changeFade);
+        ImGui::TextUnformatted(window.titleUtf8.c_str());
+
+        ImGui::TableSetColumnIndex(2);
+        HighlightChangedCell(change, ChangedField::Class, changeFade);
+        ImGui::TextUnformatted(window.classNameUtf8.c_str());
+
+        ImGui::TableSetColumnIndex(3);
+        HighlightChangedCell(change, ChangedField::State, changeFade);
+        const OcclusionResult* occlusion = gUiState.occlusion.ResultFor(slot);
+        if (!window.visible || occlusion == nullptr)
+        {
+            ImGui::Text("TID %lu\n%s", window.threadId, window.visible ? "Visible" : "Hidden");
+        }
+        else
         {
-            return {};
+            if (occlusion->FullyHidden())
+            {
+                ImGui::TextColored(ImVec4(1.0f, 0.65f, 0.3f, 1.0f), "TID %lu\nVisible, covered", window.threadId);
+            }
+            else
+            {
+                ImGui::Text("TID %lu\nVisible %.0f%%", window.threadId, occlusion->VisiblePercent());
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Unoccluded on-screen area: %lld of %lld px",
+                                  static_cast<long long>(occlusion->visibleArea), static_cast<long long>(occlusion->windowArea));
+            }
         }
 
-        const int required = ::WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
-        if (required <= 0)
+        ImGui::TableSetColumnIndex(4);
+        HighlightChangedCell(change, ChangedField::Styles, changeFade);
+        const StyleNames& styles = gUiState.styleNames.Get(window.style, window.exStyle);
+        ImGui::BeginGroup();
+        ImGui::TextUnformatted(styles.styleCompact.c_str());
+        ImGui::TextUnformatted(styles.exStyleCompact.c_str());
+        ImGui::EndGroup();
+        if (ImGui::IsItemHovered())
         {
-            return {};
+            ImGui::SetNextWindowSize(ImVec2(480.0f, 0.0f));
+            ImGui::BeginTooltip();
+            ImGui::TextWrapped("S:0x%08llX  %s", static_cast<unsigned long long>(window.style), styles.style.c_str());
+            ImGui::TextWrapped("E:0x%08llX  %s", static_cast<unsigned long long>(window.exStyle), styles.exStyle.c_str());
+            ImGui::EndTooltip();
         }
 
-        std::string utf8(static_cast<size_t>(required), '\0');
-        ::WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), utf8.data(), required, nullptr, nullptr);
-        return utf8;
+        ImGui::TableSetColumnIndex(5);
+        HighlightChangedCell(change, ChangedField::Bounds, changeFade);
+        const LONG width = window.bounds.right - window.bounds.left;
+        const LONG height = window.bounds.bottom - window.bounds.top;
+        ImGui::Text("(%ld,%ld)-(%ld,%ld)\n[%ldx%ld]",
+                    window.bounds.left, window.bounds.top,
+                    window.bounds.right, window.bounds.bottom,
+                    width, height);
+    }
+
+    // Row of the removed group: what the window looked like in the previous snapshot, dimmed.
+    inline void RenderRemovedWindowRow(const RemovedWindow& window, float changeFade)
+    {
+        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImVec4(0.85f, 0.25f, 0.25f, 0.15f + 0.35f * changeFade)));
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetColorU32(ImGuiCol_TextDisabled));
+        ImGui::TableSetColumnIndex(0);
+        ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)));
+        ImGui::TableSetColumnIndex(1);
+        ImGui::TextUnformatted(window.titleUtf8.c_str());
+        ImGui::TableSetColumnIndex(2);
+        ImGui::TextUnformatted(window.classNameUtf8.c_str());
+        ImGui::TableSetColumnIndex(3);
+        ImGui::Text("PID %lu\nRemoved", window.pid);
+        ImGui::TableSetColumnIndex(5);
+        ImGui::Text("(%ld,%ld)-(%ld,%ld)", window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom);
+        ImGui::PopStyleColor();
     }
 
-    inline std::string FormatTimestamp(const SYSTEMTIME& time)
+    inline void FormatByteCount(uint64_t bytes, char* buffer, size_t size)
     {
-        if (time.wYear == 0)
+        if (bytes >= (uint64_t{1} << 30))
         {
-            return {};
+            std::snprintf(buffer, size, "%.2f GiB", static_cast<double>(bytes) / static_cast<double>(uint64_t{1} << 30));
         }
+        else
+        {
+            std::snprintf(buffer, size, "%.1f MiB", static_cast<double>(bytes) / static_cast<double>(uint64_t{1} << 20));
+        }
+    }
 
-        char buffer[64] = {};
-        std::snprintf(buffer, sizeof(buffer), "%04u-%02u-%02u %02u:%02u:%02u",
-                      static_cast<unsigned>(time.wYear), static_cast<unsigned>(time.wMonth), static_cast<unsigned>(time.wDay),
-                      static_cast<unsigned>(time.wHour), static_cast<unsigned>(time.wMinute), static_cast<unsigned>(time.wSecond));
-        return std::string(buffer);
+    // Parent and thread count from the snapshot, image path, command line and memory from ProcessMetadataCache,
+    // which queries them on first use and keeps them for as long as the process lives.
+    inline void RenderProcessSummary(const ProcessInfo& process)
+    {
+        ProcessMetadataCache& cache = gUiState.processMetadata;
+        const ProcessMetadata* metadata = cache.Request(process, kProcessImagePath | kProcessCommandLine | kProcessMemory);
+        ImGui::Text("%s  parent PID %lu, %lu threads", process.nameUtf8.c_str(), static_cast<unsigned long>(process.parentPid),
+                    static_cast<unsigned long>(process.threadCount));
+        if (!cache.HasProvider())
+        {
+            ImGui::TextDisabled("Process metadata is not available in this build.");
+            return;
+        }
+        if (metadata == nullptr)
+        {
+            ImGui::TextDisabled("Querying process...");
+            return;
+        }
+        if (!metadata->alive)
+        {
+            ImGui::TextDisabled("The process has exited.");
+            return;
+        }
+        if (!metadata->accessible)
+        {
+            ImGui::TextDisabled("<access denied>");
+            return;
+        }
+        ImGui::PushTextWrapPos(ImGui::GetCursorPosX() + std::max(ImGui::GetContentRegionAvail().x, 480.0f));
+        if ((metadata->fields & kProcessImagePath) != 0)
+        {
+            ImGui::TextWrapped("%s", metadata->imagePath.empty() ? "<image path unavailable>" : metadata->imagePath.c_str());
+        }
+        if ((metadata->fields & kProcessCommandLine) != 0)
+        {
+            ImGui::TextDisabled("%s", metadata->commandLine.empty() ? "<no command line>" : metadata->commandLine.c_str());
+        }
+        ImGui::PopTextWrapPos();
+        if ((metadata->fields & kProcessMemory) != 0)
+        {
+            char workingSet[32] = {};
+            char peak[32] = {};
+            char privateBytes[32] = {};
+            FormatByteCount(metadata->workingSetBytes, workingSet, sizeof(workingSet));
+            FormatByteCount(metadata->peakWorkingSetBytes, peak, sizeof(peak));
+            FormatByteCount(metadata->privateBytes, privateBytes, sizeof(privateBytes));
+            ImGui::Text("Working set %s (peak %s), private %s", workingSet, peak, privateBytes);
+        }
     }
 
-    inline bool ContainsCaseInsensitive(const std::string& text, const char* filter)
+    // Grouped window view as a single clipped table, grouped by gUiState.groupingMode: only the rows on
+    // screen are submitted, and gUiState.scrollToWindow jumps straight to its row (expanding the group)
+    // without walking the list.
+    inline void RenderGroupedWindows(const InspectorSnapshot& snapshot, GroupedWindowList& list)
     {
-        if (filter == nullptr || *filter == '\0')
+        const WindowGrouping* grouping = gUiState.groupings.Get(gUiState.groupingMode);
+        if (grouping == nullptr)
         {
-            return true;
+            if (!snapshot.processes.empty())
+            {
+                ImGui::TextDisabled("Grouping windows by %s...", GroupingModeName(gUiState.groupingMode));
+            }
+            return;
+        }
+        const std::vector<RemovedWindow>& removed = gUiState.snapshotDiff.Removed();
+        list.Sync(snapshot, *grouping, gUiState.processFilter.data(), gUiState.styleFilter, removed.size(), &gUiState.attributeIndex);
+        const float changeFade = gUiState.snapshotDiff.Fade(ImGui::GetTime());
+
+        size_t scrollRow = GroupedWindowList::kNoRow;
+        if (gUiState.scrollToWindow != nullptr)
+        {
+            const uint32_t slot = gUiState.spatialIndex.SlotOf(gUiState.scrollToWindow);
+            if (slot != SpatialIndex::kNoEntry)
+            {
+                scrollRow = list.RevealRow(gUiState.spatialIndex.EntryAt(slot).ref);
+            }
+            if (scrollRow == GroupedWindowList::kNoRow)
+            {
+                gUiState.scrollToWindow = nullptr;
+            }
+        }
+
+        const auto& rows = list.Rows();
+        if (list.GroupCount() == 0)
+        {
+            if (!snapshot.processes.empty())
+            {
+                ImGui::TextDisabled("No windows match the current filters.");
+            }
+            return;
+        }
+
+        constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable |
+                                               ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_ScrollY;
+        if (!ImGui::BeginTable("##win_table", 6, tableFlags))
+        {
+            return;
+        }
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("HWND", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+        ImGui::TableSetupColumn("Title", ImGuiTableColumnFlags_WidthStretch, 0.35f);
+        ImGui::TableSetupColumn("Class", ImGuiTableColumnFlags_WidthStretch, 0.25f);
+        ImGui::TableSetupColumn("Thread/Visible", ImGuiTableColumnFlags_WidthFixed, 130.0f);
+        ImGui::TableSetupColumn("Styles", ImGuiTableColumnFlags_WidthFixed, 170.0f);
+        ImGui::TableSetupColumn("Bounds", ImGuiTableColumnFlags_WidthFixed, 190.0f);
+        ImGui::TableHeadersRow();
+
+        // Header and window rows share one height so the clipper can step over them uniformly.
+        const float rowHeight = ImGui::GetTextLineHeight() * 2.0f + ImGui::GetStyle().CellPadding.y * 2.0f;
+        uint32_t toggledGroup = GroupedWindowList::kHeaderRow;
+        char groupLabel[256];
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows.size()), rowHeight);
+        if (scrollRow != GroupedWindowList::kNoRow)
+        {
+            clipper.IncludeItemByIndex(static_cast<int>(scrollRow));
+        }
+        while (clipper.Step())
+        {
+            for (int index = clipper.DisplayStart; index < clipper.DisplayEnd; ++index)
+            {
+                const GroupedWindowList::Row& row = rows[static_cast<size_t>(index)];
+                ImGui::TableNextRow(ImGuiTableRowFlags_None, rowHeight);
+                ImGui::PushID(index);
+                if (row.group == GroupedWindowList::kRemovedGroup)
+                {
+                    if (row.item == GroupedWindowList::kHeaderRow)
+                    {
+                        ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImGuiCol_TableHeaderBg));
+                        ImGui::TableSetColumnIndex(0);
+                        const bool collapsed = list.IsCollapsed(row.group);
+                        ImGui::SetNextItemOpen(!collapsed);
+                        if (ImGui::TreeNodeEx("##removed", ImGuiTreeNodeFlags_SpanAllColumns | ImGuiTreeNodeFlags_NoTreePushOnOpen,
+                                              "Removed since last refresh (%zu)", removed.size()) == collapsed)
+                        {
+                            toggledGroup = row.group;
+                        }
+                    }
+                    else
+                    {
+                        RenderRemovedWindowRow(removed[row.item], changeFade);
+                    }
+                    ImGui::PopID();
+                    continue;
+                }
+
+                if (row.item == GroupedWindowList::kHeaderRow)
+                {
+                    ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(ImGuiCol_TableHeaderBg));
+                    ImGui::TableSetColumnIndex(0);
+                    const bool collapsed = list.IsCollapsed(row.group);
+                    const uint32_t windowCount = grouping->GroupSize(row.group);
+                    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanAllColumns | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowOverlap;
+                    if (windowCount == 0)
+                    {
+                        flags |= ImGuiTreeNodeFlags_Leaf;
+                    }
+                    const char* label = groupLabel;
+                    if (grouping->mode == GroupingMode::Process)
+                    {
+                        label = snapshot.processes[row.group].headerLabel.c_str();
+                    }
+                    else
+                    {
+                        FormatGroupLabel(snapshot, gUiState.spatialIndex, *grouping, row.group, groupLabel, sizeof(groupLabel));
+                    }
+                    ImGui::SetNextItemOpen(!collapsed);
+                    if (ImGui::TreeNodeEx("##group", flags, "%s", label) == collapsed && windowCount != 0)
+                    {
+                        toggledGroup = row.group;
+                    }
+                    if (grouping->mode == GroupingMode::Process && ImGui::IsItemHovered(ImGuiHoveredFlags_DelayShort) && ImGui::BeginTooltip())
+                    {
+                        RenderProcessSummary(snapshot.processes[row.group].process);
+                        ImGui::EndTooltip();
+                    }
+                    ImGui::TableSetColumnIndex(3);
+                    if (windowCount == 0)
+                    {
+                        ImGui::TextDisabled("No top-level windows.");
+                    }
+                    else
+                    {
+                        ImGui::TextDisabled("Windows: %u", windowCount);
+                    }
+                    if (grouping->mode == GroupingMode::Process)
+                    {
+                        ImGui::TableSetColumnIndex(5);
+                        if (ImGui::SmallButton("Refresh process"))
+                        {
+                            gUiState.refreshProcess = snapshot.processes[row.group].process.pid;
+                        }
+                        if (ImGui::IsItemHovered())
+                        {
+                            ImGui::SetTooltip("Re-enumerate only this process's windows and update them in place.");
+                        }
+                    }
+                }
+                else
+                {
+                    const WindowRef& ref = grouping->order[row.item];
+                    RenderWindowRow(snapshot.processes[ref.process].windows[ref.window], rowHeight, changeFade);
+                }
+
+                if (static_cast<size_t>(index) == scrollRow)
+                {
+                    ImGui::SetScrollHereY(0.5f);
+                    gUiState.scrollToWindow = nullptr;
+                }
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndTable();
+
+        if (toggledGroup != GroupedWindowList::kHeaderRow)
+        {
+            list.SetCollapsed(toggledGroup, !list.IsCollapsed(toggledGroup));
+        }
+    }
+
+    // Pick mode: the topmost visible window under the cursor on the desktop map, or anywhere on screen
+    // while the cursor is outside the inspector. Resolved from the snapshot's Z order and bounds.
+    inline void UpdatePick(const InspectorSnapshot& snapshot)
+    {
+        if (!gUiState.pickMode)
+        {
+            gUiState.pickedWindow = nullptr;
+            return;
+        }
+
+        const SpatialIndex& index = gUiState.spatialIndex;
+        uint32_t slot = gUiState.minimap.visible ? gUiState.minimap.HoveredSlot() : SpatialIndex::kNoEntry;
+        POINT cursor{};
+        if (slot == SpatialIndex::kNoEntry && !ImGui::IsMousePosValid() && gUiState.screenCursor && gUiState.screenCursor(cursor))
+        {
+            slot = TopmostVisibleAt(snapshot, index, cursor.x, cursor.y);
+        }
+
+        const HWND picked = slot != SpatialIndex::kNoEntry ? index.EntryAt(slot).handle : nullptr;
+        if (picked != nullptr && picked != gUiState.pickedWindow)
+        {
+            gUiState.scrollToWindow = picked;
+        }
+        gUiState.pickedWindow = picked;
+    }
+
+    inline void RenderWindowLink(const char* id, HWND handle)
+    {
+        if (handle == nullptr)
+        {
+            ImGui::TextDisabled("none");
+            return;
+        }
+        ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(handle)));
+        if (gUiState.spatialIndex.SlotOf(handle) != SpatialIndex::kNoEntry)
+        {
+            ImGui::SameLine();
+            ImGui::PushID(id);
+            if (ImGui::SmallButton("Select"))
+            {
+                gUiState.selectedWindow = handle;
+                gUiState.scrollToWindow = handle;
+            }
+            ImGui::PopID();
+        }
+    }
+
+    // Detail pane for the selected window. Snapshot fields and decoded styles are shown at once; the rest
+    // comes from WindowDetailsCache, which queries it off the UI thread and keeps it until the window changes.
+    inline void RenderDetailsPane(const InspectorSnapshot& snapshot)
+    {
+        const HWND selected = gUiState.selectedWindow;
+        if (selected == nullptr)
+        {
+            return;
+        }
+
+        bool open = true;
+        ImGui::SetNextWindowSize(ImVec2(560.0f, 520.0f), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Window details", &open, ImGuiWindowFlags_NoSavedSettings))
+        {
+            const SpatialIndex& index = gUiState.spatialIndex;
+            const uint32_t slot = index.SlotOf(selected);
+            if (slot == SpatialIndex::kNoEntry)
+            {
+                ImGui::TextDisabled("0x%llX is not in the current snapshot.", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(selected)));
+            }
+            else
+            {
+                const WindowRef& ref = index.EntryAt(slot).ref;
+                const auto& entry = snapshot.processes[ref.process];
+                const auto& window = entry.windows[ref.window];
+                ImGui::Text("0x%llX  %s", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)), window.titleUtf8.c_str());
+                ImGui::TextDisabled("%s | %s | TID %lu", window.classNameUtf8.c_str(), entry.headerLabel.c_str(), window.threadId);
+                ImGui::SameLine();
+                if (!gUiState.watchList.IsPinned(selected))
+                {
+                    if (ImGui::SmallButton("Watch"))
+                    {
+                        gUiState.watchList.Pin(selected);
+                        gUiState.watchPanel.visible = true;
+                    }
+                }
+                else if (ImGui::SmallButton("Unwatch"))
+                {
+                    gUiState.watchList.Unpin(selected);
+                }
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Refresh process"))
+                {
+                    gUiState.refreshProcess = window.pid;
+                }
+
+                WindowDetailsCache& cache = gUiState.windowDetails;
+                cache.Sync(snapshot, index);
+                const WindowDetails* details = cache.Request(selected, WindowFingerprint(window));
+
+                constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+                const auto field = [](const char* label) {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextDisabled("%s", label);
+                    ImGui::TableSetColumnIndex(1);
+                };
+                if (ImGui::BeginTable("##details", 2, tableFlags))
+                {
+                    ImGui::TableSetupColumn("Field", ImGuiTableColumnFlags_WidthFixed, 110.0f);
+                    ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+                    const StyleNames& styles = gUiState.styleNames.Get(window.style, window.exStyle);
+                    field("Style");
+                    ImGui::TextWrapped("0x%08llX  %s", static_cast<unsigned long long>(window.style), styles.style.c_str());
+                    field("Ex style");
+                    ImGui::TextWrapped("0x%08llX  %s", static_cast<unsigned long long>(window.exStyle), styles.exStyle.c_str());
+                    field("Bounds");
+                    ImGui::Text("(%ld,%ld)-(%ld,%ld)", window.bounds.left, window.bounds.top, window.bounds.right, window.bounds.bottom);
+
+                    if (details != nullptr && details->alive)
+                    {
+                        field("Owner");
+                        RenderWindowLink("owner", details->owner);
+                        field("Parent");
+                        RenderWindowLink("parent", details->parent);
+                        field("DPI");
+                        ImGui::Text("%u (%u%%)", details->dpi, details->dpi * 100 / 96);
+                        field("Monitor");
+                        ImGui::Text("%s%s (%ld,%ld)-(%ld,%ld)", details->monitorName.c_str(), details->primaryMonitor ? " primary" : "",
+                                    details->monitorBounds.left, details->monitorBounds.top, details->monitorBounds.right, details->monitorBounds.bottom);
+                        field("Work area");
+                        ImGui::Text("(%ld,%ld)-(%ld,%ld)", details->workArea.left, details->workArea.top, details->workArea.right, details->workArea.bottom);
+                        field("Class");
+                        ImGui::Text("atom 0x%04X | extra %d B, per window %d B | instance 0x%llX", static_cast<unsigned>(details->classAtom),
+                                    details->classExtraBytes, details->windowExtraBytes, static_cast<unsigned long long>(details->classModule));
+                        field("Class style");
+                        ImGui::TextWrapped("0x%08X  %s", static_cast<unsigned>(details->classStyle), details->classStyleNames.c_str());
+                        field("Module");
+                        ImGui::TextWrapped("%s", details->modulePath.empty() ? "<access denied>" : details->modulePath.c_str());
+                    }
+                    ImGui::EndTable();
+                }
+
+                ImGui::SeparatorText("Process");
+                RenderProcessSummary(entry.process);
+
+                if (!cache.HasProvider())
+                {
+                    ImGui::TextDisabled("Extended properties are not available in this build.");
+                }
+                else if (details == nullptr)
+                {
+                    ImGui::TextDisabled("Querying extended properties...");
+                }
+                else if (!details->alive)
+                {
+                    ImGui::TextDisabled("The window no longer exists.");
+                }
+                else
+                {
+                    ImGui::SeparatorText("Properties (EnumProps)");
+                    if (details->properties.empty())
+                    {
+                        ImGui::TextDisabled("None.");
+                    }
+                    for (const WindowProperty& property : details->properties)
+                    {
+                        ImGui::Text("%s = 0x%llX", property.name.c_str(), static_cast<unsigned long long>(property.value));
+                    }
+                    ImGui::Separator();
+                    ImGui::TextDisabled("Queried in %.2f ms", details->queryMs);
+                    ImGui::SameLine();
+                    if (ImGui::SmallButton("Re-query"))
+                    {
+                        cache.Invalidate(selected);
+                    }
+                }
+            }
         }
+        ImGui::End();
 
-        std::string lowerText = text;
-        std::string lowerFilter(filter);
-        std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        return lowerText.find(lowerFilter) != std::string::npos;
+        if (!open)
+        {
+            gUiState.selectedWindow = nullptr;
+        }
     }
 
     inline bool RenderInspectorUi(float deltaSeconds, const InspectorSnapshot& snapshot)
@@ -103,7 +920,10 @@ namespace Inspector
             return false;
         }
 
-        static std::array<char, 128> processFilter{};
+        auto& processFilter = gUiState.processFilter;
+        auto& fuzzyQuery = gUiState.fuzzyQuery;
+        auto& fuzzySearch = gUiState.fuzzySearch;
+        auto& windowTree = gUiState.windowTree;
 
         ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
         ImGui::SetNextWindowSize(io.DisplaySize);
@@ -116,24 +936,161 @@ namespace Inspector
                                                  ImGuiWindowFlags_NoBringToFrontOnFocus;
         if (ImGui::Begin("Window Inspector", nullptr, windowFlags))
         {
-            //ImGui::Text("Frame time: %.3f ms | FPS: %.1f", deltaSeconds * 1000.0f, fps);
-            // ImGui::SameLine();
             if (ImGui::Button("Refresh"))
             {
                 refreshRequested = true;
             }
 
+            ImGui::SameLine();
+            ImGui::Checkbox("Perf HUD", &gPerfHud.visible);
+            if (gPerfHud.visible)
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("Frame time: %.3f ms | FPS: %.1f", deltaSeconds * 1000.0f, fps);
+            }
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Child tree", &gUiState.showWindowTree);
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Browse child windows; Shift+click an arrow to expand a whole subtree.");
+            }
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Hit test", &gUiState.showHitTest);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Desktop map", &gUiState.minimap.visible);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Timeline", &gUiState.timeline.visible);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Stats", &gUiState.statsPanel.visible);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Watch", &gUiState.watchPanel.visible);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Compare", &gUiState.comparePanel.visible);
+
+            ImGui::SameLine();
+            ImGui::Checkbox("Pick", &gUiState.pickMode);
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Hover the desktop map, or move the cursor outside this window, to locate the topmost window under it.");
+            }
+
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(130.0f);
+            if (ImGui::BeginCombo("##GroupBy", GroupingModeName(gUiState.groupingMode)))
+            {
+                for (size_t mode = 0; mode < kGroupingModeCount; ++mode)
+                {
+                    const GroupingMode option = static_cast<GroupingMode>(mode);
+                    if (ImGui::Selectable(GroupingModeName(option), option == gUiState.groupingMode))
+                    {
+                        gUiState.groupingMode = option;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Group the window list by process, class, thread, monitor, visibility or top-level owner.");
+            }
+
             ImGui::SameLine();
             ImGui::SetNextItemWidth(250.0f);
             ImGui::InputTextWithHint("##ProcessFilter", "Filter by process name", processFilter.data(), processFilter.size());
 
-            const std::string timestamp = FormatTimestamp(snapshot.timestamp);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(300.0f);
+            ImGui::InputTextWithHint("##FuzzySearch", gUiState.exactSearch ? "Search (process, title, class)" : "Fuzzy search (process, title, class)",
+                                     fuzzyQuery.data(), fuzzyQuery.size());
+
+            ImGui::SameLine();
+            if (ImGui::Checkbox("Exact", &gUiState.exactSearch) && !gUiState.exactSearch)
+            {
+                gUiState.trigramIndex.Clear();
+            }
+            if (ImGui::IsItemHovered())
+            {
+                const TrigramIndex::Stats indexStats = gUiState.trigramIndex.CurrentStats();
+                ImGui::SetTooltip("Match every term as a case-insensitive substring, narrowed by a trigram index.\n"
+                                  "Index: %zu postings in %zu buckets, %zu overlay entries%s (built in %.1f ms, updated in %.2f ms).",
+                                  indexStats.postings, indexStats.buckets, indexStats.overlay, indexStats.building ? ", rebuilding" : "",
+                                  indexStats.buildMilliseconds, indexStats.updateMilliseconds);
+            }
+
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(260.0f);
+            const bool styleFilterValid = gUiState.styleFilter.Error().empty();
+            if (!styleFilterValid)
+            {
+                ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.45f, 0.12f, 0.12f, 1.0f));
+            }
+            if (ImGui::InputTextWithHint("##StyleFilter", "Style flags, e.g. WS_VISIBLE !TOOLWINDOW", gUiState.styleFilterText.data(), gUiState.styleFilterText.size()))
+            {
+                gUiState.styleFilter.Compile(gUiState.styleFilterText.data());
+            }
+            if (!styleFilterValid)
+            {
+                ImGui::PopStyleColor();
+            }
+            if (ImGui::IsItemHovered())
+            {
+                if (styleFilterValid && gUiState.styleFilter.Active() && gUiState.attributeIndex.Synced(snapshot))
+                {
+                    gUiState.attributeIndex.Evaluate(gUiState.styleFilter);
+                    const AttributeIndex::Stats& attributeStats = gUiState.attributeIndex.CurrentStats();
+                    ImGui::SetTooltip("%zu of %zu windows match (evaluated in %.1f us).", attributeStats.matches, attributeStats.windows,
+                                      attributeStats.evaluateMicroseconds);
+                }
+                else if (styleFilterValid)
+                {
+                    ImGui::SetTooltip("Grouped view: windows with every listed WS_/WS_EX_ flag and none of the '!' ones.\n"
+                                      "a/b requires either flag; SHOWN, ZEROSIZE and OWNED filter on window state.");
+                }
+                else
+                {
+                    ImGui::SetTooltip("Unknown style flag \"%s\"", gUiState.styleFilter.Error().c_str());
+                }
+            }
+
+            // All of these are no-ops until the next snapshot arrives.
+            gUiState.spatialIndex.Update(snapshot);
+            gUiState.occlusion.Update(snapshot, gUiState.spatialIndex);
+            gUiState.snapshotDiff.Update(snapshot, gUiState.spatialIndex, ImGui::GetTime());
+            gUiState.stats.Update(snapshot, gUiState.spatialIndex, gUiState.snapshotDiff);
+            gUiState.attributeIndex.Sync(snapshot);
+            gUiState.processMetadata.Sync(snapshot);
+            if (gUiState.exactSearch)
+            {
+                gUiState.trigramIndex.Update(snapshot, gUiState.spatialIndex, gUiState.snapshotDiff);
+            }
+            gUiState.groupings.Sync(snapshot);
+            gUiState.watchList.Sync(snapshot);
+            UpdatePick(snapshot);
+            if (gUiState.timeline.recording && snapshot.generation != 0)
+            {
+                gUiState.history.Record(snapshot, ImGui::GetTime());
+                refreshRequested = refreshRequested || ImGui::GetTime() - gUiState.history.LastTime() >= LifetimeTimeline::kCaptureInterval;
+            }
+
             if (!snapshot.processes.empty())
             {
-                ImGui::Text("Processes: %zu | Windows: %zu | Last refresh: %s",
+                const SnapshotDiff::UpdateStats& changes = gUiState.snapshotDiff.LastUpdate();
+                ImGui::Text("Processes: %zu | Windows: %zu | Covered: %zu | Last refresh: %s | Changes: +%zu -%zu ~%zu",
                             snapshot.totalProcessCount,
                             snapshot.totalWindowCount,
-                            timestamp.empty() ? "N/A" : timestamp.c_str());
+                            gUiState.occlusion.FullyHiddenCount(),
+                            snapshot.timestampLabel.c_str(),
+                            changes.added, changes.removed, changes.changed);
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Added, removed and changed windows since the previous snapshot (diffed in %.2f ms).", changes.milliseconds);
+                }
             }
             else
             {
@@ -142,85 +1099,45 @@ namespace Inspector
 
             ImGui::Separator();
 
-            size_t visibleCount = 0;
+            const bool fuzzyActive = fuzzyQuery[0] != '\0';
+            if (fuzzyActive)
+            {
+                fuzzySearch.Update(snapshot, fuzzyQuery.data(), gUiState.exactSearch, &gUiState.trigramIndex);
+            }
+
             if (ImGui::BeginChild("ProcessList", ImVec2(0, 0), true))
             {
-                for (const auto& entry : snapshot.processes)
+                if (fuzzyActive)
                 {
-                    std::string processName = entry.process.name.empty() ? std::string("<Unknown>") : ToUtf8(entry.process.name);
-                    if (!ContainsCaseInsensitive(processName, processFilter.data()))
-                    {
-                        continue;
-                    }
-
-                    ++visibleCount;
-                    std::string headerLabel = processName + " [PID " + std::to_string(entry.process.pid) + "]##proc_" + std::to_string(entry.process.pid);
-
-                    if (ImGui::CollapsingHeader(headerLabel.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
-                    {
-                        ImGui::Text("Windows: %zu", entry.windows.size());
-                        if (entry.windows.empty())
-                        {
-                            ImGui::TextDisabled("No top-level windows.");
-                            continue;
-                        }
-
-                        const std::string tableId = "##win_table_" + std::to_string(entry.process.pid);
-                        if (ImGui::BeginTable(tableId.c_str(), 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp))
-                        {
-                            ImGui::TableSetupColumn("HWND", ImGuiTableColumnFlags_WidthFixed, 110.0f);
-                            ImGui::TableSetupColumn("Title", ImGuiTableColumnFlags_WidthStretch, 0.35f);
-                            ImGui::TableSetupColumn("Class", ImGuiTableColumnFlags_WidthStretch, 0.25f);
-                            ImGui::TableSetupColumn("Thread/Visible", ImGuiTableColumnFlags_WidthFixed, 130.0f);
-                            ImGui::TableSetupColumn("Styles", ImGuiTableColumnFlags_WidthFixed, 170.0f);
-                            ImGui::TableSetupColumn("Bounds", ImGuiTableColumnFlags_WidthFixed, 190.0f);
-                            ImGui::TableHeadersRow();
-
-                            for (const auto& window : entry.windows)
-                            {
-                                ImGui::TableNextRow();
-                                ImGui::TableSetColumnIndex(0);
-                                ImGui::Text("0x%llX", static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle)));
-
-                                ImGui::TableSetColumnIndex(1);
-                                const std::string title = window.title.empty() ? std::string("<No Title>") : ToUtf8(window.title);
-                                ImGui::TextUnformatted(title.c_str());
-
-                                ImGui::TableSetColumnIndex(2);
-                                const std::string className = window.className.empty() ? std::string("<UnknownClass>") : ToUtf8(window.className);
-                                ImGui::TextUnformatted(className.c_str());
-
-                                ImGui::TableSetColumnIndex(3);
-                                ImGui::Text("TID %lu\n%s", window.threadId, window.visible ? "Visible" : "Hidden");
-
-                                ImGui::TableSetColumnIndex(4);
-                                ImGui::Text("S:0x%08llX\nE:0x%08llX",
-                                            static_cast<unsigned long long>(window.style),
-                                            static_cast<unsigned long long>(window.exStyle));
-
-                                ImGui::TableSetColumnIndex(5);
-                                const LONG width = window.bounds.right - window.bounds.left;
-                                const LONG height = window.bounds.bottom - window.bounds.top;
-                                ImGui::Text("(%ld,%ld)-(%ld,%ld)\n[%ldx%ld]",
-                                            window.bounds.left, window.bounds.top,
-                                            window.bounds.right, window.bounds.bottom,
-                                            width, height);
-                            }
-
-                            ImGui::EndTable();
-                        }
-                    }
+                    RenderFuzzyResults(snapshot, fuzzySearch);
                 }
-
-                if (visibleCount == 0 && !snapshot.processes.empty())
+                else if (gUiState.showWindowTree)
+                {
+                    windowTree.Sync(snapshot, processFilter.data());
+                    RenderWindowTree(windowTree);
+                }
+                else
                 {
-                    ImGui::TextDisabled("No processes match the current filter.");
+                    RenderGroupedWindows(snapshot, gUiState.windowList);
                 }
             }
             ImGui::EndChild();
         }
         ImGui::End();
 
+        RenderHitTestPanel(snapshot);
+        const HWND previousSelection = gUiState.selectedWindow;
+        gUiState.minimap.Render(snapshot, gUiState.spatialIndex, gUiState.selectedWindow);
+        gUiState.timeline.Render(gUiState.history, gUiState.selectedWindow);
+        gUiState.statsPanel.Render(gUiState.stats);
+        gUiState.watchPanel.Render(gUiState.watchList, gUiState.selectedWindow);
+        gUiState.comparePanel.Render(snapshot, gUiState.selectedWindow);
+        if (gUiState.selectedWindow != previousSelection)
+        {
+            gUiState.scrollToWindow = gUiState.selectedWindow;
+        }
+        RenderDetailsPane(snapshot);
+        gPerfHud.Render();
         return refreshRequested;
     }
 }
@@ -0,0 +1,360 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "text_search.hpp"
+
+namespace Inspector
+{
+    // The fields a watch poll re-reads.
+    struct WatchSample
+    {
+        std::wstring title;
+        RECT bounds{0, 0, 0, 0};
+        LONG_PTR style = 0;
+        LONG_PTR exStyle = 0;
+    };
+
+    // Where samples come from; main.cpp queries Win32. Returns false once the window is gone. Called on
+    // the UI thread, so it must stay cheap: no messages to the window's thread, no process handles.
+    using WatchProvider = std::function<bool(HWND window, WatchSample& sample)>;
+
+    enum class WatchField : uint8_t
+    {
+        Title,
+        Bounds,
+        Styles
+    };
+
+    inline const char* WatchFieldName(WatchField field)
+    {
+        switch (field)
+        {
+        case WatchField::Title:
+            return "Title";
+        case WatchField::Bounds:
+            return "Bounds";
+        default:
+            return "Styles";
+        }
+    }
+
+    struct WatchChange
+    {
+        std::chrono::steady_clock::time_point time;
+        WatchField field = WatchField::Title;
+        // The field's new value, formatted when the change was seen.
+        std::string value;
+    };
+
+    // Adds every window of a snapshot whose title, class or process name contains `text`.
+    struct WatchRule
+    {
+        enum class Match : uint8_t
+        {
+            Title,
+            Class,
+            Process
+        };
+
+        Match match = Match::Title;
+        std::string text;
+    };
+
+    inline const char* WatchMatchName(WatchRule::Match match)
+    {
+        switch (match)
+        {
+        case WatchRule::Match::Title:
+            return "Title";
+        case WatchRule::Match::Class:
+            return "Class";
+        default:
+            return "Process";
+        }
+    }
+
+    struct WatchedWindow
+    {
+        HWND handle = nullptr;
+        // Pinned by hand; otherwise added by a rule and dropped once no rule matches it.
+        bool pinned = false;
+        bool matched = false;
+        // False once the provider reported the window gone.
+        bool alive = true;
+        WatchSample current;
+        std::string titleUtf8;
+        // Oldest first, at most WatchList::kHistoryLimit.
+        std::vector<WatchChange> changes;
+    };
+
+    // A few windows polled far more often than the full snapshot is taken (kPollInterval, 20 Hz). A poll
+    // re-reads only the title, bounds and styles of the watched handles and records each field that
+    // changed, so its cost grows with the watch list, never with the desktop. Rules are matched against
+    // each new snapshot, which is the only time the whole desktop is looked at. Between polls the main
+    // loop sleeps; a frame is only requested when a poll saw a change.
+    class WatchList
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        static constexpr std::chrono::milliseconds kPollInterval{50};
+        static constexpr size_t kHistoryLimit = 512;
+        // Rules are meant to pick out a handful of windows; a rule as broad as "e" stops adding at this many.
+        static constexpr size_t kRuleLimit = 64;
+
+        struct PollStats
+        {
+            size_t windows = 0;
+            size_t changes = 0;
+            double microseconds = 0.0;
+        };
+
+        void SetProvider(WatchProvider provider)
+        {
+            mProvider = std::move(provider);
+        }
+
+        bool HasProvider() const
+        {
+            return static_cast<bool>(mProvider);
+        }
+
+        void Pin(HWND handle)
+        {
+            WatchedWindow* window = Find(handle);
+            if (window == nullptr)
+            {
+                window = &Add(handle);
+            }
+            window->pinned = true;
+        }
+
+        void Unpin(HWND handle)
+        {
+            WatchedWindow* window = Find(handle);
+            if (window != nullptr)
+            {
+                window->pinned = false;
+                DropUnwatched();
+            }
+        }
+
+        bool IsPinned(HWND handle) const
+        {
+            const auto it = std::find_if(mWindows.begin(), mWindows.end(), [handle](const WatchedWindow& window) { return window.handle == handle; });
+            return it != mWindows.end() && it->pinned;
+        }
+
+        void AddRule(WatchRule rule)
+        {
+            mRules.push_back(std::move(rule));
+            mGeneration = 0;
+        }
+
+        void RemoveRule(size_t rule)
+        {
+            mRules.erase(mRules.begin() + static_cast<std::ptrdiff_t>(rule));
+            mGeneration = 0;
+        }
+
+        const std::vector<WatchRule>& Rules() const
+        {
+            return mRules;
+        }
+
+        // Matches the rules against a new snapshot: windows that now match are added, rule-added
+        // windows that no longer match (or are gone) are dropped along with their history.
+        void Sync(const InspectorSnapshot& snapshot)
+        {
+            if (snapshot.generation == mGeneration || (mRules.empty() && !mHadRules))
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            mHadRules = !mRules.empty();
+            for (WatchedWindow& window : mWindows)
+            {
+                window.matched = false;
+            }
+            for (const WatchRule& rule : mRules)
+            {
+                size_t added = 0;
+                for (const auto& entry : snapshot.processes)
+                {
+                    for (const WindowInfo& info : entry.windows)
+                    {
+                        if (added < kRuleLimit && Matches(rule, entry, info))
+                        {
+                            WatchedWindow* window = Find(info.handle);
+                            if (window == nullptr)
+                            {
+                                window = &Add(info.handle);
+                            }
+                            window->matched = true;
+                            ++added;
+                        }
+                    }
+                }
+            }
+            DropUnwatched();
+        }
+
+        // Polls every watched window once kPollInterval has passed since the last poll. Returns true when
+        // a field changed or a window went away.
+        bool Poll(Clock::time_point now)
+        {
+            if (mWindows.empty() || !mProvider || now < mNextPoll)
+            {
+                return false;
+            }
+            mNextPoll = now + kPollInterval;
+            const auto start = Clock::now();
+            mLastPoll = PollStats{};
+            for (WatchedWindow& window : mWindows)
+            {
+                if (!window.alive)
+                {
+                    continue;
+                }
+                ++mLastPoll.windows;
+                if (!mProvider(window.handle, mScratch))
+                {
+                    window.alive = false;
+                    ++mLastPoll.changes;
+                    continue;
+                }
+                mLastPoll.changes += Record(window, now);
+            }
+            mLastPoll.microseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            return mLastPoll.changes != 0;
+        }
+
+        // How long the main loop may sleep before the next poll is due, in milliseconds (0xFFFFFFFF while
+        // there is nothing to poll).
+        uint32_t WaitTimeoutMs(Clock::time_point now) const
+        {
+            if (mWindows.empty() || !mProvider)
+            {
+                return 0xFFFFFFFFu;
+            }
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(mNextPoll - now).count();
+            return static_cast<uint32_t>(std::clamp<long long>(remaining, 0, kPollInterval.count()));
+        }
+
+        const std::vector<WatchedWindow>& Windows() const
+        {
+            return mWindows;
+        }
+
+        const PollStats& LastPoll() const
+        {
+            return mLastPoll;
+        }
+
+        void ClearHistory()
+        {
+            for (WatchedWindow& window : mWindows)
+            {
+                window.changes.clear();
+            }
+        }
+
+    private:
+        static bool Matches(const WatchRule& rule, const ProcessWindows& entry, const WindowInfo& window)
+        {
+            if (rule.text.empty())
+            {
+                return false;
+            }
+            const std::string& text = rule.match == WatchRule::Match::Title ? window.titleUtf8
+                                      : rule.match == WatchRule::Match::Class ? window.classNameUtf8
+                                                                              : entry.process.nameUtf8;
+            return TextSearch::FindCaseInsensitive(text.data(), text.size(), rule.text.data(), rule.text.size()) != nullptr;
+        }
+
+        WatchedWindow* Find(HWND handle)
+        {
+            const auto it = std::find_if(mWindows.begin(), mWindows.end(), [handle](const WatchedWindow& window) { return window.handle == handle; });
+            return it != mWindows.end() ? &*it : nullptr;
+        }
+
+        // Sampled right away, so the first poll only records real changes.
+        WatchedWindow& Add(HWND handle)
+        {
+            WatchedWindow& window = mWindows.emplace_back();
+            window.handle = handle;
+            window.alive = mProvider && mProvider(handle, window.current);
+            window.titleUtf8 = ToUtf8(window.current.title);
+            return window;
+        }
+
+        void DropUnwatched()
+        {
+            mWindows.erase(std::remove_if(mWindows.begin(), mWindows.end(),
+                                          [](const WatchedWindow& window) { return !window.pinned && (!window.matched || !window.alive); }),
+                           mWindows.end());
+        }
+
+        // Compares mScratch with the window's last sample and records what changed. The title buffer is
+        // swapped rather than copied, so an unchanged poll allocates nothing.
+        size_t Record(WatchedWindow& window, Clock::time_point now)
+        {
+            WatchSample& current = window.current;
+            size_t changed = 0;
+            char text[96];
+            if (mScratch.title != current.title)
+            {
+                current.title.swap(mScratch.title);
+                window.titleUtf8 = ToUtf8(current.title);
+                Append(window, WatchChange{now, WatchField::Title, window.titleUtf8});
+                ++changed;
+            }
+            const RECT& bounds = mScratch.bounds;
+            if (bounds.left != current.bounds.left || bounds.top != current.bounds.top || bounds.right != current.bounds.right ||
+                bounds.bottom != current.bounds.bottom)
+            {
+                current.bounds = bounds;
+                std::snprintf(text, sizeof(text), "(%ld,%ld)-(%ld,%ld) [%ldx%ld]", static_cast<long>(bounds.left), static_cast<long>(bounds.top),
+                              static_cast<long>(bounds.right), static_cast<long>(bounds.bottom), static_cast<long>(bounds.right - bounds.left),
+                              static_cast<long>(bounds.bottom - bounds.top));
+                Append(window, WatchChange{now, WatchField::Bounds, text});
+                ++changed;
+            }
+            if (mScratch.style != current.style || mScratch.exStyle != current.exStyle)
+            {
+                current.style = mScratch.style;
+                current.exStyle = mScratch.exStyle;
+                std::snprintf(text, sizeof(text), "0x%08llX / 0x%08llX", static_cast<unsigned long long>(current.style),
+                              static_cast<unsigned long long>(current.exStyle));
+                Append(window, WatchChange{now, WatchField::Styles, text});
+                ++changed;
+            }
+            return changed;
+        }
+
+        static void Append(WatchedWindow& window, WatchChange change)
+        {
+            if (window.changes.size() >= kHistoryLimit)
+            {
+                // Drop the oldest quarter at once rather than shifting the history on every change.
+                window.changes.erase(window.changes.begin(), window.changes.begin() + kHistoryLimit / 4);
+            }
+            window.changes.push_back(std::move(change));
+        }
+
+        WatchProvider mProvider;
+        std::vector<WatchedWindow> mWindows;
+        std::vector<WatchRule> mRules;
+        bool mHadRules = false;
+        uint64_t mGeneration = 0;
+        Clock::time_point mNextPoll{};
+        WatchSample mScratch;
+        PollStats mLastPoll;
+    };
+}
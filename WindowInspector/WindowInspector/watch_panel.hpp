@@ -0,0 +1,210 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+
+#include "imgui/imgui.h"
+#include "watch_list.hpp"
+
+namespace Inspector
+{
+    // Window over a WatchList: pin the selected window or add match rules, and see each watched window's
+    // current title, bounds and styles with its change history, newest first.
+    class WatchPanel
+    {
+    public:
+        bool visible = false;
+
+        // Clicking a watched window selects it in `selected`.
+        void Render(WatchList& list, HWND& selected)
+        {
+            if (!visible)
+            {
+                return;
+            }
+
+            ImGui::SetNextWindowSize(ImVec2(640.0f, 520.0f), ImGuiCond_FirstUseEver);
+            if (!ImGui::Begin("Watch list", &visible, ImGuiWindowFlags_NoSavedSettings))
+            {
+                ImGui::End();
+                return;
+            }
+
+            if (!list.HasProvider())
+            {
+                ImGui::TextDisabled("Polling is not available in this build.");
+            }
+
+            ImGui::BeginDisabled(selected == nullptr || list.IsPinned(selected));
+            if (ImGui::Button("Pin selected"))
+            {
+                list.Pin(selected);
+            }
+            ImGui::EndDisabled();
+
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(100.0f);
+            if (ImGui::BeginCombo("##RuleMatch", WatchMatchName(mRuleMatch)))
+            {
+                for (const WatchRule::Match match : {WatchRule::Match::Title, WatchRule::Match::Class, WatchRule::Match::Process})
+                {
+                    if (ImGui::Selectable(WatchMatchName(match), match == mRuleMatch))
+                    {
+                        mRuleMatch = match;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(220.0f);
+            const bool submitted = ImGui::InputTextWithHint("##RuleText", "contains...", mRuleText.data(), mRuleText.size(), ImGuiInputTextFlags_EnterReturnsTrue);
+            ImGui::SameLine();
+            if ((ImGui::Button("Add rule") || submitted) && mRuleText[0] != '\0')
+            {
+                list.AddRule(WatchRule{mRuleMatch, mRuleText.data()});
+                mRuleText.fill('\0');
+            }
+            if (ImGui::IsItemHovered())
+            {
+                ImGui::SetTooltip("Watch every window whose %s contains the text (up to %zu per rule), matched on each refresh.",
+                                  mRuleMatch == WatchRule::Match::Process ? "process name" : mRuleMatch == WatchRule::Match::Class ? "class" : "title",
+                                  WatchList::kRuleLimit);
+            }
+
+            size_t removedRule = list.Rules().size();
+            for (size_t rule = 0; rule < list.Rules().size(); ++rule)
+            {
+                ImGui::PushID(static_cast<int>(rule));
+                const WatchRule& watchRule = list.Rules()[rule];
+                ImGui::BulletText("%s contains \"%s\"", WatchMatchName(watchRule.match), watchRule.text.c_str());
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Remove"))
+                {
+                    removedRule = rule;
+                }
+                ImGui::PopID();
+            }
+            if (removedRule < list.Rules().size())
+            {
+                list.RemoveRule(removedRule);
+            }
+
+            const WatchList::PollStats& poll = list.LastPoll();
+            ImGui::Text("Watching %zu windows | last poll %zu windows in %.1f us, every %lld ms", list.Windows().size(), poll.windows,
+                        poll.microseconds, static_cast<long long>(WatchList::kPollInterval.count()));
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Clear history"))
+            {
+                list.ClearHistory();
+            }
+            ImGui::Separator();
+
+            if (ImGui::BeginChild("##watched"))
+            {
+                HWND unpin = nullptr;
+                const auto now = WatchList::Clock::now();
+                for (const WatchedWindow& window : list.Windows())
+                {
+                    ImGui::PushID(window.handle);
+                    if (RenderWatchedWindow(window, now, selected))
+                    {
+                        unpin = window.handle;
+                    }
+                    ImGui::PopID();
+                }
+                if (list.Windows().empty())
+                {
+                    ImGui::TextDisabled("Pin a window or add a rule to watch windows between refreshes.");
+                }
+                if (unpin != nullptr)
+                {
+                    list.Unpin(unpin);
+                }
+            }
+            ImGui::EndChild();
+            ImGui::End();
+        }
+
+    private:
+        static constexpr float kHistoryHeight = 150.0f;
+
+        // Returns true when the window's Unpin button was pressed.
+        bool RenderWatchedWindow(const WatchedWindow& window, WatchList::Clock::time_point now, HWND& selected)
+        {
+            const unsigned long long handle = static_cast<unsigned long long>(reinterpret_cast<std::uintptr_t>(window.handle));
+            if (!window.alive)
+            {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+            }
+            const bool open = ImGui::TreeNodeEx("##node", ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_AllowOverlap, "0x%llX  %s%s", handle,
+                                                window.titleUtf8.c_str(), window.alive ? "" : "  (gone)");
+            if (!window.alive)
+            {
+                ImGui::PopStyleColor();
+            }
+            ImGui::SameLine();
+            ImGui::TextDisabled("%zu changes", window.changes.size());
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Select"))
+            {
+                selected = window.handle;
+            }
+            bool unpin = false;
+            if (window.pinned)
+            {
+                ImGui::SameLine();
+                unpin = ImGui::SmallButton("Unpin");
+            }
+            else
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(rule)");
+            }
+            if (!open)
+            {
+                return unpin;
+            }
+
+            const WatchSample& current = window.current;
+            ImGui::TextDisabled("(%ld,%ld)-(%ld,%ld)  style 0x%08llX  ex 0x%08llX", static_cast<long>(current.bounds.left),
+                                static_cast<long>(current.bounds.top), static_cast<long>(current.bounds.right), static_cast<long>(current.bounds.bottom),
+                                static_cast<unsigned long long>(current.style), static_cast<unsigned long long>(current.exStyle));
+            if (!window.changes.empty())
+            {
+                const float height = std::min(kHistoryHeight, ImGui::GetTextLineHeightWithSpacing() * (static_cast<float>(window.changes.size()) + 0.5f));
+                constexpr ImGuiTableFlags tableFlags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY |
+                                                       ImGuiTableFlags_SizingStretchProp;
+                if (ImGui::BeginTable("##changes", 3, tableFlags, ImVec2(0.0f, height)))
+                {
+                    ImGui::TableSetupColumn("Ago", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                    ImGui::TableSetupColumn("Field", ImGuiTableColumnFlags_WidthFixed, 60.0f);
+                    ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthStretch);
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(window.changes.size()));
+                    while (clipper.Step())
+                    {
+                        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                        {
+                            const WatchChange& change = window.changes[window.changes.size() - 1 - static_cast<size_t>(row)];
+                            ImGui::TableNextRow();
+                            ImGui::TableSetColumnIndex(0);
+                            ImGui::TextDisabled("%.1f s", std::chrono::duration<double>(now - change.time).count());
+                            ImGui::TableSetColumnIndex(1);
+                            ImGui::TextUnformatted(WatchFieldName(change.field));
+                            ImGui::TableSetColumnIndex(2);
+                            ImGui::TextUnformatted(change.value.c_str());
+                        }
+                    }
+                    ImGui::EndTable();
+                }
+            }
+            ImGui::TreePop();
+            return unpin;
+        }
+
+        std::array<char, 128> mRuleText{};
+        WatchRule::Match mRuleMatch = WatchRule::Match::Title;
+    };
+}
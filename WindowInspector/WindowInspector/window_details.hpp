@@ -0,0 +1,240 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+#include "window_styles.hpp"
+
+namespace Inspector
+{
+    struct WindowProperty
+    {
+        std::string name;
+        uintptr_t value = 0;
+    };
+
+    // Properties too expensive (or too rarely needed) for the snapshot, queried for one window on demand.
+    struct WindowDetails
+    {
+        HWND handle = nullptr;
+        // False when the window was destroyed before the query ran.
+        bool alive = false;
+        HWND owner = nullptr;
+        HWND parent = nullptr;
+        UINT dpi = 0;
+        std::string monitorName;
+        RECT monitorBounds{0, 0, 0, 0};
+        RECT workArea{0, 0, 0, 0};
+        bool primaryMonitor = false;
+        std::vector<WindowProperty> properties;
+        uint32_t classStyle = 0;
+        // classStyle decoded by the cache's worker, so the detail pane draws it without formatting per frame.
+        std::string classStyleNames;
+        uint16_t classAtom = 0;
+        int classExtraBytes = 0;
+        int windowExtraBytes = 0;
+        uintptr_t classModule = 0;
+        std::string modulePath;
+        double queryMs = 0.0;
+    };
+
+    // Where details come from; main.cpp queries Win32. Called on the cache's worker thread.
+    using WindowDetailsProvider = std::function<void(HWND window, WindowDetails& details)>;
+
+    // Details for a handful of recently selected windows. Only the window the UI asks for is fetched, on a
+    // single worker thread so a slow query (EnumProps on a hung process, an access-denied OpenProcess)
+    // never stalls a frame; when the selection moves on before the worker gets to it, only the latest
+    // request is served. An entry stays valid until a snapshot shows its window changed or gone.
+    class WindowDetailsCache
+    {
+    public:
+        static constexpr size_t kCapacity = 32;
+
+        ~WindowDetailsCache()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mWake.notify_all();
+            if (mWorker.joinable())
+            {
+                mWorker.join();
+            }
+        }
+
+        void SetProvider(WindowDetailsProvider provider)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mProvider = std::move(provider);
+        }
+
+        bool HasProvider() const
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return static_cast<bool>(mProvider);
+        }
+
+        // Drops entries whose window the new snapshot no longer lists or lists with different fields.
+        void Sync(const InspectorSnapshot& snapshot, const SpatialIndex& index)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                                          [&](const Entry& entry) { return FingerprintOf(snapshot, index, entry.details.handle) != entry.fingerprint; }),
+                           mEntries.end());
+        }
+
+        // Cached details for `window`, or null while they are being fetched. `fingerprint` is the
+        // window's WindowFingerprint in the current snapshot.
+        const WindowDetails* Request(HWND window, uint64_t fingerprint)
+        {
+            CollectCompleted();
+            ++mClock;
+            for (Entry& entry : mEntries)
+            {
+                if (entry.details.handle == window && entry.fingerprint == fingerprint)
+                {
+                    entry.lastUse = mClock;
+                    return &entry.details;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mProvider || (mInFlight == window && mInFlightFingerprint == fingerprint))
+            {
+                return nullptr;
+            }
+            if (mRequested != window || mRequestedFingerprint != fingerprint)
+            {
+                mRequested = window;
+                mRequestedFingerprint = fingerprint;
+                if (!mWorker.joinable())
+                {
+                    mWorker = std::thread([this]() { WorkerLoop(); });
+                }
+                mWake.notify_one();
+            }
+            return nullptr;
+        }
+
+        // True while a query is waiting, running or not yet picked up by Request, so the UI keeps drawing
+        // until the details land.
+        bool Pending() const
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mRequested != nullptr || mInFlight != nullptr || !mCompleted.empty();
+        }
+
+        // Forgets `window` so the next Request queries it again.
+        void Invalidate(HWND window)
+        {
+            mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(), [window](const Entry& entry) { return entry.details.handle == window; }),
+                           mEntries.end());
+        }
+
+        size_t Size() const
+        {
+            return mEntries.size();
+        }
+
+    private:
+        struct Entry
+        {
+            WindowDetails details;
+            uint64_t fingerprint = 0;
+            uint64_t lastUse = 0;
+        };
+
+        static uint64_t FingerprintOf(const InspectorSnapshot& snapshot, const SpatialIndex& index, HWND window)
+        {
+            const uint32_t slot = index.SlotOf(window);
+            if (slot == SpatialIndex::kNoEntry)
+            {
+                return 0;
+            }
+            const WindowRef& ref = index.EntryAt(slot).ref;
+            return WindowFingerprint(snapshot.processes[ref.process].windows[ref.window]);
+        }
+
+        void CollectCompleted()
+        {
+            std::vector<Entry> completed;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                completed.swap(mCompleted);
+            }
+            for (Entry& entry : completed)
+            {
+                Invalidate(entry.details.handle);
+                if (mEntries.size() >= kCapacity)
+                {
+                    // Evict the least recently shown window.
+                    mEntries.erase(std::min_element(mEntries.begin(), mEntries.end(),
+                                                    [](const Entry& a, const Entry& b) { return a.lastUse < b.lastUse; }));
+                }
+                entry.lastUse = mClock;
+                mEntries.push_back(std::move(entry));
+            }
+        }
+
+        void WorkerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            for (;;)
+            {
+                mWake.wait(lock, [this]() { return mStopping || mRequested != nullptr; });
+                if (mStopping)
+                {
+                    return;
+                }
+
+                Entry entry;
+                entry.details.handle = mRequested;
+                entry.fingerprint = mRequestedFingerprint;
+                mInFlight = mRequested;
+                mInFlightFingerprint = mRequestedFingerprint;
+                mRequested = nullptr;
+                const WindowDetailsProvider provider = mProvider;
+                lock.unlock();
+
+                const auto start = std::chrono::steady_clock::now();
+                provider(entry.details.handle, entry.details);
+                entry.details.classStyleNames = DescribeClassStyle(entry.details.classStyle);
+                entry.details.queryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                lock.lock();
+                mInFlight = nullptr;
+                mCompleted.push_back(std::move(entry));
+            }
+        }
+
+        // UI thread only.
+        std::vector<Entry> mEntries;
+        uint64_t mGeneration = 0;
+        uint64_t mClock = 0;
+
+        // Shared with the worker, guarded by mMutex.
+        mutable std::mutex mMutex;
+        std::condition_variable mWake;
+        WindowDetailsProvider mProvider;
+        HWND mRequested = nullptr;
+        uint64_t mRequestedFingerprint = 0;
+        HWND mInFlight = nullptr;
+        uint64_t mInFlightFingerprint = 0;
+        std::vector<Entry> mCompleted;
+        bool mStopping = false;
+        std::thread mWorker;
+    };
+}
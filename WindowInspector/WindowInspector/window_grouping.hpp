@@ -0,0 +1,423 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <utility>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+
+namespace Inspector
+{
+    enum class GroupingMode : uint8_t
+    {
+        Process,
+        Class,
+        Thread,
+        Monitor,
+        Visibility,
+        Owner
+    };
+
+    constexpr size_t kGroupingModeCount = 6;
+
+    inline const char* GroupingModeName(GroupingMode mode)
+    {
+        switch (mode)
+        {
+        case GroupingMode::Process:
+            return "Process";
+        case GroupingMode::Class:
+            return "Class";
+        case GroupingMode::Thread:
+            return "Thread";
+        case GroupingMode::Monitor:
+            return "Monitor";
+        case GroupingMode::Visibility:
+            return "Visibility";
+        default:
+            return "Owner";
+        }
+    }
+
+    // The windows of one snapshot arranged into groups without moving them: `order` is a permutation of
+    // WindowRefs in which every group is a contiguous run [groupOffsets[g], groupOffsets[g + 1]), and
+    // `positions` maps a window back to its place in `order`. Windows are numbered flat, process by
+    // process, starting at windowBase[process].
+    struct WindowGrouping
+    {
+        GroupingMode mode = GroupingMode::Process;
+        uint64_t generation = 0;
+        std::vector<WindowRef> order;
+        std::vector<uint32_t> groupOffsets;
+        // Identifies a group across snapshots (pid, class hash, thread id, monitor, visibility, owner).
+        std::vector<uint64_t> groupKeys;
+        std::vector<uint32_t> positions;
+        std::vector<uint32_t> windowBase;
+
+        size_t GroupCount() const
+        {
+            return groupKeys.size();
+        }
+
+        uint32_t GroupSize(uint32_t group) const
+        {
+            return groupOffsets[group + 1] - groupOffsets[group];
+        }
+
+        uint32_t PositionOf(const WindowRef& ref) const
+        {
+            return positions[windowBase[ref.process] + ref.window];
+        }
+
+        uint32_t GroupOf(uint32_t position) const
+        {
+            // Groups can be empty (processes without windows), so take the last group starting at or before `position`.
+            const auto it = std::upper_bound(groupOffsets.begin(), groupOffsets.end() - 1, position);
+            return static_cast<uint32_t>(it - groupOffsets.begin()) - 1;
+        }
+    };
+
+    // Per-window fields the non-process groupings sort by, copied out of the snapshot so a worker can
+    // build them while the UI thread replaces the snapshot.
+    struct GroupingKey
+    {
+        uint64_t classHash = 0;
+        HWND rootOwner = nullptr;
+        RECT bounds{0, 0, 0, 0};
+        DWORD threadId = 0;
+        bool visible = false;
+    };
+
+    struct GroupingInput
+    {
+        uint64_t generation = 0;
+        std::vector<GroupingKey> keys;
+        std::vector<uint32_t> windowBase;
+        std::vector<RECT> monitors;
+    };
+
+    inline void ExtractGroupingInput(const InspectorSnapshot& snapshot, GroupingInput& input)
+    {
+        input.generation = snapshot.generation;
+        input.monitors = snapshot.monitors;
+        input.keys.clear();
+        input.windowBase.clear();
+        input.windowBase.reserve(snapshot.processes.size() + 1);
+        for (const auto& entry : snapshot.processes)
+        {
+            input.windowBase.push_back(static_cast<uint32_t>(input.keys.size()));
+            for (const WindowInfo& window : entry.windows)
+            {
+                input.keys.push_back(GroupingKey{window.hashes.className, window.rootOwner, window.bounds, window.threadId, window.visible});
+            }
+        }
+        input.windowBase.push_back(static_cast<uint32_t>(input.keys.size()));
+    }
+
+    // Monitor with the largest share of `bounds`, or monitors.size() for off-screen and zero-sized windows.
+    inline uint64_t MonitorKey(const RECT& bounds, const std::vector<RECT>& monitors)
+    {
+        uint64_t best = monitors.size();
+        long long bestArea = 0;
+        for (size_t monitor = 0; monitor < monitors.size(); ++monitor)
+        {
+            const RECT& area = monitors[monitor];
+            const long long width = std::min(bounds.right, area.right) - std::max(bounds.left, area.left);
+            const long long height = std::min(bounds.bottom, area.bottom) - std::max(bounds.top, area.top);
+            if (width > 0 && height > 0 && width * height > bestArea)
+            {
+                bestArea = width * height;
+                best = monitor;
+            }
+        }
+        return best;
+    }
+
+    // One group per process in snapshot order, empty processes included; `order` is the identity.
+    inline void BuildProcessGrouping(const InspectorSnapshot& snapshot, WindowGrouping& grouping)
+    {
+        grouping.mode = GroupingMode::Process;
+        grouping.generation = snapshot.generation;
+        grouping.order.clear();
+        grouping.groupOffsets.clear();
+        grouping.groupKeys.clear();
+        grouping.windowBase.clear();
+        for (uint32_t process = 0; process < snapshot.processes.size(); ++process)
+        {
+            grouping.groupOffsets.push_back(static_cast<uint32_t>(grouping.order.size()));
+            grouping.windowBase.push_back(static_cast<uint32_t>(grouping.order.size()));
+            grouping.groupKeys.push_back(snapshot.processes[process].process.pid);
+            for (uint32_t window = 0; window < snapshot.processes[process].windows.size(); ++window)
+            {
+                grouping.order.push_back(WindowRef{process, window});
+            }
+        }
+        grouping.groupOffsets.push_back(static_cast<uint32_t>(grouping.order.size()));
+        grouping.windowBase.push_back(static_cast<uint32_t>(grouping.order.size()));
+        grouping.positions.resize(grouping.order.size());
+        for (uint32_t position = 0; position < grouping.positions.size(); ++position)
+        {
+            grouping.positions[position] = position;
+        }
+    }
+
+    // Sorts windows by the mode's key. Monitor and visibility groups keep their natural order; class,
+    // thread and owner groups are listed largest first. Within a group windows stay in snapshot order.
+    inline void BuildKeyedGrouping(GroupingMode mode, const GroupingInput& input, WindowGrouping& grouping)
+    {
+        const size_t count = input.keys.size();
+        std::vector<std::pair<uint64_t, uint32_t>> sorted(count);
+        for (uint32_t flat = 0; flat < count; ++flat)
+        {
+            const GroupingKey& key = input.keys[flat];
+            uint64_t value = 0;
+            switch (mode)
+            {
+            case GroupingMode::Class:
+                value = key.classHash;
+                break;
+            case GroupingMode::Thread:
+                value = key.threadId;
+                break;
+            case GroupingMode::Monitor:
+                value = MonitorKey(key.bounds, input.monitors);
+                break;
+            case GroupingMode::Visibility:
+                value = key.visible ? 0 : 1;
+                break;
+            default:
+                value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.rootOwner));
+                break;
+            }
+            sorted[flat] = std::make_pair(value, flat);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        // Runs of equal keys, reordered by size where the key itself means nothing to the reader.
+        std::vector<std::pair<uint32_t, uint32_t>> runs;
+        for (uint32_t begin = 0; begin < count;)
+        {
+            uint32_t end = begin + 1;
+            while (end < count && sorted[end].first == sorted[begin].first)
+            {
+                ++end;
+            }
+            runs.emplace_back(begin, end);
+            begin = end;
+        }
+        if (mode != GroupingMode::Monitor && mode != GroupingMode::Visibility)
+        {
+            std::stable_sort(runs.begin(), runs.end(), [](const auto& a, const auto& b) { return a.second - a.first > b.second - b.first; });
+        }
+
+        // Flat index -> WindowRef through the per-process bases.
+        std::vector<uint32_t> processOf(count);
+        for (uint32_t process = 0; process + 1 < input.windowBase.size(); ++process)
+        {
+            std::fill(processOf.begin() + input.windowBase[process], processOf.begin() + input.windowBase[process + 1], process);
+        }
+
+        grouping.mode = mode;
+        grouping.generation = input.generation;
+        grouping.windowBase = input.windowBase;
+        grouping.order.resize(count);
+        grouping.positions.resize(count);
+        grouping.groupOffsets.clear();
+        grouping.groupKeys.clear();
+        uint32_t position = 0;
+        for (const auto& run : runs)
+        {
+            grouping.groupOffsets.push_back(position);
+            grouping.groupKeys.push_back(sorted[run.first].first);
+            for (uint32_t index = run.first; index < run.second; ++index, ++position)
+            {
+                const uint32_t flat = sorted[index].second;
+                const uint32_t process = processOf[flat];
+                grouping.order[position] = WindowRef{process, flat - input.windowBase[process]};
+                grouping.positions[flat] = position;
+            }
+        }
+        grouping.groupOffsets.push_back(position);
+    }
+
+    // Header text of `group`; process groups use ProcessWindows::headerLabel instead.
+    inline void FormatGroupLabel(const InspectorSnapshot& snapshot, const SpatialIndex& index, const WindowGrouping& grouping, uint32_t group,
+                                 char* buffer, size_t size)
+    {
+        const uint64_t key = grouping.groupKeys[group];
+        const WindowRef& first = grouping.order[grouping.groupOffsets[group]];
+        const ProcessWindows& process = snapshot.processes[first.process];
+        const WindowInfo& window = process.windows[first.window];
+        switch (grouping.mode)
+        {
+        case GroupingMode::Class:
+            std::snprintf(buffer, size, "%s", window.classNameUtf8.c_str());
+            break;
+        case GroupingMode::Thread:
+            std::snprintf(buffer, size, "Thread %lu  %s", window.threadId, process.headerLabel.c_str());
+            break;
+        case GroupingMode::Monitor:
+            if (key < snapshot.monitors.size())
+            {
+                const RECT& monitor = snapshot.monitors[key];
+                std::snprintf(buffer, size, "Monitor %llu  (%ld,%ld)-(%ld,%ld)", static_cast<unsigned long long>(key + 1), monitor.left, monitor.top,
+                              monitor.right, monitor.bottom);
+            }
+            else
+            {
+                std::snprintf(buffer, size, "Off-screen or zero-sized");
+            }
+            break;
+        case GroupingMode::Visibility:
+            std::snprintf(buffer, size, "%s", key == 0 ? "Visible" : "Hidden");
+            break;
+        case GroupingMode::Owner:
+            if (key == 0)
+            {
+                std::snprintf(buffer, size, "No owner");
+            }
+            else
+            {
+                const uint32_t slot = index.SlotOf(window.rootOwner);
+                const char* title = "";
+                if (slot != SpatialIndex::kNoEntry)
+                {
+                    const WindowRef& owner = index.EntryAt(slot).ref;
+                    title = snapshot.processes[owner.process].windows[owner.window].titleUtf8.c_str();
+                }
+                std::snprintf(buffer, size, "Owned by 0x%llX  %s", static_cast<unsigned long long>(key), title);
+            }
+            break;
+        default:
+            std::snprintf(buffer, size, "%s", process.headerLabel.c_str());
+            break;
+        }
+    }
+
+    // Every grouping of the current snapshot. The process grouping is built on the calling thread as soon
+    // as a snapshot arrives; the others are built together from a GroupingInput on a worker thread (or
+    // inline when `async` is off), so switching modes afterwards only swaps which index the list reads.
+    class WindowGroupings
+    {
+    public:
+        bool async = true;
+
+        ~WindowGroupings()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStopping = true;
+            }
+            mWake.notify_all();
+            if (mWorker.joinable())
+            {
+                mWorker.join();
+            }
+        }
+
+        void Sync(const InspectorSnapshot& snapshot)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            BuildProcessGrouping(snapshot, mGroupings[0]);
+
+            GroupingInput input;
+            ExtractGroupingInput(snapshot, input);
+            if (!async)
+            {
+                for (size_t mode = 1; mode < kGroupingModeCount; ++mode)
+                {
+                    BuildKeyedGrouping(static_cast<GroupingMode>(mode), input, mGroupings[mode]);
+                }
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRequest = std::move(input);
+            mHasRequest = true;
+            if (!mWorker.joinable())
+            {
+                mWorker = std::thread([this]() { WorkerLoop(); });
+            }
+            mWake.notify_one();
+        }
+
+        // Grouping of the current snapshot, or null while the worker is still building it.
+        const WindowGrouping* Get(GroupingMode mode)
+        {
+            CollectCompleted();
+            const WindowGrouping& grouping = mGroupings[static_cast<size_t>(mode)];
+            return grouping.generation == mGeneration && mGeneration != 0 ? &grouping : nullptr;
+        }
+
+        // True until every mode is built for the current snapshot.
+        bool Pending()
+        {
+            CollectCompleted();
+            return std::any_of(mGroupings.begin(), mGroupings.end(), [this](const WindowGrouping& grouping) { return grouping.generation != mGeneration; });
+        }
+
+    private:
+        void CollectCompleted()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mHasCompleted && mCompleted[1].generation == mGeneration)
+            {
+                for (size_t mode = 1; mode < kGroupingModeCount; ++mode)
+                {
+                    std::swap(mGroupings[mode], mCompleted[mode]);
+                }
+            }
+            mHasCompleted = false;
+        }
+
+        void WorkerLoop()
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            std::array<WindowGrouping, kGroupingModeCount> built;
+            for (;;)
+            {
+                mWake.wait(lock, [this]() { return mStopping || mHasRequest; });
+                if (mStopping)
+                {
+                    return;
+                }
+                GroupingInput input = std::move(mRequest);
+                mHasRequest = false;
+                lock.unlock();
+
+                for (size_t mode = 1; mode < kGroupingModeCount; ++mode)
+                {
+                    BuildKeyedGrouping(static_cast<GroupingMode>(mode), input, built[mode]);
+                }
+
+                lock.lock();
+                std::swap(built, mCompleted);
+                mHasCompleted = true;
+            }
+        }
+
+        // UI thread only.
+        std::array<WindowGrouping, kGroupingModeCount> mGroupings;
+        uint64_t mGeneration = 0;
+
+        // Shared with the worker, guarded by mMutex.
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        GroupingInput mRequest;
+        bool mHasRequest = false;
+        std::array<WindowGrouping, kGroupingModeCount> mCompleted;
+        bool mHasCompleted = false;
+        bool mStopping = false;
+        std::thread mWorker;
+    };
+}
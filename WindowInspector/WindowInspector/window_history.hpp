@@ -0,0 +1,288 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "snapshot.hpp"
+
+namespace Inspector
+{
+    enum class LifetimeEvent : uint8_t
+    {
+        Title,
+        Visibility,
+        Bounds
+    };
+
+    struct LifetimeMarker
+    {
+        double time = 0.0;
+        LifetimeEvent event = LifetimeEvent::Title;
+    };
+
+    // One continuous stretch during which a window (or, with a null handle, a process) was listed.
+    struct WindowLifetime
+    {
+        static constexpr double kOpen = std::numeric_limits<double>::infinity();
+
+        HWND handle = nullptr;
+        DWORD pid = 0;
+        double start = 0.0;
+        // First record the window was missing from, or kOpen while it is still listed.
+        double end = kOpen;
+        // Latest title (process name for process lifetimes) and class.
+        std::string titleUtf8;
+        std::string classNameUtf8;
+        // Changes after `start`, in time order.
+        std::vector<LifetimeMarker> markers;
+        WindowHashes hashes;
+        bool visible = false;
+
+        bool IsProcess() const
+        {
+            return handle == nullptr;
+        }
+    };
+
+    // Window and process lifetimes across every snapshot recorded so far (the timeline captures one a
+    // second). A record only walks the new snapshot and the lifetimes still open; change markers come from
+    // the per-window field hashes. Lifetimes follow IdentityRegistry ids, so a recycled pid or handle
+    // starts a new lifetime, and the open lifetime of an id is found by indexing, not hashing. Lifetimes
+    // are appended in start order, which makes the array itself the key order of an implicit interval tree:
+    // each subtree [lo, hi) keeps the largest end at its middle element, so QueryRange visits only subtrees
+    // that can overlap the range.
+    class WindowHistory
+    {
+    public:
+        // Adds `snapshot`, captured at `time` (seconds, non-decreasing). Snapshots already recorded are ignored.
+        void Record(const InspectorSnapshot& snapshot, double time)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            mGeneration = snapshot.generation;
+            if (mLifetimes.empty())
+            {
+                mFirstTime = time;
+            }
+            mLastTime = time;
+            ++mRecordCount;
+
+            for (const auto& entry : snapshot.processes)
+            {
+                Touch(mOpenProcesses, entry.process.id, nullptr, entry.process.pid, time, entry.process.nameUtf8, nullptr);
+                for (const WindowInfo& window : entry.windows)
+                {
+                    Touch(mOpenWindows, window.id, window.handle, window.pid, time, window.titleUtf8, &window);
+                }
+            }
+
+            // Anything not listed this time ended between the previous record and this one.
+            Close(mOpenProcesses, time);
+            Close(mOpenWindows, time);
+            mTreeDirty = true;
+        }
+
+        void Clear()
+        {
+            mLifetimes.clear();
+            mLastSeen.clear();
+            mMaxEnd.clear();
+            mOpenProcesses = OpenSet{};
+            mOpenWindows = OpenSet{};
+            mGeneration = 0;
+            mRecordCount = 0;
+            mFirstTime = 0.0;
+            mLastTime = 0.0;
+            mTreeDirty = false;
+        }
+
+        // Indices of the lifetimes overlapping [from, to], in start order.
+        void QueryRange(double from, double to, std::vector<uint32_t>& out)
+        {
+            out.clear();
+            if (mTreeDirty)
+            {
+                mMaxEnd.resize(mLifetimes.size());
+                BuildTree(0, mLifetimes.size());
+                mTreeDirty = false;
+            }
+            Query(0, mLifetimes.size(), from, to, out);
+        }
+
+        const WindowLifetime& LifetimeAt(uint32_t index) const
+        {
+            return mLifetimes[index];
+        }
+
+        size_t LifetimeCount() const
+        {
+            return mLifetimes.size();
+        }
+
+        size_t OpenCount() const
+        {
+            return mOpenProcesses.ids.size() + mOpenWindows.ids.size();
+        }
+
+        size_t RecordCount() const
+        {
+            return mRecordCount;
+        }
+
+        bool Empty() const
+        {
+            return mLifetimes.empty();
+        }
+
+        double FirstTime() const
+        {
+            return mFirstTime;
+        }
+
+        double LastTime() const
+        {
+            return mLastTime;
+        }
+
+    private:
+        static constexpr uint32_t kClosed = 0xFFFFFFFFu;
+
+        // Open lifetimes of one id space (processes or windows).
+        struct OpenSet
+        {
+            // Lifetime index by id, kClosed when the id has none open.
+            std::vector<uint32_t> lifetimeOf;
+            // Ids with an open lifetime.
+            std::vector<uint32_t> ids;
+        };
+
+        // Extends the open lifetime of identity `id`, or starts one. Snapshots that never went through an
+        // IdentityRegistry have nothing to key on and are not recorded.
+        void Touch(OpenSet& open, uint32_t id, HWND handle, DWORD pid, double time, const std::string& title, const WindowInfo* window)
+        {
+            if (id == kNoIdentity)
+            {
+                return;
+            }
+            if (id >= open.lifetimeOf.size())
+            {
+                open.lifetimeOf.resize(static_cast<size_t>(id) + 1, kClosed);
+            }
+            uint32_t& index = open.lifetimeOf[id];
+            if (index == kClosed)
+            {
+                index = static_cast<uint32_t>(mLifetimes.size());
+                open.ids.push_back(id);
+                mLastSeen.push_back(mGeneration);
+                WindowLifetime& lifetime = mLifetimes.emplace_back();
+                lifetime.handle = handle;
+                lifetime.pid = pid;
+                lifetime.start = time;
+                lifetime.titleUtf8 = title;
+                if (window != nullptr)
+                {
+                    lifetime.classNameUtf8 = window->classNameUtf8;
+                    lifetime.hashes = window->hashes;
+                    lifetime.visible = window->visible;
+                }
+                return;
+            }
+            mLastSeen[index] = mGeneration;
+            if (window == nullptr)
+            {
+                return;
+            }
+
+            WindowLifetime& lifetime = mLifetimes[index];
+            if (window->hashes.title != lifetime.hashes.title)
+            {
+                lifetime.markers.push_back(LifetimeMarker{time, LifetimeEvent::Title});
+                lifetime.titleUtf8 = title;
+            }
+            if (window->visible != lifetime.visible)
+            {
+                lifetime.markers.push_back(LifetimeMarker{time, LifetimeEvent::Visibility});
+                lifetime.visible = window->visible;
+            }
+            if (window->hashes.bounds != lifetime.hashes.bounds)
+            {
+                lifetime.markers.push_back(LifetimeMarker{time, LifetimeEvent::Bounds});
+            }
+            lifetime.hashes = window->hashes;
+        }
+
+        // Ends the open lifetimes the current record did not touch.
+        void Close(OpenSet& open, double time)
+        {
+            size_t kept = 0;
+            for (const uint32_t id : open.ids)
+            {
+                const uint32_t index = open.lifetimeOf[id];
+                if (mLastSeen[index] != mGeneration)
+                {
+                    mLifetimes[index].end = time;
+                    open.lifetimeOf[id] = kClosed;
+                }
+                else
+                {
+                    open.ids[kept++] = id;
+                }
+            }
+            open.ids.resize(kept);
+        }
+
+        // Largest end in [lo, hi), stored at the middle element.
+        double BuildTree(size_t lo, size_t hi)
+        {
+            if (lo >= hi)
+            {
+                return -std::numeric_limits<double>::infinity();
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            const double left = BuildTree(lo, mid);
+            const double right = BuildTree(mid + 1, hi);
+            mMaxEnd[mid] = std::max({mLifetimes[mid].end, left, right});
+            return mMaxEnd[mid];
+        }
+
+        void Query(size_t lo, size_t hi, double from, double to, std::vector<uint32_t>& out) const
+        {
+            if (lo >= hi)
+            {
+                return;
+            }
+            const size_t mid = lo + (hi - lo) / 2;
+            if (mMaxEnd[mid] < from)
+            {
+                return;
+            }
+            Query(lo, mid, from, to, out);
+            if (mLifetimes[mid].start > to)
+            {
+                // Everything to the right starts later still.
+                return;
+            }
+            if (mLifetimes[mid].end >= from)
+            {
+                out.push_back(static_cast<uint32_t>(mid));
+            }
+            Query(mid + 1, hi, from, to, out);
+        }
+
+        std::vector<WindowLifetime> mLifetimes;
+        std::vector<double> mMaxEnd;
+        // Generation of the last record that listed each lifetime's process or window.
+        std::vector<uint64_t> mLastSeen;
+        OpenSet mOpenProcesses;
+        OpenSet mOpenWindows;
+        uint64_t mGeneration = 0;
+        size_t mRecordCount = 0;
+        double mFirstTime = 0.0;
+        double mLastTime = 0.0;
+        bool mTreeDirty = false;
+    };
+}
@@ -0,0 +1,332 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
+#include <algorithm>
+
+#include "snapshot.hpp"
+#include "text_search.hpp"
+#include "window_styles.hpp"
+#include "window_grouping.hpp"
+#include "attribute_index.hpp"
+
+namespace Inspector
+{
+    // Flat row model behind the grouped window table: one header row per group of a WindowGrouping that
+    // passes the filters, followed by its windows unless the group is collapsed. Window rows hold their
+    // position in the grouping's order and rows are sorted by (group, position), so the row of any window
+    // is found by binary search from its group's header row (a direct offset when no filter thins the
+    // group out), and the table can be clipped like any other list. Collapsed groups are remembered per
+    // mode by group key (the PID for processes) so they survive a Refresh. Windows removed by the last
+    // refresh can be listed in a group of their own at the top (kRemovedGroup), whose rows index
+    // SnapshotDiff::Removed(). Given an AttributeIndex synced to the snapshot, the style filter is answered
+    // from its bitsets: a selective filter visits only the matching windows, a broad one tests one bit per
+    // window instead of reading its WindowInfo.
+    class GroupedWindowList
+    {
+    public:
+        static constexpr uint32_t kHeaderRow = 0xFFFFFFFFu;
+        static constexpr uint32_t kRemovedGroup = 0xFFFFFFFEu;
+        static constexpr size_t kNoRow = static_cast<size_t>(-1);
+
+        struct Row
+        {
+            uint32_t group = 0;
+            // Position in WindowGrouping::order, or kHeaderRow for the group header.
+            uint32_t item = kHeaderRow;
+        };
+
+        // Marks the rows stale when the snapshot, the grouping or a filter changed. The process filter
+        // matches each window's process name. With an active filter, only matching windows get rows and
+        // groups without any are left out (process groups stay when only the process name was filtered).
+        // `removedCount` windows are listed in the removed group while no filter is active.
+        void Sync(const InspectorSnapshot& snapshot, const WindowGrouping& grouping, const char* processFilter,
+                  const StyleFilter& styleFilter = StyleFilter{}, size_t removedCount = 0, AttributeIndex* attributes = nullptr)
+        {
+            const char* filter = processFilter != nullptr ? processFilter : "";
+            if (snapshot.generation == mGeneration && mFilter == filter && mSnapshot == &snapshot && mGrouping == &grouping &&
+                mMode == grouping.mode && mStyleFilter == styleFilter && mRemovedCount == removedCount && mAttributes == attributes)
+            {
+                return;
+            }
+
+            mAttributes = attributes;
+            mSnapshot = &snapshot;
+            mGrouping = &grouping;
+            mMode = grouping.mode;
+            mGeneration = snapshot.generation;
+            mFilter = filter;
+            mStyleFilter = styleFilter;
+            mRemovedCount = removedCount;
+            mRowsDirty = true;
+        }
+
+        const std::vector<Row>& Rows()
+        {
+            if (mRowsDirty)
+            {
+                Rebuild();
+            }
+            return mRows;
+        }
+
+        // Groups that passed the filters.
+        size_t GroupCount()
+        {
+            Rows();
+            return mGroupCount;
+        }
+
+        const WindowGrouping& Grouping() const
+        {
+            return *mGrouping;
+        }
+
+        bool IsCollapsed(uint32_t group) const
+        {
+            if (group == kRemovedGroup)
+            {
+                return mRemovedCollapsed;
+            }
+            return Collapsed().count(mGrouping->groupKeys[group]) != 0;
+        }
+
+        void SetCollapsed(uint32_t group, bool collapsed)
+        {
+            if (group == kRemovedGroup)
+            {
+                mRowsDirty = mRowsDirty || mRemovedCollapsed != collapsed;
+                mRemovedCollapsed = collapsed;
+                return;
+            }
+            auto& keys = mCollapsed[static_cast<size_t>(mMode)];
+            const uint64_t key = mGrouping->groupKeys[group];
+            if (collapsed ? keys.insert(key).second : keys.erase(key) != 0)
+            {
+                mRowsDirty = true;
+            }
+        }
+
+        // Row showing `ref`, or kNoRow when it is filtered out or its group is collapsed.
+        size_t RowOf(const WindowRef& ref)
+        {
+            Rows();
+            const uint32_t position = mGrouping->PositionOf(ref);
+            const uint32_t group = mGrouping->GroupOf(position);
+            if (mGroupRow[group] == kNoRow || IsCollapsed(group))
+            {
+                return kNoRow;
+            }
+            if (!mThinned)
+            {
+                return mGroupRow[group] + 1 + (position - mGrouping->groupOffsets[group]);
+            }
+            const Row key{group, position};
+            const auto begin = mRows.begin() + static_cast<std::ptrdiff_t>(mGroupRow[group] + 1);
+            const auto it = std::lower_bound(begin, mRows.end(), key, [](const Row& row, const Row& wanted) {
+                return row.group < wanted.group || (row.group == wanted.group && row.item < wanted.item);
+            });
+            return it != mRows.end() && it->group == group && it->item == position ? static_cast<size_t>(it - mRows.begin()) : kNoRow;
+        }
+
+        // Like RowOf, but expands the window's group first.
+        size_t RevealRow(const WindowRef& ref)
+        {
+            if (ref.process < mSnapshot->processes.size())
+            {
+                SetCollapsed(mGrouping->GroupOf(mGrouping->PositionOf(ref)), false);
+            }
+            return RowOf(ref);
+        }
+
+    private:
+        // Below one match in this many windows, matches are visited from the bitset and sorted into
+        // grouping order rather than testing every position.
+        static constexpr size_t kSparseMatches = 16;
+
+        const std::unordered_set<uint64_t>& Collapsed() const
+        {
+            return mCollapsed[static_cast<size_t>(mMode)];
+        }
+
+        void Rebuild()
+        {
+            const WindowGrouping& grouping = *mGrouping;
+            const bool byProcess = grouping.mode == GroupingMode::Process;
+            mRows.clear();
+            mGroupRow.assign(grouping.GroupCount(), kNoRow);
+            mGroupCount = 0;
+            mThinned = mStyleFilter.Active() || (!mFilter.empty() && !byProcess);
+
+            // Process name matches, once per process rather than once per window.
+            mProcessMatches.assign(mSnapshot->processes.size(), 1);
+            if (!mFilter.empty())
+            {
+                const TextSearch::FoldedNeedle filter(mFilter.data(), mFilter.size());
+                for (size_t process = 0; process < mSnapshot->processes.size(); ++process)
+                {
+                    const std::string& name = mSnapshot->processes[process].process.nameUtf8;
+                    mProcessMatches[process] = filter.Find(name.data(), name.size()) != nullptr;
+                }
+            }
+
+            if (mRemovedCount > 0 && mFilter.empty() && !mStyleFilter.Active())
+            {
+                // Ghost rows sort before every group, so RowOf's search (which starts past the window's
+                // own header) never sees them.
+                mRows.push_back(Row{kRemovedGroup, kHeaderRow});
+                for (uint32_t removed = 0; !mRemovedCollapsed && removed < mRemovedCount; ++removed)
+                {
+                    mRows.push_back(Row{kRemovedGroup, removed});
+                }
+            }
+
+            const std::vector<uint64_t>* styleMatches = nullptr;
+            if (mStyleFilter.Active() && mAttributes != nullptr && mAttributes->Synced(*mSnapshot))
+            {
+                styleMatches = &mAttributes->Evaluate(mStyleFilter);
+                if (mAttributes->CurrentStats().matches * kSparseMatches < grouping.order.size())
+                {
+                    AddSparseMatches(*styleMatches);
+                    mRowsDirty = false;
+                    return;
+                }
+            }
+
+            for (uint32_t group = 0; group < grouping.GroupCount(); ++group)
+            {
+                const uint32_t begin = grouping.groupOffsets[group];
+                const uint32_t end = grouping.groupOffsets[group + 1];
+                if (byProcess && !mProcessMatches[group])
+                {
+                    continue;
+                }
+                if (!mThinned)
+                {
+                    AddGroup(group, begin, end);
+                    continue;
+                }
+
+                // One name and one mask test per window; the group only appears if something matched.
+                mMatches.clear();
+                for (uint32_t position = begin; position < end; ++position)
+                {
+                    const WindowRef& ref = grouping.order[position];
+                    if (mProcessMatches[ref.process] && MatchesStyle(ref, styleMatches))
+                    {
+                        mMatches.push_back(position);
+                    }
+                }
+                AddMatches(group);
+            }
+            mRowsDirty = false;
+        }
+
+        bool MatchesStyle(const WindowRef& ref, const std::vector<uint64_t>* styleMatches) const
+        {
+            if (styleMatches != nullptr)
+            {
+                return AttributeIndex::Test(*styleMatches, mGrouping->windowBase[ref.process] + ref.window);
+            }
+            const WindowInfo& window = mSnapshot->processes[ref.process].windows[ref.window];
+            return mStyleFilter.Matches(window.style, window.exStyle, WindowStateBits(window.visible, window.bounds, window.rootOwner));
+        }
+
+        // Rows for the windows set in `styleMatches` whose process passes the name filter: their positions
+        // are collected in flat order, sorted, and split into groups in one walk.
+        void AddSparseMatches(const std::vector<uint64_t>& styleMatches)
+        {
+            const WindowGrouping& grouping = *mGrouping;
+            mSparse.clear();
+            uint32_t process = 0;
+            AttributeIndex::ForEachSet(styleMatches, [&](uint32_t flat) {
+                while (grouping.windowBase[process + 1] <= flat)
+                {
+                    ++process;
+                }
+                if (mProcessMatches[process])
+                {
+                    mSparse.push_back(grouping.positions[flat]);
+                }
+            });
+            std::sort(mSparse.begin(), mSparse.end());
+
+            uint32_t group = 0;
+            mMatches.clear();
+            for (const uint32_t position : mSparse)
+            {
+                if (position >= grouping.groupOffsets[group + 1])
+                {
+                    AddMatches(group);
+                    group = GroupOfFrom(group, position);
+                }
+                mMatches.push_back(position);
+            }
+            AddMatches(group);
+        }
+
+        // Group of `position`, searching forward from `group`.
+        uint32_t GroupOfFrom(uint32_t group, uint32_t position) const
+        {
+            const auto& offsets = mGrouping->groupOffsets;
+            const auto it = std::upper_bound(offsets.begin() + group + 1, offsets.end() - 1, position);
+            return static_cast<uint32_t>(it - offsets.begin()) - 1;
+        }
+
+        // Header row plus, unless collapsed, the rows of mMatches, if there are any; clears mMatches.
+        void AddMatches(uint32_t group)
+        {
+            if (mMatches.empty())
+            {
+                return;
+            }
+            AddGroup(group, 0, 0);
+            if (!IsCollapsed(group))
+            {
+                for (const uint32_t position : mMatches)
+                {
+                    mRows.push_back(Row{group, position});
+                }
+            }
+            mMatches.clear();
+        }
+
+        // Header row plus, unless collapsed, positions [begin, end).
+        void AddGroup(uint32_t group, uint32_t begin, uint32_t end)
+        {
+            ++mGroupCount;
+            mGroupRow[group] = mRows.size();
+            mRows.push_back(Row{group, kHeaderRow});
+            if (IsCollapsed(group))
+            {
+                return;
+            }
+            for (uint32_t position = begin; position < end; ++position)
+            {
+                mRows.push_back(Row{group, position});
+            }
+        }
+
+        const InspectorSnapshot* mSnapshot = nullptr;
+        const WindowGrouping* mGrouping = nullptr;
+        GroupingMode mMode = GroupingMode::Process;
+        uint64_t mGeneration = 0;
+        std::string mFilter;
+        StyleFilter mStyleFilter;
+        AttributeIndex* mAttributes = nullptr;
+        bool mThinned = false;
+        bool mRowsDirty = true;
+        std::vector<uint8_t> mProcessMatches;
+        std::vector<uint32_t> mMatches;
+        std::vector<uint32_t> mSparse;
+        std::vector<Row> mRows;
+        std::vector<size_t> mGroupRow;
+        size_t mGroupCount = 0;
+        std::array<std::unordered_set<uint64_t>, kGroupingModeCount> mCollapsed;
+        size_t mRemovedCount = 0;
+        bool mRemovedCollapsed = true;
+    };
+}
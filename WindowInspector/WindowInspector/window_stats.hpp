@@ -0,0 +1,266 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <array>
+#include <cstdint>
+#include <chrono>
+#include <unordered_map>
+
+#include "snapshot.hpp"
+#include "spatial_index.hpp"
+#include "snapshot_diff.hpp"
+#include "ranked_counter.hpp"
+#include "window_grouping.hpp"
+
+namespace Inspector
+{
+    // Histogram bucket of a width or height: 0 for empty, then powers of two ([1, 2), [2, 4), ...), with
+    // everything from 16384 px up in the last bucket.
+    constexpr size_t kSizeBuckets = 16;
+
+    inline size_t SizeBucket(LONG extent)
+    {
+        size_t bucket = 0;
+        for (unsigned long long value = extent > 0 ? static_cast<unsigned long long>(extent) : 0; value != 0; value >>= 1)
+        {
+            ++bucket;
+        }
+        return bucket < kSizeBuckets ? bucket : kSizeBuckets - 1;
+    }
+
+    // Smallest extent that falls into `bucket`.
+    inline LONG SizeBucketFloor(size_t bucket)
+    {
+        return bucket == 0 ? 0 : static_cast<LONG>(1) << (bucket - 1);
+    }
+
+    // Aggregate counts over the current snapshot's windows: windows per process and per class (ranked),
+    // visible versus hidden, width and height histograms and windows per monitor. Each SpatialIndex slot
+    // remembers what it last contributed; a refresh only revisits the slots SnapshotDiff touched,
+    // subtracting the old contribution and adding the new one, so following 100k changed windows costs
+    // about the same as diffing them and an unchanged refresh costs nothing.
+    class WindowStats
+    {
+    public:
+        using Histogram = std::array<uint32_t, kSizeBuckets>;
+
+        struct UpdateStats
+        {
+            size_t touched = 0;
+            double milliseconds = 0.0;
+        };
+
+        // `index` and `diff` must already be updated for `snapshot`.
+        void Update(const InspectorSnapshot& snapshot, const SpatialIndex& index, const SnapshotDiff& diff)
+        {
+            if (snapshot.generation == mGeneration)
+            {
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            mGeneration = snapshot.generation;
+            if (mSlots.size() < index.SlotCount())
+            {
+                mSlots.resize(index.SlotCount());
+            }
+
+            // A new monitor layout can move every window to another monitor; recount them all from the
+            // remembered bounds first, so the touched slots below are adjusted against the new layout.
+            if (!SameRects(mMonitors, snapshot.monitors))
+            {
+                mMonitors = snapshot.monitors;
+                mMonitorCounts.assign(mMonitors.size() + 1, 0);
+                for (SlotRecord& record : mSlots)
+                {
+                    if (record.live)
+                    {
+                        record.monitor = static_cast<uint32_t>(MonitorKey(record.bounds, mMonitors));
+                        ++mMonitorCounts[record.monitor];
+                    }
+                }
+            }
+
+            const std::vector<uint32_t>& touched = diff.TouchedSlots();
+            for (const uint32_t slot : touched)
+            {
+                const SpatialIndex::Entry& entry = index.EntryAt(slot);
+                if (!entry.live)
+                {
+                    Replace(mSlots[slot], SlotRecord{}, nullptr, nullptr);
+                    continue;
+                }
+                const ProcessWindows& owner = snapshot.processes[entry.ref.process];
+                const WindowInfo& window = owner.windows[entry.ref.window];
+                SlotRecord next;
+                next.live = true;
+                next.pid = window.pid;
+                next.process = owner.process.id;
+                next.classKey = window.hashes.className;
+                next.bounds = window.bounds;
+                next.visible = window.visible;
+                next.monitor = static_cast<uint32_t>(MonitorKey(window.bounds, mMonitors));
+                Replace(mSlots[slot], next, &owner.process.nameUtf8, &window.classNameUtf8);
+            }
+
+            mLastUpdate.touched = touched.size();
+            mLastUpdate.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Windows per process ID, most first.
+        const RankedCounter<DWORD>& Processes() const
+        {
+            return mProcesses;
+        }
+
+        // Windows per class (keyed by WindowHashes::className), most first.
+        const RankedCounter<uint64_t>& Classes() const
+        {
+            return mClasses;
+        }
+
+        const std::string& ProcessName(DWORD pid) const
+        {
+            return Lookup(mProcessNames, pid);
+        }
+
+        const std::string& ClassName(uint64_t classKey) const
+        {
+            return Lookup(mClassNames, classKey);
+        }
+
+        size_t WindowCount() const
+        {
+            return mWindowCount;
+        }
+
+        size_t VisibleCount() const
+        {
+            return mVisibleCount;
+        }
+
+        const Histogram& Widths() const
+        {
+            return mWidths;
+        }
+
+        const Histogram& Heights() const
+        {
+            return mHeights;
+        }
+
+        // Monitor rectangles the counts refer to.
+        const std::vector<RECT>& Monitors() const
+        {
+            return mMonitors;
+        }
+
+        // Windows per monitor (largest overlap), plus off-screen and zero-sized windows at the end.
+        const std::vector<uint32_t>& MonitorCounts() const
+        {
+            return mMonitorCounts;
+        }
+
+        const UpdateStats& LastUpdate() const
+        {
+            return mLastUpdate;
+        }
+
+    private:
+        // What one slot's window adds to the counts.
+        struct SlotRecord
+        {
+            RECT bounds{0, 0, 0, 0};
+            uint64_t classKey = 0;
+            DWORD pid = 0;
+            // ProcessInfo::id, which tells a recycled pid apart.
+            uint32_t process = kNoIdentity;
+            uint32_t monitor = 0;
+            bool visible = false;
+            bool live = false;
+        };
+
+        template <typename Key>
+        static const std::string& Lookup(const std::unordered_map<Key, std::string>& names, Key key)
+        {
+            static const std::string empty;
+            const auto it = names.find(key);
+            return it != names.end() ? it->second : empty;
+        }
+
+        static bool SameRects(const std::vector<RECT>& a, const std::vector<RECT>& b)
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (a[i].left != b[i].left || a[i].top != b[i].top || a[i].right != b[i].right || a[i].bottom != b[i].bottom)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Moves the slot's contribution from `record` to `next`, touching only the counters whose key
+        // changed (a moved window leaves the ranked counters alone). Names are copied only when a
+        // process or class first appears, or a pid comes back as another process.
+        void Replace(SlotRecord& record, const SlotRecord& next, const std::string* processName, const std::string* className)
+        {
+            if (!record.live || !next.live || record.pid != next.pid || record.process != next.process)
+            {
+                if (record.live && mProcesses.Decrement(record.pid) == 0)
+                {
+                    mProcessNames.erase(record.pid);
+                }
+                if (next.live && (mProcesses.Increment(next.pid) == 1 || (record.live && record.process != next.process)))
+                {
+                    mProcessNames[next.pid] = *processName;
+                }
+            }
+            if (!record.live || !next.live || record.classKey != next.classKey)
+            {
+                if (record.live && mClasses.Decrement(record.classKey) == 0)
+                {
+                    mClassNames.erase(record.classKey);
+                }
+                if (next.live && mClasses.Increment(next.classKey) == 1)
+                {
+                    mClassNames[next.classKey] = *className;
+                }
+            }
+            if (record.live)
+            {
+                --mWindowCount;
+                mVisibleCount -= record.visible ? 1 : 0;
+                --mWidths[SizeBucket(record.bounds.right - record.bounds.left)];
+                --mHeights[SizeBucket(record.bounds.bottom - record.bounds.top)];
+                --mMonitorCounts[record.monitor];
+            }
+            record = next;
+            if (record.live)
+            {
+                ++mWindowCount;
+                mVisibleCount += record.visible ? 1 : 0;
+                ++mWidths[SizeBucket(record.bounds.right - record.bounds.left)];
+                ++mHeights[SizeBucket(record.bounds.bottom - record.bounds.top)];
+                ++mMonitorCounts[record.monitor];
+            }
+        }
+
+        uint64_t mGeneration = 0;
+        std::vector<SlotRecord> mSlots;
+        RankedCounter<DWORD> mProcesses;
+        RankedCounter<uint64_t> mClasses;
+        std::unordered_map<DWORD, std::string> mProcessNames;
+        std::unordered_map<uint64_t, std::string> mClassNames;
+        size_t mWindowCount = 0;
+        size_t mVisibleCount = 0;
+        Histogram mWidths{};
+        Histogram mHeights{};
+        std::vector<RECT> mMonitors;
+        std::vector<uint32_t> mMonitorCounts = std::vector<uint32_t>(1, 0);
+        UpdateStats mLastUpdate;
+    };
+}
@@ -0,0 +1,472 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+#include "platform.hpp"
+
+namespace Inspector
+{
+    struct StyleFlag
+    {
+        uint32_t mask;
+        const char* name;
+    };
+
+    // WS_* bits. Composite masks come first so they claim their bits before the parts do; WS_GROUP and
+    // WS_TABSTOP share values with the min/max boxes and only mean that on child windows.
+    inline constexpr StyleFlag kWindowStyleFlags[] = {
+        {0x80000000u, "WS_POPUP"},
+        {0x40000000u, "WS_CHILD"},
+        {0x20000000u, "WS_MINIMIZE"},
+        {0x10000000u, "WS_VISIBLE"},
+        {0x08000000u, "WS_DISABLED"},
+        {0x04000000u, "WS_CLIPSIBLINGS"},
+        {0x02000000u, "WS_CLIPCHILDREN"},
+        {0x01000000u, "WS_MAXIMIZE"},
+        {0x00C00000u, "WS_CAPTION"},
+        {0x00800000u, "WS_BORDER"},
+        {0x00400000u, "WS_DLGFRAME"},
+        {0x00200000u, "WS_VSCROLL"},
+        {0x00100000u, "WS_HSCROLL"},
+        {0x00080000u, "WS_SYSMENU"},
+        {0x00040000u, "WS_THICKFRAME"},
+        {0x00020000u, "WS_MINIMIZEBOX"},
+        {0x00010000u, "WS_MAXIMIZEBOX"},
+    };
+
+    inline constexpr StyleFlag kChildWindowStyleFlags[] = {
+        {0x00020000u, "WS_GROUP"},
+        {0x00010000u, "WS_TABSTOP"},
+    };
+
+    inline constexpr StyleFlag kExtendedStyleFlags[] = {
+        {0x00000001u, "WS_EX_DLGMODALFRAME"},
+        {0x00000004u, "WS_EX_NOPARENTNOTIFY"},
+        {0x00000008u, "WS_EX_TOPMOST"},
+        {0x00000010u, "WS_EX_ACCEPTFILES"},
+        {0x00000020u, "WS_EX_TRANSPARENT"},
+        {0x00000040u, "WS_EX_MDICHILD"},
+        {0x00000080u, "WS_EX_TOOLWINDOW"},
+        {0x00000100u, "WS_EX_WINDOWEDGE"},
+        {0x00000200u, "WS_EX_CLIENTEDGE"},
+        {0x00000400u, "WS_EX_CONTEXTHELP"},
+        {0x00001000u, "WS_EX_RIGHT"},
+        {0x00002000u, "WS_EX_RTLREADING"},
+        {0x00004000u, "WS_EX_LEFTSCROLLBAR"},
+        {0x00010000u, "WS_EX_CONTROLPARENT"},
+        {0x00020000u, "WS_EX_STATICEDGE"},
+        {0x00040000u, "WS_EX_APPWINDOW"},
+        {0x00080000u, "WS_EX_LAYERED"},
+        {0x00100000u, "WS_EX_NOINHERITLAYOUT"},
+        {0x00200000u, "WS_EX_NOREDIRECTIONBITMAP"},
+        {0x00400000u, "WS_EX_LAYOUTRTL"},
+        {0x02000000u, "WS_EX_COMPOSITED"},
+        {0x08000000u, "WS_EX_NOACTIVATE"},
+    };
+
+    // Attributes a window has in a snapshot rather than in its style words: IsWindowVisible (which also
+    // looks at the parents), empty bounds and an owner. Style filters accept them like flags.
+    inline constexpr StyleFlag kWindowStateFlags[] = {
+        {0x00000001u, "SHOWN"},
+        {0x00000002u, "ZEROSIZE"},
+        {0x00000004u, "OWNED"},
+    };
+
+    inline uint32_t WindowStateBits(bool visible, const RECT& bounds, HWND rootOwner)
+    {
+        return (visible ? 0x1u : 0u) | (bounds.right <= bounds.left || bounds.bottom <= bounds.top ? 0x2u : 0u) | (rootOwner != nullptr ? 0x4u : 0u);
+    }
+
+    inline constexpr StyleFlag kClassStyleFlags[] = {
+        {0x00000001u, "CS_VREDRAW"},
+        {0x00000002u, "CS_HREDRAW"},
+        {0x00000008u, "CS_DBLCLKS"},
+        {0x00000020u, "CS_OWNDC"},
+        {0x00000040u, "CS_CLASSDC"},
+        {0x00000080u, "CS_PARENTDC"},
+        {0x00000200u, "CS_NOCLOSE"},
+        {0x00000800u, "CS_SAVEBITS"},
+        {0x00001000u, "CS_BYTEALIGNCLIENT"},
+        {0x00002000u, "CS_BYTEALIGNWINDOW"},
+        {0x00004000u, "CS_GLOBALCLASS"},
+        {0x00020000u, "CS_DROPSHADOW"},
+    };
+
+    // Flag name without its WS_/WS_EX_/CS_ prefix, for the compact table column.
+    inline const char* ShortStyleName(const char* name)
+    {
+        if (std::strncmp(name, "WS_EX_", 6) == 0)
+        {
+            return name + 6;
+        }
+        if (std::strncmp(name, "WS_", 3) == 0 || std::strncmp(name, "CS_", 3) == 0)
+        {
+            return name + 3;
+        }
+        return name;
+    }
+
+    // Appends the names of the bits of `value` covered by `flags`, separated by " | " (or by a single
+    // space and without prefixes when `compact`); returns the bits left over.
+    template <size_t Count>
+    uint32_t AppendStyleNames(uint32_t value, const StyleFlag (&flags)[Count], std::string& out, bool compact = false)
+    {
+        for (const StyleFlag& flag : flags)
+        {
+            if ((value & flag.mask) == flag.mask)
+            {
+                if (!out.empty())
+                {
+                    out += compact ? " " : " | ";
+                }
+                out += compact ? ShortStyleName(flag.name) : flag.name;
+                value &= ~flag.mask;
+            }
+        }
+        return value;
+    }
+
+    inline void AppendUnknownBits(uint32_t value, std::string& out, bool compact = false)
+    {
+        if (value == 0)
+        {
+            return;
+        }
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "0x%08X", static_cast<unsigned>(value));
+        if (!out.empty())
+        {
+            out += compact ? " " : " | ";
+        }
+        out += buffer;
+    }
+
+    inline std::string DescribeWindowStyle(uint32_t style, bool compact = false)
+    {
+        std::string out;
+        uint32_t rest = style;
+        if ((style & 0x40000000u) != 0)
+        {
+            rest = AppendStyleNames(rest & ~0x00030000u, kWindowStyleFlags, out, compact) | (rest & 0x00030000u);
+            rest = AppendStyleNames(rest, kChildWindowStyleFlags, out, compact);
+        }
+        else
+        {
+            rest = AppendStyleNames(rest, kWindowStyleFlags, out, compact);
+        }
+        AppendUnknownBits(rest, out, compact);
+        return out.empty() ? std::string(compact ? "OVERLAPPED" : "WS_OVERLAPPED") : out;
+    }
+
+    inline std::string DescribeExtendedStyle(uint32_t exStyle, bool compact = false)
+    {
+        std::string out;
+        AppendUnknownBits(AppendStyleNames(exStyle, kExtendedStyleFlags, out, compact), out, compact);
+        return out.empty() ? std::string(compact ? "-" : "(none)") : out;
+    }
+
+    inline std::string DescribeClassStyle(uint32_t classStyle)
+    {
+        std::string out;
+        AppendUnknownBits(AppendStyleNames(classStyle, kClassStyleFlags, out), out);
+        return out.empty() ? std::string("(none)") : out;
+    }
+
+    struct StyleNames
+    {
+        std::string style;
+        std::string exStyle;
+        std::string styleCompact;
+        std::string exStyleCompact;
+    };
+
+    // Decoded names per distinct (style, exStyle) pair. A desktop has tens of thousands of windows but only a
+    // few hundred distinct pairs, so each is decoded once and then found with one probe of a small
+    // open-addressed table keyed by the packed 64-bit pair.
+    class StyleNameCache
+    {
+    public:
+        static constexpr size_t kMaxEntries = 4096;
+
+        // The reference stays valid until the next call.
+        const StyleNames& Get(LONG_PTR style, LONG_PTR exStyle)
+        {
+            const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(style)) << 32) | static_cast<uint32_t>(exStyle);
+            if (mSlots.empty())
+            {
+                mSlots.assign(64, kEmpty);
+            }
+
+            size_t slot = Hash(key) & (mSlots.size() - 1);
+            while (mSlots[slot] != kEmpty)
+            {
+                if (mKeys[mSlots[slot]] == key)
+                {
+                    return mNames[mSlots[slot]];
+                }
+                slot = (slot + 1) & (mSlots.size() - 1);
+            }
+
+            if (mNames.size() >= kMaxEntries)
+            {
+                // Pathological churn; start over rather than grow without bound.
+                Clear();
+                return Get(style, exStyle);
+            }
+            if ((mNames.size() + 1) * 2 > mSlots.size())
+            {
+                Grow();
+                return Get(style, exStyle);
+            }
+
+            const auto index = static_cast<uint32_t>(mNames.size());
+            StyleNames names;
+            names.style = DescribeWindowStyle(static_cast<uint32_t>(style));
+            names.exStyle = DescribeExtendedStyle(static_cast<uint32_t>(exStyle));
+            names.styleCompact = DescribeWindowStyle(static_cast<uint32_t>(style), true);
+            names.exStyleCompact = DescribeExtendedStyle(static_cast<uint32_t>(exStyle), true);
+            mNames.push_back(std::move(names));
+            mKeys.push_back(key);
+            mSlots[slot] = index;
+            return mNames.back();
+        }
+
+        size_t Size() const
+        {
+            return mNames.size();
+        }
+
+        void Clear()
+        {
+            mNames.clear();
+            mKeys.clear();
+            mSlots.assign(64, kEmpty);
+        }
+
+    private:
+        static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+        static size_t Hash(uint64_t key)
+        {
+            key ^= key >> 33;
+            key *= 0xFF51AFD7ED558CCDull;
+            key ^= key >> 33;
+            return static_cast<size_t>(key);
+        }
+
+        void Grow()
+        {
+            mSlots.assign(mSlots.size() * 2, kEmpty);
+            for (uint32_t index = 0; index < mKeys.size(); ++index)
+            {
+                size_t slot = Hash(mKeys[index]) & (mSlots.size() - 1);
+                while (mSlots[slot] != kEmpty)
+                {
+                    slot = (slot + 1) & (mSlots.size() - 1);
+                }
+                mSlots[slot] = index;
+            }
+        }
+
+        std::vector<StyleNames> mNames;
+        std::vector<uint64_t> mKeys;
+        std::vector<uint32_t> mSlots;
+    };
+
+    // Bits of a window's style, extended style and WindowStateBits.
+    struct StyleMasks
+    {
+        uint32_t style = 0;
+        uint32_t exStyle = 0;
+        uint32_t state = 0;
+
+        bool Empty() const
+        {
+            return (style | exStyle | state) == 0;
+        }
+
+        bool operator==(const StyleMasks& other) const
+        {
+            return style == other.style && exStyle == other.exStyle && state == other.state;
+        }
+    };
+
+    // "WS_VISIBLE !WS_EX_TOOLWINDOW caption" style filters, compiled once into required/forbidden masks so
+    // matching a window is a few AND-and-compare tests. Names are case-insensitive, the WS_/WS_EX_ prefix is
+    // optional, and a leading '!' or '-' negates a flag. Tokens may be separated by spaces, commas or '|'.
+    // "topmost/toolwindow" requires either flag; negated, "!topmost/toolwindow" forbids both. The state
+    // flags (SHOWN, ZEROSIZE, OWNED) filter like style flags.
+    class StyleFilter
+    {
+    public:
+        // False (and the filter left inactive) when a token names no known flag.
+        bool Compile(const char* text)
+        {
+            *this = StyleFilter{};
+            const char* cursor = text != nullptr ? text : "";
+            while (*cursor != '\0')
+            {
+                while (*cursor == ' ' || *cursor == ',' || *cursor == '|')
+                {
+                    ++cursor;
+                }
+                if (*cursor == '\0')
+                {
+                    break;
+                }
+                const bool negate = *cursor == '!' || *cursor == '-';
+                cursor += negate ? 1 : 0;
+                const char* begin = cursor;
+                while (*cursor != '\0' && *cursor != ' ' && *cursor != ',' && *cursor != '|')
+                {
+                    ++cursor;
+                }
+
+                std::vector<StyleMasks> alternatives;
+                for (const char* name = begin; name <= cursor; ++name)
+                {
+                    const char* end = name;
+                    while (end < cursor && *end != '/')
+                    {
+                        ++end;
+                    }
+                    StyleMasks masks;
+                    if (!Lookup(name, static_cast<size_t>(end - name), masks))
+                    {
+                        *this = StyleFilter{};
+                        // An empty alternative ("topmost/") reports the whole token.
+                        mError.assign(end != name ? name : begin, end != name ? end : cursor);
+                        return false;
+                    }
+                    alternatives.push_back(masks);
+                    name = end;
+                }
+
+                if (negate || alternatives.size() == 1)
+                {
+                    StyleMasks& masks = negate ? mForbidden : mRequired;
+                    for (const StyleMasks& alternative : alternatives)
+                    {
+                        masks.style |= alternative.style;
+                        masks.exStyle |= alternative.exStyle;
+                        masks.state |= alternative.state;
+                    }
+                }
+                else
+                {
+                    mAnyOf.push_back(std::move(alternatives));
+                }
+            }
+            mActive = !mRequired.Empty() || !mForbidden.Empty() || !mAnyOf.empty();
+            return true;
+        }
+
+        bool Active() const
+        {
+            return mActive;
+        }
+
+        // `state` is the window's WindowStateBits.
+        bool Matches(LONG_PTR style, LONG_PTR exStyle, uint32_t state) const
+        {
+            const StyleMasks window{static_cast<uint32_t>(style), static_cast<uint32_t>(exStyle), state};
+            if (!HasAll(window, mRequired) || (window.style & mForbidden.style) != 0 || (window.exStyle & mForbidden.exStyle) != 0 ||
+                (window.state & mForbidden.state) != 0)
+            {
+                return false;
+            }
+            for (const auto& alternatives : mAnyOf)
+            {
+                if (std::none_of(alternatives.begin(), alternatives.end(), [&window](const StyleMasks& masks) { return HasAll(window, masks); }))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Bits every match has.
+        const StyleMasks& Required() const
+        {
+            return mRequired;
+        }
+
+        // Bits no match has.
+        const StyleMasks& Forbidden() const
+        {
+            return mForbidden;
+        }
+
+        // Clauses of '/' alternatives; a match has all the bits of at least one alternative per clause.
+        const std::vector<std::vector<StyleMasks>>& AnyOf() const
+        {
+            return mAnyOf;
+        }
+
+        // Offending token after a failed Compile.
+        const std::string& Error() const
+        {
+            return mError;
+        }
+
+        bool operator==(const StyleFilter& other) const
+        {
+            return mRequired == other.mRequired && mForbidden == other.mForbidden && mAnyOf == other.mAnyOf;
+        }
+
+        bool operator!=(const StyleFilter& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        static bool HasAll(const StyleMasks& window, const StyleMasks& masks)
+        {
+            return (window.style & masks.style) == masks.style && (window.exStyle & masks.exStyle) == masks.exStyle &&
+                   (window.state & masks.state) == masks.state;
+        }
+
+        static bool NameEquals(const char* name, const char* token, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (name[i] == '\0' || std::toupper(static_cast<unsigned char>(token[i])) != name[i])
+                {
+                    return false;
+                }
+            }
+            return name[length] == '\0';
+        }
+
+        template <size_t Count>
+        static bool Find(const StyleFlag (&flags)[Count], const char* token, size_t length, uint32_t& mask)
+        {
+            for (const StyleFlag& flag : flags)
+            {
+                if (NameEquals(flag.name, token, length) || NameEquals(ShortStyleName(flag.name), token, length))
+                {
+                    mask = flag.mask;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static bool Lookup(const char* token, size_t length, StyleMasks& masks)
+        {
+            return length != 0 && (Find(kWindowStyleFlags, token, length, masks.style) || Find(kChildWindowStyleFlags, token, length, masks.style) ||
+                                   Find(kExtendedStyleFlags, token, length, masks.exStyle) || Find(kWindowStateFlags, token, length, masks.state));
+        }
+
+        StyleMasks mRequired;
+        StyleMasks mForbidden;
+        std::vector<std::vector<StyleMasks>> mAnyOf;
+        bool mActive = false;
+        std::string mError;
+    };
+}
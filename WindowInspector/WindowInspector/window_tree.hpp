@@ -0,0 +1,295 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <deque>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "snapshot.hpp"
+#include "text_search.hpp"
+
+namespace Inspector
+{
+    // Where child windows come from. main.cpp walks GW_CHILD/GW_HWNDNEXT; the benchmark plugs in a
+    // synthetic hierarchy. Both calls are only made for nodes the user has actually reached.
+    struct ChildWindowSource
+    {
+        // Appends the direct children of `parent` in Z order, strings already prepared.
+        std::function<void(HWND parent, std::vector<WindowInfo>& children)> enumerateChildren;
+        // Cheap probe used to decide whether a row gets an expand arrow.
+        std::function<bool(HWND window)> hasChildren;
+    };
+
+    // Lazily expanded window hierarchy rooted at the snapshot's top-level windows. Children are
+    // enumerated the first time a node is expanded and cached until the snapshot generation changes, so
+    // editing the process filter only reselects the roots; expansion state is remembered per HWND so it
+    // survives a Refresh, and forgotten once the top-level window it sits under is gone. The tree is
+    // drawn from a flat list of the currently visible nodes, so the renderer can clip it like any other list.
+    class WindowTree
+    {
+    public:
+        static constexpr uint32_t kNoNode = 0xFFFFFFFFu;
+
+        enum class ChildState : uint8_t
+        {
+            Unknown,
+            None,
+            Unloaded,
+            Loaded
+        };
+
+        struct Node
+        {
+            const WindowInfo* info = nullptr;
+            uint32_t parent = kNoNode;
+            uint32_t depth = 0;
+            uint32_t firstChild = 0;
+            uint32_t childCount = 0;
+            ChildState children = ChildState::Unknown;
+            bool expanded = false;
+        };
+
+        void SetSource(ChildWindowSource source)
+        {
+            mSource = std::move(source);
+            mGeneration = 0;
+        }
+
+        bool HasSource() const
+        {
+            return static_cast<bool>(mSource.enumerateChildren);
+        }
+
+        // Reselects the roots when the snapshot or the process filter changed. Cached children are
+        // dropped on a new generation, together with the expansion state of windows that are gone; a
+        // filter change keeps every node already loaded, so clearing it again reloads nothing.
+        void Sync(const InspectorSnapshot& snapshot, const char* processFilter)
+        {
+            const char* filter = processFilter != nullptr ? processFilter : "";
+            if (snapshot.generation == mGeneration && mFilter == filter)
+            {
+                return;
+            }
+
+            if (snapshot.generation != mGeneration)
+            {
+                mGeneration = snapshot.generation;
+                mNodes.clear();
+                mChildInfos.clear();
+                mRootByHandle.clear();
+                PruneExpanded(snapshot);
+            }
+            mFilter = filter;
+            mRoots.clear();
+            const TextSearch::FoldedNeedle needle(mFilter.data(), mFilter.size());
+            for (const auto& entry : snapshot.processes)
+            {
+                if (needle.Find(entry.process.nameUtf8.data(), entry.process.nameUtf8.size()) == nullptr)
+                {
+                    continue;
+                }
+                for (const auto& window : entry.windows)
+                {
+                    const auto [it, inserted] = mRootByHandle.try_emplace(window.handle, static_cast<uint32_t>(mNodes.size()));
+                    if (inserted)
+                    {
+                        Node node;
+                        node.info = &window;
+                        node.expanded = mExpanded.count(window.handle) != 0;
+                        mNodes.push_back(node);
+                    }
+                    mRoots.push_back(it->second);
+                }
+            }
+            mVisibleDirty = true;
+        }
+
+        // Flat, depth-first list of every node whose ancestors are all expanded.
+        const std::vector<uint32_t>& VisibleRows()
+        {
+            if (mVisibleDirty)
+            {
+                Flatten();
+            }
+            return mVisible;
+        }
+
+        const Node& NodeAt(uint32_t index) const
+        {
+            return mNodes[index];
+        }
+
+        size_t NodeCount() const
+        {
+            return mNodes.size();
+        }
+
+        size_t RootCount() const
+        {
+            return mRoots.size();
+        }
+
+        // Windows remembered as expanded, whether or not they are loaded right now.
+        size_t ExpandedCount() const
+        {
+            return mExpanded.size();
+        }
+
+        bool IsExpanded(uint32_t index) const
+        {
+            return mNodes[index].expanded;
+        }
+
+        // Resolves ChildState::Unknown for a row that is about to be drawn.
+        void ProbeChildren(uint32_t index)
+        {
+            Node& node = mNodes[index];
+            if (node.children != ChildState::Unknown)
+            {
+                return;
+            }
+            node.children = (mSource.hasChildren && !mSource.hasChildren(node.info->handle)) ? ChildState::None : ChildState::Unloaded;
+        }
+
+        void SetExpanded(uint32_t index, bool expanded, bool recursive = false)
+        {
+            const HWND handle = mNodes[index].info->handle;
+            mNodes[index].expanded = expanded;
+            if (expanded)
+            {
+                uint32_t root = index;
+                while (mNodes[root].parent != kNoNode)
+                {
+                    root = mNodes[root].parent;
+                }
+                mExpanded.emplace(handle, mNodes[root].info->handle);
+            }
+            else
+            {
+                mExpanded.erase(handle);
+            }
+            mVisibleDirty = true;
+
+            if (!recursive)
+            {
+                return;
+            }
+            if (expanded)
+            {
+                LoadChildren(index);
+            }
+            const Node node = mNodes[index];
+            if (node.children != ChildState::Loaded)
+            {
+                return;
+            }
+            for (uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+            {
+                SetExpanded(child, expanded, true);
+            }
+        }
+
+    private:
+        // Child windows cannot be checked without enumerating them again, so they are kept for as long
+        // as the top-level window they were expanded under.
+        void PruneExpanded(const InspectorSnapshot& snapshot)
+        {
+            if (mExpanded.empty())
+            {
+                return;
+            }
+            mLiveRoots.clear();
+            for (const auto& entry : snapshot.processes)
+            {
+                for (const auto& window : entry.windows)
+                {
+                    mLiveRoots.insert(window.handle);
+                }
+            }
+            for (auto it = mExpanded.begin(); it != mExpanded.end();)
+            {
+                it = mLiveRoots.count(it->second) == 0 ? mExpanded.erase(it) : std::next(it);
+            }
+        }
+
+        void LoadChildren(uint32_t index)
+        {
+            if (mNodes[index].children == ChildState::Loaded || mNodes[index].children == ChildState::None)
+            {
+                return;
+            }
+
+            mScratch.clear();
+            if (mSource.enumerateChildren)
+            {
+                mSource.enumerateChildren(mNodes[index].info->handle, mScratch);
+            }
+
+            // Children are appended as one contiguous run, so a parent only stores an offset and a count.
+            const uint32_t depth = mNodes[index].depth + 1;
+            Node& parent = mNodes[index];
+            parent.firstChild = static_cast<uint32_t>(mNodes.size());
+            parent.childCount = static_cast<uint32_t>(mScratch.size());
+            parent.children = mScratch.empty() ? ChildState::None : ChildState::Loaded;
+            for (auto& info : mScratch)
+            {
+                mChildInfos.push_back(std::move(info));
+                Node node;
+                node.info = &mChildInfos.back();
+                node.parent = index;
+                node.depth = depth;
+                node.expanded = !mExpanded.empty() && mExpanded.count(node.info->handle) != 0;
+                mNodes.push_back(node);
+            }
+        }
+
+        void Flatten()
+        {
+            mVisible.clear();
+            mStack.assign(mRoots.rbegin(), mRoots.rend());
+            while (!mStack.empty())
+            {
+                const uint32_t index = mStack.back();
+                mStack.pop_back();
+                mVisible.push_back(index);
+                if (!IsExpanded(index))
+                {
+                    continue;
+                }
+
+                LoadChildren(index);
+                const Node& node = mNodes[index];
+                if (node.children != ChildState::Loaded)
+                {
+                    continue;
+                }
+                for (uint32_t child = node.firstChild + node.childCount; child > node.firstChild; --child)
+                {
+                    mStack.push_back(child - 1);
+                }
+            }
+            mVisibleDirty = false;
+        }
+
+        ChildWindowSource mSource;
+        uint64_t mGeneration = 0;
+        std::string mFilter;
+        std::vector<Node> mNodes;
+        std::deque<WindowInfo> mChildInfos;
+        std::vector<uint32_t> mRoots;
+        std::vector<uint32_t> mVisible;
+        std::vector<uint32_t> mStack;
+        std::vector<WindowInfo> mScratch;
+        // Loaded top-level windows by handle; a root keeps its node, and its children, across filter changes.
+        std::unordered_map<HWND, uint32_t> mRootByHandle;
+        // Source of truth across generations, mapping each expanded window to the top-level window it
+        // was expanded under; Node::expanded mirrors it so Flatten never hashes.
+        std::unordered_map<HWND, HWND> mExpanded;
+        std::unordered_set<HWND> mLiveRoots;
+        bool mVisibleDirty = true;
+    };
+}